@@ -0,0 +1,192 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   alias_sampler.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase AliasSampler, que muestrea estados de
+ *         una distribución con tablas de alias (Walker/Vose) en tiempo O(1).
+ */
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#include "alias_sampler.h"
+#include "../parallel_executor/parallel_executor.h"
+
+/**
+ * @brief Constructor de la tabla de alias de la distribución conjunta
+ * @param[in] distribucion: Distribución conjunta densa
+ * @param[in] numero_hilos: Número de hilos con que se lee la tabla
+ * @throws std::invalid_argument si la distribución no tiene masa
+ * @throws std::length_error si la distribución tiene más de 2^32 estados
+ */
+AliasSampler::AliasSampler(const BinaryDistribution& distribucion,
+                           int numero_hilos)
+    : AliasSampler(distribucion, 0, 0, numero_hilos) {}
+
+/**
+ * @brief Constructor de la tabla de alias de la rebanada de la distribución
+ *        consistente con una evidencia: las muestras siguen P(X | X_C = c)
+ * @param[in] distribucion: Distribución conjunta densa
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] numero_hilos: Número de hilos con que se lee la rebanada
+ * @throws std::invalid_argument si la evidencia tiene bits fuera de maskC,
+ *         condiciona variables que no existen o tiene probabilidad nula
+ * @throws std::length_error si la rebanada tiene más de 2^32 estados
+ */
+AliasSampler::AliasSampler(const BinaryDistribution& distribucion,
+                           uint64_t maskC, uint64_t valC, int numero_hilos)
+    : numero_variables_(distribucion.getNumberVariables()),
+      version_(distribucion.getVersion()), masa_total_(0.0),
+      distribucion_(&distribucion) {
+  uint64_t mascara_todas = distribucion.getStateSpaceSize() - 1;
+  if ((valC & ~maskC) != 0) {
+    throw std::invalid_argument(
+        "Error: Los valores condicionados deben estar dentro de maskC");
+  }
+  if ((maskC & ~mascara_todas) != 0) {
+    throw std::invalid_argument(
+        "Error: La consulta no corresponde a la distribución");
+  }
+  uint64_t libres = mascara_todas & ~distribucion.toPhysicalState(maskC);
+  int numero_libres = std::popcount(libres);
+  if (numero_libres > 32) {
+    throw std::length_error(
+        "Error: La tabla de alias admite como máximo 2^32 estados");
+  }
+  valC_fisico_ = distribucion.toPhysicalState(valC);
+  if (libres != mascara_todas) {
+    libres_.emplace(libres);
+  }
+
+  // Los pesos de la rebanada se leen por tramos en paralelo
+  std::vector<double> pesos(1ULL << numero_libres);
+  uint64_t tramos = std::max<uint64_t>(1, pesos.size() >> 16);
+  distribucion.visitProbabilities([&](const auto* probabilidades) {
+    ParallelExecutor::run(tramos, numero_hilos, [&](uint64_t tramo) {
+      uint64_t inicio = tramo * pesos.size() / tramos;
+      uint64_t fin = (tramo + 1) * pesos.size() / tramos;
+      for (uint64_t k = inicio; k < fin; ++k) {
+        uint64_t estado = libres_ ? valC_fisico_ | libres_->deposit(k) : k;
+        pesos[k] = static_cast<double>(probabilidades[estado]);
+      }
+    });
+  });
+  buildTable(std::move(pesos));
+}
+
+/**
+ * @brief Constructor de la tabla de alias de una distribución dispersa
+ *        (solo sus estados no nulos)
+ * @param[in] distribucion: Distribución conjunta dispersa
+ * @throws std::invalid_argument si la distribución no tiene masa
+ * @throws std::length_error si tiene más de 2^32 estados no nulos
+ */
+AliasSampler::AliasSampler(const SparseDistribution& distribucion)
+    : numero_variables_(distribucion.getNumberVariables()),
+      version_(distribucion.getVersion()), masa_total_(0.0),
+      estados_(distribucion.getIndices()), valC_fisico_(0),
+      distribucion_(nullptr) {
+  if (estados_.size() > kMaximoEstados) {
+    throw std::length_error(
+        "Error: La tabla de alias admite como máximo 2^32 estados");
+  }
+  buildTable(distribucion.getValues());
+}
+
+/**
+ * @brief Método para escribir muestras independientes en un búfer. Cada
+ *        bloque de kMuestrasPorBloque muestras usa el flujo aleatorio de su
+ *        índice, por lo que el contenido depende solo de la semilla.
+ * @param[out] salida: Búfer de estados lógicos muestreados (una muestra por
+ *                     posición)
+ * @param[in] semilla: Semilla de los flujos aleatorios
+ * @param[in] numero_hilos: Número de hilos
+ */
+void AliasSampler::sample(std::span<uint64_t> salida, uint64_t semilla,
+                          int numero_hilos) const {
+  uint64_t bloques =
+      (salida.size() + kMuestrasPorBloque - 1) / kMuestrasPorBloque;
+  ParallelExecutor::run(bloques, numero_hilos, [&](uint64_t bloque) {
+    CounterRng aleatorio(semilla, bloque);
+    uint64_t inicio = bloque * kMuestrasPorBloque;
+    uint64_t fin = std::min<uint64_t>(inicio + kMuestrasPorBloque,
+                                      salida.size());
+    for (uint64_t i = inicio; i < fin; ++i) {
+      salida[i] = draw(aleatorio);
+    }
+  });
+}
+
+/**
+ * @brief Método para construir la tabla de umbrales y alias (método de
+ *        Vose). Las posiciones con peso escalado menor que 1 se completan con
+ *        masa de una posición con peso mayor que 1, que pasa a ser su alias.
+ * @param[in] pesos: Peso no negativo de cada posición
+ * @throws std::invalid_argument si los pesos no tienen masa
+ */
+void AliasSampler::buildTable(std::vector<double> pesos) {
+  for (double peso : pesos) {
+    masa_total_ += peso;
+  }
+  if (!(masa_total_ > 0.0)) {
+    throw std::invalid_argument(
+        "Error: No hay masa de probabilidad que muestrear");
+  }
+
+  // Las posiciones pequeñas se apilan desde el principio de la lista y las
+  // grandes desde el final, de modo que basta una sola reserva
+  uint64_t n = pesos.size();
+  double escala = static_cast<double>(n) / masa_total_;
+  std::vector<uint32_t> lista(n);
+  uint64_t pequenas = 0;
+  uint64_t grandes = n;
+  for (uint64_t k = 0; k < n; ++k) {
+    pesos[k] *= escala;
+    if (pesos[k] < 1.0) {
+      lista[pequenas++] = k;
+    } else {
+      lista[--grandes] = k;
+    }
+  }
+
+  tabla_.resize(n);
+  for (uint64_t k = 0; k < n; ++k) {
+    tabla_[k] = {1.0, static_cast<uint32_t>(k)};
+  }
+  // lista[0, pequenas) son pequeñas y lista[grandes, n) grandes; una grande
+  // que baja de 1 se mueve al hueco que deja la pequeña consumida
+  while (pequenas > 0 && grandes < n) {
+    uint32_t pequena = lista[--pequenas];
+    uint32_t grande = lista[grandes];
+    tabla_[pequena] = {pesos[pequena], grande};
+    pesos[grande] -= 1.0 - pesos[pequena];
+    if (pesos[grande] < 1.0) {
+      ++grandes;
+      lista[pequenas++] = grande;
+    }
+  }
+  // Lo que queda en cualquiera de las dos listas vale 1 salvo redondeo
+}
+
+/**
+ * @brief Método para traducir una posición de la tabla a un estado lógico
+ * @param[in] posicion: Posición de la tabla
+ * @return Estado lógico completo
+ */
+uint64_t AliasSampler::toState(uint64_t posicion) const {
+  if (!estados_.empty()) {
+    return estados_[posicion];
+  }
+  uint64_t fisico = libres_ ? valC_fisico_ | libres_->deposit(posicion)
+                            : posicion;
+  return distribucion_->toLogicalState(fisico);
+}
@@ -0,0 +1,111 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   alias_sampler.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase AliasSampler, que muestrea estados de una
+ *         distribución con tablas de alias (Walker/Vose) en tiempo O(1).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "../bit_extractor/bit_extractor.h"
+#include "../counter_rng/counter_rng.h"
+#include "../distribution/binary_distribution/binary_distribution.h"
+#include "../distribution/sparse_distribution/sparse_distribution.h"
+
+/**
+ * @brief Clase que precalcula la tabla de alias de una distribución (o de su
+ *        rebanada consistente con una evidencia X_C = c) con el método de
+ *        Vose: cada posición k guarda un umbral y un alias, y una muestra
+ *        elige k uniforme y devuelve k o su alias según una segunda variable
+ *        uniforme. La construcción es O(estados) y cada muestra es O(1).
+ *
+ *        Las muestras son estados lógicos completos (bit i = variable
+ *        X_{i+1}). La tabla es una instantánea: si la distribución cambia
+ *        (ver getVersion) hay que construirla de nuevo. Una tabla densa
+ *        traduce las muestras al orden lógico con la propia distribución,
+ *        que debe seguir existiendo mientras se use.
+ */
+class AliasSampler {
+ public:
+  /**
+   * @brief Posición de la tabla: umbral y alias juntos, de modo que cada
+   *        muestra lee una sola línea de caché
+   */
+  struct AliasEntry {
+    /// umbral: Probabilidad de quedarse con la posición en lugar del alias
+    double umbral;
+    uint32_t alias;
+  };
+
+  //-------------------------CONSTRUCTOR-------------------------
+  explicit AliasSampler(const BinaryDistribution&, int = 1);
+  AliasSampler(const BinaryDistribution&, uint64_t, uint64_t, int = 1);
+  explicit AliasSampler(const SparseDistribution&);
+
+  //-------------------------MÉTODOS-------------------------
+  int getNumberVariables() const { return numero_variables_; }
+  /// Versión de la distribución a partir de la que se construyó la tabla
+  uint64_t getVersion() const { return version_; }
+  /// Número de posiciones de la tabla (estados muestreables)
+  uint64_t getSize() const { return tabla_.size(); }
+  /// Masa total de los estados muestreables (P(X_C = c) en una rebanada de
+  /// una distribución normalizada)
+  double getTotalMass() const { return masa_total_; }
+
+  /**
+   * @brief Método para obtener una muestra
+   * @param[in,out] aleatorio: Flujo aleatorio del que se toman dos valores
+   * @return Estado lógico muestreado
+   */
+  uint64_t draw(CounterRng& aleatorio) const {
+    uint64_t posicion = static_cast<uint64_t>(
+        (static_cast<unsigned __int128>(aleatorio.next()) * tabla_.size()) >>
+        64);
+    const AliasEntry& entrada = tabla_[posicion];
+    return toState(aleatorio.nextDouble() < entrada.umbral ? posicion
+                                                            : entrada.alias);
+  }
+  /// Método para escribir n muestras en un búfer, repartidas entre hilos
+  void sample(std::span<uint64_t>, uint64_t, int = 1) const;
+
+ private:
+  //-----------------CONSTANTES-----------------
+  /// kMuestrasPorBloque: Cada bloque de muestras usa su propio flujo
+  ///                     aleatorio, de modo que el resultado no depende del
+  ///                     número de hilos
+  static constexpr uint64_t kMuestrasPorBloque = 1ULL << 16;
+  /// kMaximoEstados: Los alias se guardan con 32 bits
+  static constexpr uint64_t kMaximoEstados = 1ULL << 32;
+
+  //-----------------ATRIBUTOS-----------------
+  int numero_variables_;
+  uint64_t version_;
+  double masa_total_;
+  std::vector<AliasEntry> tabla_;
+  /// estados_: Estado de cada posición (solo distribuciones dispersas)
+  std::vector<uint64_t> estados_;
+  /// libres_: Bits físicos no condicionados de una rebanada densa
+  std::optional<BitExtractor> libres_;
+  /// valC_fisico_: Valores físicos de la evidencia de una rebanada densa
+  uint64_t valC_fisico_;
+  /// distribucion_: Distribución densa que traduce los estados físicos a
+  ///                lógicos (nullptr para una distribución dispersa)
+  const BinaryDistribution* distribucion_;
+
+  //-----------------MÉTODOS PRIVADOS-----------------
+  void buildTable(std::vector<double>);
+  uint64_t toState(uint64_t) const;
+};
@@ -0,0 +1,160 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   bit_extractor.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase BitExtractor, que implementa la
+ *         extracción (PEXT) y el depósito (PDEP) de bits según una máscara.
+ */
+
+#include <algorithm>
+#include <bit>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "bit_extractor.h"
+
+/**
+ * @brief Constructor que precalcula las tablas de extracción y depósito para
+ *        una máscara dada
+ * @param[in] mascara: Máscara de bits a extraer o depositar
+ */
+BitExtractor::BitExtractor(uint64_t mascara)
+    : mascara_(mascara), numero_bits_(std::popcount(mascara)),
+      numero_bytes_activos_(0) {
+  int desplazamiento = 0;
+  for (int byte = 0; byte < 8; ++byte) {
+    uint64_t mascara_byte = (mascara >> (8 * byte)) & 0xFF;
+    desplazamientos_[byte] = desplazamiento;
+    bits_por_byte_[byte] = std::popcount(mascara_byte);
+    if (mascara_byte != 0) {
+      bytes_activos_[numero_bytes_activos_++] = byte;
+    }
+
+    for (uint64_t valor = 0; valor < 256; ++valor) {
+      // Extracción: compactamos los bits del valor que caen en la máscara
+      uint64_t compacto = 0;
+      int bit_compacto = 0;
+      // Depósito: repartimos los bits del valor sobre la máscara
+      uint64_t expandido = 0;
+      int bit_origen = 0;
+      for (int bit = 0; bit < 8; ++bit) {
+        if (mascara_byte & (1ULL << bit)) {
+          if (valor & (1ULL << bit)) {
+            compacto |= 1ULL << bit_compacto;
+          }
+          if (valor & (1ULL << bit_origen)) {
+            expandido |= 1ULL << bit;
+          }
+          bit_compacto++;
+          bit_origen++;
+        }
+      }
+      tabla_extraccion_[byte][valor] = compacto << desplazamiento;
+      tabla_deposito_[byte][valor] = expandido << (8 * byte);
+    }
+    desplazamiento += bits_por_byte_[byte];
+  }
+}
+
+/**
+ * @brief Método para detectar el núcleo de manipulación de bits más rápido
+ *        soportado por la CPU en la que se ejecuta el programa
+ * @return BitKernel::kBmi2 si la CPU anuncia BMI2 mediante CPUID,
+ *         BitKernel::kSoftware en caso contrario
+ */
+BitKernel BitExtractor::detectKernel() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("bmi2")) {
+    return BitKernel::kBmi2;
+  }
+#endif
+  return BitKernel::kSoftware;
+}
+
+#if defined(__x86_64__)
+/**
+ * @brief Método para compactar los bits de la máscara usando PEXT
+ * @param[in] estado: Estado del que se extraen los bits
+ * @param[in] mascara: Máscara de bits a extraer
+ * @return Bits de la máscara compactados en las posiciones menos
+ *         significativas
+ */
+__attribute__((target("bmi2")))
+uint64_t BitExtractor::extractBmi2(uint64_t estado, uint64_t mascara) {
+  return _pext_u64(estado, mascara);
+}
+
+/**
+ * @brief Método para expandir un índice compacto usando PDEP
+ * @param[in] indice: Índice compacto a expandir
+ * @param[in] mascara: Máscara sobre cuyas posiciones se depositan los bits
+ * @return Estado con los bits del índice en las posiciones de la máscara
+ */
+__attribute__((target("bmi2")))
+uint64_t BitExtractor::depositBmi2(uint64_t indice, uint64_t mascara) {
+  return _pdep_u64(indice, mascara);
+}
+#else
+// Sin x86-64 no existe BMI2: se delega en las tablas por bytes
+uint64_t BitExtractor::extractBmi2(uint64_t estado, uint64_t mascara) {
+  return BitExtractor(mascara).extract(estado);
+}
+
+uint64_t BitExtractor::depositBmi2(uint64_t indice, uint64_t mascara) {
+  return BitExtractor(mascara).deposit(indice);
+}
+#endif
+
+/**
+ * @brief Función para pasar un histograma de unas variables del orden físico
+ *        de sus bits (índice compactado según las posiciones físicas) al
+ *        orden lógico (índice compactado según las variables). No hace nada
+ *        si ambos órdenes coinciden.
+ * @param[in] maskI: Máscara lógica de las variables del histograma
+ * @param[in] posicion_fisica: Bit físico de cada variable lógica
+ * @param[in,out] salida: Histograma de 2^|I| posiciones
+ * @param[in,out] copia: Memoria para la copia física, que solo crece
+ */
+void reorderCompactedIndex(uint64_t maskI,
+                           std::span<const int> posicion_fisica,
+                           double* salida, std::vector<double>& copia) {
+  // rango[k]: posición, en el índice físico, de la k-ésima variable lógica
+  uint64_t mascara_fisica = 0;
+  for (uint64_t resto = maskI; resto != 0; resto &= resto - 1) {
+    mascara_fisica |= 1ULL << posicion_fisica[std::countr_zero(resto)];
+  }
+  std::array<int, 64> rango;
+  int numero_bits = 0;
+  bool ordenado = true;
+  for (uint64_t resto = maskI; resto != 0; resto &= resto - 1) {
+    uint64_t bit = 1ULL << posicion_fisica[std::countr_zero(resto)];
+    rango[numero_bits] = std::popcount(mascara_fisica & (bit - 1));
+    ordenado = ordenado && rango[numero_bits] == numero_bits;
+    numero_bits++;
+  }
+  if (ordenado) {
+    return;
+  }
+
+  uint64_t longitud = 1ULL << numero_bits;
+  if (copia.size() < longitud) {
+    copia.resize(longitud);
+  }
+  std::copy(salida, salida + longitud, copia.begin());
+  for (uint64_t j = 0; j < longitud; ++j) {
+    uint64_t logico = 0;
+    for (int k = 0; k < numero_bits; ++k) {
+      logico |= ((j >> rango[k]) & 1ULL) << k;
+    }
+    salida[logico] = copia[j];
+  }
+}
@@ -0,0 +1,99 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   bit_extractor.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase BitExtractor, que implementa la extracción
+ *         (PEXT) y el depósito (PDEP) de bits según una máscara, con un núcleo
+ *         BMI2 y un respaldo software basado en tablas por bytes.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Variantes del núcleo de manipulación de bits. Se elige una sola vez
+ *        en tiempo de ejecución según las capacidades de la CPU.
+ */
+enum class BitKernel {
+  kSoftware,  ///< Tablas de consulta por bytes (cualquier CPU)
+  kBmi2       ///< Instrucciones PEXT/PDEP de BMI2
+};
+
+/**
+ * @brief Clase que precalcula, para una máscara fija, las tablas que permiten
+ *        extraer y depositar sus bits procesando el estado byte a byte.
+ */
+class BitExtractor {
+ public:
+  //-------------------------CONSTRUCTOR-------------------------
+  explicit BitExtractor(uint64_t);
+
+  //-------------------------MÉTODOS-------------------------
+  uint64_t getMask() const { return mascara_; }
+  int getNumberBits() const { return numero_bits_; }
+
+  /// Método para compactar los bits de la máscara presentes en un estado
+  uint64_t extract(uint64_t estado) const {
+    uint64_t resultado = 0;
+    for (int i = 0; i < numero_bytes_activos_; ++i) {
+      int byte = bytes_activos_[i];
+      resultado |= tabla_extraccion_[byte][(estado >> (8 * byte)) & 0xFF];
+    }
+    return resultado;
+  }
+  /// Método para expandir un índice compacto sobre las posiciones de la máscara
+  uint64_t deposit(uint64_t indice) const {
+    uint64_t resultado = 0;
+    for (int i = 0; i < numero_bytes_activos_; ++i) {
+      int byte = bytes_activos_[i];
+      uint64_t fragmento = (indice >> desplazamientos_[byte]) &
+                           ((1ULL << bits_por_byte_[byte]) - 1);
+      resultado |= tabla_deposito_[byte][fragmento];
+    }
+    return resultado;
+  }
+
+  /// Método para detectar mediante CPUID el mejor núcleo disponible
+  static BitKernel detectKernel();
+  /// Métodos que ejecutan PEXT/PDEP directamente (requieren BMI2)
+  static uint64_t extractBmi2(uint64_t, uint64_t);
+  static uint64_t depositBmi2(uint64_t, uint64_t);
+
+ private:
+  //-----------------ATRIBUTOS-----------------
+  /// mascara_: Máscara cuyos bits se extraen o depositan
+  uint64_t mascara_;
+  /// numero_bits_: Número de bits activos en la máscara
+  int numero_bits_;
+  /// numero_bytes_activos_: Número de bytes de la máscara con algún bit a 1
+  int numero_bytes_activos_;
+  /// bytes_activos_: Posiciones de los bytes de la máscara con algún bit a 1
+  std::array<int, 8> bytes_activos_;
+  /// desplazamientos_: Posición en el índice compacto del primer bit de cada
+  ///                   byte de la máscara
+  std::array<int, 8> desplazamientos_;
+  /// bits_por_byte_: Número de bits de la máscara en cada byte
+  std::array<int, 8> bits_por_byte_;
+  /// tabla_extraccion_: Para cada byte, valor de ese byte del estado ya
+  ///                    compactado y desplazado a su posición en el índice
+  std::array<std::array<uint64_t, 256>, 8> tabla_extraccion_;
+  /// tabla_deposito_: Para cada byte, fragmento del índice compacto ya
+  ///                  expandido sobre las posiciones de la máscara
+  std::array<std::array<uint64_t, 256>, 8> tabla_deposito_;
+};
+
+/// Función para pasar un histograma indexado por los bits físicos
+/// compactados de unas variables al orden lógico de esas variables
+void reorderCompactedIndex(uint64_t, std::span<const int>, double*,
+                           std::vector<double>&);
@@ -14,19 +14,170 @@
  *         permitiendo calcular distribuciones condicionales a partir de una distribución conjunta.
  */
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
 #include <cstring>
+#include <optional>
 #include <stdexcept>
 #include <numeric>
+#include <type_traits>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 #include "conditional_inference_engine.h"
+#include "../counter_rng/counter_rng.h"
+#include "../parallel_executor/parallel_executor.h"
+#include "../variable_elimination_engine/variable_elimination_engine.h"
+
+/**
+ * @brief Núcleo software de marginalización: enumera los subconjuntos de los
+ *        bits libres exteriores y extrae el índice de interés con tablas por
+ *        bytes. Cada estado enumerado abre un bloque contiguo de
+ *        longitud_bloque estados marginalizados que se reduce con sumar.
+ * @param[in] probabilidades: Tabla de la distribución conjunta (double,
+ *                            float o bfloat16; se acumula en double)
+ * @param[in] base: Bits fijados por la evidencia
+ * @param[in] libres: Bits libres a enumerar (excluido el bloque contiguo)
+ * @param[in] longitud_bloque: Longitud del bloque contiguo de bits bajos
+ * @param[in] sumar: Función de reducción de bloques contiguos
+ * @param[in] extractor: Extractor de los bits de interés
+ * @param[out] salida: Histograma sobre los estados de interés
+ */
+template <class Valor>
+static void marginalizeSoftware(const Valor* probabilidades, uint64_t base,
+                                uint64_t libres, uint64_t longitud_bloque,
+                                double (*sumar)(const Valor*, uint64_t),
+                                const BitExtractor& extractor,
+                                double* salida) {
+  uint64_t subconjunto = 0;
+  if (longitud_bloque == 1) {
+    do {
+      uint64_t estado = base | subconjunto;
+      salida[extractor.extract(estado)] += probabilidades[estado];
+      subconjunto = (subconjunto - libres) & libres;
+    } while (subconjunto != 0);
+    return;
+  }
+  do {
+    uint64_t estado = base | subconjunto;
+    salida[extractor.extract(estado)] +=
+        sumar(probabilidades + estado, longitud_bloque);
+    subconjunto = (subconjunto - libres) & libres;
+  } while (subconjunto != 0);
+}
+
+#if defined(__x86_64__)
+/**
+ * @brief Núcleo BMI2 de marginalización: genera cada estado con PDEP a
+ *        partir de un contador y extrae el índice de interés con PEXT. Cada
+ *        estado enumerado abre un bloque contiguo de longitud_bloque estados
+ *        marginalizados que se reduce con sumar.
+ * @param[in] probabilidades: Tabla de la distribución conjunta
+ * @param[in] base: Bits fijados por la evidencia
+ * @param[in] libres: Bits libres a enumerar (excluido el bloque contiguo)
+ * @param[in] longitud_bloque: Longitud del bloque contiguo de bits bajos
+ * @param[in] sumar: Función de reducción de bloques contiguos
+ * @param[in] maskI: Máscara de variables de interés
+ * @param[out] salida: Histograma sobre los estados de interés
+ */
+template <class Valor>
+__attribute__((target("bmi2")))
+static void marginalizeBmi2(const Valor* probabilidades, uint64_t base,
+                            uint64_t libres, uint64_t longitud_bloque,
+                            double (*sumar)(const Valor*, uint64_t),
+                            uint64_t maskI, double* salida) {
+  uint64_t total = 1ULL << std::popcount(libres);
+  if (longitud_bloque == 1) {
+    for (uint64_t contador = 0; contador < total; ++contador) {
+      uint64_t estado = base | _pdep_u64(contador, libres);
+      salida[_pext_u64(estado, maskI)] += probabilidades[estado];
+    }
+    return;
+  }
+  for (uint64_t contador = 0; contador < total; ++contador) {
+    uint64_t estado = base | _pdep_u64(contador, libres);
+    salida[_pext_u64(estado, maskI)] +=
+        sumar(probabilidades + estado, longitud_bloque);
+  }
+}
+#else
+// Sin x86-64 no existe BMI2: se delega en el núcleo software
+template <class Valor>
+static void marginalizeBmi2(const Valor* probabilidades, uint64_t base,
+                            uint64_t libres, uint64_t longitud_bloque,
+                            double (*sumar)(const Valor*, uint64_t),
+                            uint64_t maskI, double* salida) {
+  marginalizeSoftware(probabilidades, base, libres, longitud_bloque, sumar,
+                      BitExtractor(maskI), salida);
+}
+#endif
 
 /**
  * @brief Constructor del motor de inferencia
  * @param[in] distribucion_conjunta: Distribución conjunta sobre la que realizar
  *                                   inferencias
+ * @param[in] numero_hilos: Número de hilos a usar en la marginalización
+ * @throws std::invalid_argument si el número de hilos es menor que 1
  */
 ConditionalInferenceEngine::ConditionalInferenceEngine(
-    const BinaryDistribution& distribucion_conjunta)
-    : distribucion_conjunta_(distribucion_conjunta) {}
+    const BinaryDistribution& distribucion_conjunta, int numero_hilos)
+    : distribucion_conjunta_(&distribucion_conjunta),
+      distribucion_dispersa_(nullptr), modelo_factorizado_(nullptr),
+      nucleo_bits_(BitExtractor::detectKernel()),
+      nucleo_simd_(SimdReducer::detectKernel()), numero_hilos_(1),
+      version_cache_(distribucion_conjunta.getVersion()),
+      estados_evaluados_(0) {
+  setNumberThreads(numero_hilos);
+}
+
+/**
+ * @brief Constructor del motor de inferencia sobre una distribución dispersa:
+ *        cada consulta recorre solo los estados no nulos
+ * @param[in] distribucion_dispersa: Distribución conjunta dispersa
+ * @param[in] numero_hilos: Número de hilos (solo afecta a los lotes)
+ * @throws std::invalid_argument si el número de hilos es menor que 1
+ */
+ConditionalInferenceEngine::ConditionalInferenceEngine(
+    const SparseDistribution& distribucion_dispersa, int numero_hilos)
+    : distribucion_conjunta_(nullptr),
+      distribucion_dispersa_(&distribucion_dispersa),
+      modelo_factorizado_(nullptr),
+      nucleo_bits_(BitExtractor::detectKernel()),
+      nucleo_simd_(SimdReducer::detectKernel()), numero_hilos_(1),
+      version_cache_(distribucion_dispersa.getVersion()),
+      estados_evaluados_(0) {
+  setNumberThreads(numero_hilos);
+}
+
+/**
+ * @brief Constructor del motor de inferencia sobre un modelo factorizado
+ *        (N <= 64): las consultas se responden sobre un árbol de unión que se
+ *        calibra una vez por cada evidencia distinta, de modo que las
+ *        consultas que comparten evidencia solo suman la creencia de un
+ *        clique
+ * @param[in] modelo: Modelo factorizado
+ * @param[in] numero_hilos: Número de hilos de la calibración
+ * @throws std::invalid_argument si el número de hilos es menor que 1 o el
+ *         modelo tiene más de 64 variables
+ * @throws std::runtime_error si el árbol de unión es demasiado ancho
+ */
+ConditionalInferenceEngine::ConditionalInferenceEngine(
+    const FactorGraph& modelo, int numero_hilos)
+    : distribucion_conjunta_(nullptr), distribucion_dispersa_(nullptr),
+      modelo_factorizado_(&modelo),
+      arbol_(std::make_unique<JunctionTree>(modelo)),
+      nucleo_bits_(BitExtractor::detectKernel()),
+      nucleo_simd_(SimdReducer::detectKernel()), numero_hilos_(1),
+      version_cache_(modelo.getVersion()), estados_evaluados_(0) {
+  if (modelo.getNumberVariables() > 64) {
+    throw std::invalid_argument(
+        "Error: El motor de máscaras admite como máximo 64 variables");
+  }
+  setNumberThreads(numero_hilos);
+}
 
 /**
  * @brief Método para calcular la distribución condicional P(X_I | X_C = c)
@@ -34,36 +185,102 @@ ConditionalInferenceEngine::ConditionalInferenceEngine(
  * @param[in] maskC: Máscara de variables condicionadas
  * @param[in] valC: Valores de variables condicionadas
  * @param[in] maskI: Máscara de variables de interés
- * @return Array con probabilidades condicionales
+ * @return Array con probabilidades condicionales (el llamador lo libera con
+ *         delete[]; computeConditionalInto evita la reserva)
  */
 double* ConditionalInferenceEngine::prob_cond_bin(uint64_t maskC,
                                                    uint64_t valC,
                                                    uint64_t maskI) {
-  int numero_bits_interes = countBits(maskI);
-  uint64_t estados_interes = 1ULL << numero_bits_interes;
-
-  double* salida = new double[estados_interes];
-  std::memset(salida, 0, estados_interes * sizeof(double));
+  double* salida = new double[1ULL << countBits(maskI)];
+  computeInto(maskC, valC, maskI, salida);
+  return salida;
+}
 
-  uint64_t total_estados = distribucion_conjunta_.getStateSpaceSize();
-  for (uint64_t estado = 0; estado < total_estados; ++estado) {
-    if (isConsistent(estado, maskC, valC)) {
-      uint64_t indice_interes = extractInterestBits(estado, maskI);
-      salida[indice_interes] += distribucion_conjunta_.getProbability(estado);
-    }
+/**
+ * @brief Método para calcular P(X_I | X_C = c) en un búfer del llamador. Sin
+ *        caché (o acertando en ella), la llamada no reserva memoria una vez
+ *        que las memorias auxiliares del motor han alcanzado su tamaño y los
+ *        hilos del ParallelExecutor se han creado.
+ * @param[in] consulta: Consulta condicional (con las máscaras calculadas)
+ * @param[out] salida: Búfer de al menos 2^|I| posiciones
+ * @return Vista de las 2^|I| probabilidades escritas en salida
+ * @throws std::invalid_argument si el búfer es demasiado pequeño
+ */
+std::span<const double> ConditionalInferenceEngine::computeConditionalInto(
+    const ConditionalQuery& consulta, std::span<double> salida) {
+  uint64_t estados_interes = 1ULL << countBits(consulta.getMaskI());
+  if (salida.size() < estados_interes) {
+    throw std::invalid_argument(
+        "Error: El búfer de salida debe tener 2^|I| posiciones");
   }
+  computeInto(consulta.getMaskC(), consulta.getValC(), consulta.getMaskI(),
+              salida.data());
+  return salida.first(estados_interes);
+}
 
-  double suma = 0.0;
-  for (uint64_t i = 0; i < estados_interes; ++i) {
-    suma += salida[i];
+/**
+ * @brief Método para calcular P(X_I | X_C = c) en la memoria de resultados
+ *        del motor, que solo crece (ver computeConditionalInto)
+ * @param[in] consulta: Consulta condicional (con las máscaras calculadas)
+ * @return Vista del resultado, válida hasta la siguiente consulta del motor
+ */
+std::span<const double> ConditionalInferenceEngine::computeConditionalView(
+    const ConditionalQuery& consulta) {
+  uint64_t estados_interes = 1ULL << countBits(consulta.getMaskI());
+  if (resultado_.size() < estados_interes) {
+    resultado_.resize(estados_interes);
   }
-  if (suma > 1e-10) {
-    for (uint64_t i = 0; i < estados_interes; ++i) {
-      salida[i] /= suma;
+  return computeConditionalInto(consulta, resultado_);
+}
+
+/**
+ * @brief Método que calcula la distribución condicional en salida,
+ *        consultando y actualizando la caché de resultados
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] maskI: Máscara de variables de interés
+ * @param[out] salida: Búfer de al menos 2^|I| posiciones
+ */
+void ConditionalInferenceEngine::computeInto(uint64_t maskC, uint64_t valC,
+                                             uint64_t maskI, double* salida) {
+  uint64_t estados_interes = 1ULL << countBits(maskI);
+
+  // Si la distribución ha cambiado desde que se llenó la caché, sus
+  // resultados ya no son válidos
+  QueryKey clave{maskC, valC, maskI};
+  bool usar_cache = cache_.getCapacity() > 0;
+  if (usar_cache) {
+    if (version_cache_ != distributionVersion()) {
+      cache_.invalidate();
+      version_cache_ = distributionVersion();
+    }
+    if (const std::vector<double>* guardado = cache_.find(clave)) {
+      std::memcpy(salida, guardado->data(), estados_interes * sizeof(double));
+      estados_evaluados_ = 0;
+      return;
     }
   }
 
-  return salida;
+  std::memset(salida, 0, estados_interes * sizeof(double));
+  marginalize(maskC, valC, maskI, salida);
+  normalizeHistogram(salida, estados_interes);
+
+  if (usar_cache) {
+    cache_.insert(clave, salida, estados_interes);
+  }
+}
+
+/**
+ * @brief Método para establecer el número de hilos de la marginalización
+ * @param[in] numero_hilos: Número de hilos (1 para ejecución secuencial)
+ * @throws std::invalid_argument si el número de hilos es menor que 1
+ */
+void ConditionalInferenceEngine::setNumberThreads(int numero_hilos) {
+  if (numero_hilos < 1) {
+    throw std::invalid_argument(
+        "Error: El número de hilos debe ser al menos 1");
+  }
+  numero_hilos_ = numero_hilos;
 }
 
 /**
@@ -80,28 +297,1075 @@ InferenceResult ConditionalInferenceEngine::computeConditional(
 
   auto inicio = std::chrono::high_resolution_clock::now();
 
-  double* salida =
-      prob_cond_bin(consulta.getMaskC(), consulta.getValC(),
-                    consulta.getMaskI());
-  int numero_bits_interes = countBits(consulta.getMaskI());
-  uint64_t estados_interes = 1ULL << numero_bits_interes;
-  
+  std::span<const double> salida = computeConditionalView(consulta);
   auto distribucion =
-      std::make_unique<BinaryDistribution>(numero_bits_interes);
-  for (uint64_t i = 0; i < estados_interes; ++i) {
-    distribucion->setProbability(i, salida[i]);
-  }
+      buildDistribution(salida.data(), countBits(consulta.getMaskI()));
 
   auto fin = std::chrono::high_resolution_clock::now();
   resultado.tiempo_ejecucion =
       std::chrono::duration<double, std::micro>(fin - inicio).count();
-  resultado.estados_evaluados =
-      distribucion_conjunta_.getStateSpaceSize();
+  resultado.estados_evaluados = estados_evaluados_;
   resultado.distribucion = std::move(distribucion);
 
   return resultado;
 }
 
+/**
+ * @brief Método para acumular en salida la masa (sin normalizar) de cada
+ *        estado de interés, recorriendo solo los estados consistentes con la
+ *        evidencia
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] maskI: Máscara de variables de interés
+ * @param[out] salida: Histograma de 2^|I| posiciones inicializado a cero
+ */
+void ConditionalInferenceEngine::marginalize(uint64_t maskC, uint64_t valC,
+                                             uint64_t maskI, double* salida) {
+  estados_evaluados_ = 0;
+  uint64_t mascara_todas = allVariablesMask();
+  if ((valC & ~(maskC & mascara_todas)) != 0) {
+    return;
+  }
+
+  // Con vistas materializadas vigentes, la consulta se resuelve sobre la
+  // vista más pequeña que contiene sus variables
+  uint64_t libres = mascara_todas & ~maskC;
+  if (vistas_ && distribucion_conjunta_ &&
+      vistas_->getDistributionIdentifier() ==
+          distribucion_conjunta_->getIdentifier() &&
+      vistas_->getVersion() == distribucion_conjunta_->getVersion()) {
+    const MarginalView* vista = vistas_->findView((maskC | maskI) &
+                                                  mascara_todas);
+    if (vista && vista->probabilidades.size() < (1ULL << countBits(libres))) {
+      estados_evaluados_ =
+          marginalizeCompact(vista->probabilidades.data(), vista->variables,
+                             maskC & mascara_todas, valC, maskI, salida);
+      return;
+    }
+  }
+
+  if (modelo_factorizado_) {
+    marginalizeFactorized(maskC & mascara_todas, valC, maskI & mascara_todas,
+                          salida);
+    return;
+  }
+
+  // Una distribución dispersa solo recorre sus estados no nulos
+  if (distribucion_dispersa_) {
+    estados_evaluados_ = distribucion_dispersa_->marginalize(
+        maskC & mascara_todas, valC, maskI & mascara_todas, salida);
+    return;
+  }
+
+  // La tabla puede almacenar las variables en otro orden físico: la consulta
+  // se traduce, se resuelve sobre la tabla y el histograma vuelve al orden
+  // lógico de las variables de interés
+  if (!distribucion_conjunta_->hasIdentityOrder()) {
+    marginalizeTable(
+        distribucion_conjunta_->toPhysicalState(maskC & mascara_todas),
+        distribucion_conjunta_->toPhysicalState(valC),
+        distribucion_conjunta_->toPhysicalState(maskI & mascara_todas),
+        salida);
+    reorderInterest(maskI & mascara_todas, salida);
+    return;
+  }
+  marginalizeTable(maskC & mascara_todas, valC, maskI, salida);
+}
+
+/**
+ * @brief Método para acumular en salida la masa de cada estado de interés
+ *        directamente sobre la tabla (máscaras en orden físico), con el
+ *        índice de superconjuntos o recorriendo el subcubo consistente
+ * @param[in] maskC: Máscara física de variables condicionadas
+ * @param[in] valC: Valores físicos de variables condicionadas
+ * @param[in] maskI: Máscara física de variables de interés
+ * @param[out] salida: Histograma de 2^|I| posiciones inicializado a cero, en
+ *                     orden físico de las variables de interés
+ */
+void ConditionalInferenceEngine::marginalizeTable(uint64_t maskC,
+                                                  uint64_t valC,
+                                                  uint64_t maskI,
+                                                  double* salida) {
+  uint64_t mascara_todas = allVariablesMask();
+  uint64_t libres = mascara_todas & ~maskC;
+
+  // Con un índice de sumas sobre superconjuntos vigente, la consulta se
+  // resuelve por inclusión-exclusión si resulta más barato que el recorrido
+  if (indice_superconjuntos_ &&
+      indice_superconjuntos_->getDistributionIdentifier() ==
+          distribucion_conjunta_->getIdentifier() &&
+      indice_superconjuntos_->getVersion() ==
+          distribucion_conjunta_->getVersion() &&
+      SupersetSumIndex::estimateCost(maskC, valC, maskI) <
+          std::ldexp(1.0, countBits(libres))) {
+    // El subcubo de la transformada reutiliza la memoria de los parciales
+    uint64_t longitud_cubo =
+        SupersetSumIndex::getWorkspaceSize(maskC, valC, maskI);
+    if (parciales_.size() < longitud_cubo) {
+      parciales_.resize(longitud_cubo);
+    }
+    estados_evaluados_ = indice_superconjuntos_->marginalize(
+        maskC, valC, maskI, salida, parciales_.data());
+    return;
+  }
+
+  // Solo se recorre el subcubo de estados consistentes con la evidencia: los
+  // bits de maskC quedan fijados a valC y se enumeran directamente las
+  // combinaciones de los bits libres, en orden creciente de estado.
+  estados_evaluados_ = 1ULL << countBits(libres);
+  MarginalizationPlan plan = makePlan(libres, maskI);
+  uint64_t estados_interes = plan.estados_interes;
+
+  // El subcubo se parte en bloques fijando sus bits libres más altos. El
+  // número de bloques depende solo de la consulta, nunca del número de hilos,
+  // de modo que el orden de las sumas (y por tanto el resultado) es idéntico
+  // bit a bit con cualquier número de hilos.
+  uint64_t bits_particion = partitionBits(plan.libres_exteriores,
+                                          countBits(libres), estados_interes);
+  if (bits_particion == 0) {
+    distribucion_conjunta_->visitProbabilities([&](const auto* probabilidades) {
+      accumulate(plan, probabilidades, valC, plan.libres_exteriores, salida);
+    });
+    return;
+  }
+
+  uint64_t numero_bloques = 1ULL << countBits(bits_particion);
+  uint64_t libres_bloque = plan.libres_exteriores & ~bits_particion;
+  BitExtractor particion(bits_particion);
+  // Los histogramas parciales reutilizan la memoria de consultas anteriores
+  uint64_t longitud_parciales = numero_bloques * estados_interes;
+  if (parciales_.size() < longitud_parciales) {
+    parciales_.resize(longitud_parciales);
+  }
+  std::fill_n(parciales_.begin(), longitud_parciales, 0.0);
+  distribucion_conjunta_->visitProbabilities([&](const auto* probabilidades) {
+    ParallelExecutor::run(numero_bloques, numero_hilos_, [&](uint64_t bloque) {
+      uint64_t base = valC | particion.deposit(bloque);
+      accumulate(plan, probabilidades, base, libres_bloque,
+                 parciales_.data() + bloque * estados_interes);
+    });
+  });
+
+  reducePartials(parciales_.data(), numero_bloques, estados_interes);
+  std::memcpy(salida, parciales_.data(), estados_interes * sizeof(double));
+}
+
+/**
+ * @brief Método para preparar la marginalización de una consulta: detecta el
+ *        tramo contiguo de bits bajos marginalizados y elige los núcleos
+ * @param[in] libres: Bits libres (no condicionados) a recorrer
+ * @param[in] maskI: Máscara de variables de interés
+ * @return Plan de marginalización de la consulta
+ */
+ConditionalInferenceEngine::MarginalizationPlan
+ConditionalInferenceEngine::makePlan(uint64_t libres, uint64_t maskI) const {
+  MarginalizationPlan plan;
+  plan.maskI = maskI;
+  plan.estados_interes = 1ULL << countBits(maskI);
+
+  // Si los bits más bajos son todos marginalizados (maskM), cada combinación
+  // de los bits restantes abre un tramo contiguo de la tabla que se reduce
+  // con sumas vectoriales; el bucle escalar solo realiza el reparto exterior.
+  uint64_t maskM = libres & ~maskI;
+  int bits_contiguos = std::countr_one(maskM);
+  if (bits_contiguos < kBitsMinimosBloqueContiguo) {
+    bits_contiguos = 0;
+  }
+  plan.longitud_bloque = 1ULL << bits_contiguos;
+  plan.libres_exteriores = libres & ~(plan.longitud_bloque - 1);
+  plan.sumar = SimdReducer::sumFunction(nucleo_simd_);
+  plan.sumar_float = SimdReducer::sumFunctionFloat(nucleo_simd_);
+  plan.sumar_bfloat16 = SimdReducer::sumFunctionBfloat16(nucleo_simd_);
+  if (nucleo_bits_ == BitKernel::kSoftware) {
+    plan.extractor.emplace(maskI);
+  }
+  return plan;
+}
+
+/**
+ * @brief Método para acumular en destino la masa de los estados base | s,
+ *        para cada subconjunto s de libres, según el plan de la consulta
+ * @param[in] plan: Plan de marginalización de la consulta
+ * @param[in] probabilidades: Tabla de probabilidades indexada por estado
+ * @param[in] base: Bits fijos de los estados a recorrer
+ * @param[in] libres: Bits libres exteriores a enumerar
+ * @param[out] destino: Histograma sobre los estados de interés
+ */
+template <class Valor>
+void ConditionalInferenceEngine::accumulate(const MarginalizationPlan& plan,
+                                            const Valor* probabilidades,
+                                            uint64_t base, uint64_t libres,
+                                            double* destino) const {
+  double (*sumar)(const Valor*, uint64_t);
+  if constexpr (std::is_same_v<Valor, float>) {
+    sumar = plan.sumar_float;
+  } else if constexpr (std::is_same_v<Valor, Bfloat16>) {
+    sumar = plan.sumar_bfloat16;
+  } else {
+    sumar = plan.sumar;
+  }
+  if (plan.extractor) {
+    marginalizeSoftware(probabilidades, base, libres, plan.longitud_bloque,
+                        sumar, *plan.extractor, destino);
+  } else {
+    marginalizeBmi2(probabilidades, base, libres, plan.longitud_bloque,
+                    sumar, plan.maskI, destino);
+  }
+}
+
+/**
+ * @brief Método para combinar histogramas parciales mediante una reducción
+ *        en árbol: en cada nivel el bloque i acumula el bloque i + paso,
+ *        siempre en el mismo orden, y el resultado queda en el primero
+ * @param[in,out] parciales: Histogramas parciales consecutivos
+ * @param[in] numero_bloques: Número de histogramas (potencia de dos)
+ * @param[in] longitud: Número de posiciones de cada histograma
+ */
+void ConditionalInferenceEngine::reducePartials(double* parciales,
+                                                uint64_t numero_bloques,
+                                                uint64_t longitud) const {
+  int hilos_reduccion =
+      longitud >= kMinimoEstadosReduccionParalela ? numero_hilos_ : 1;
+  for (uint64_t paso = 1; paso < numero_bloques; paso *= 2) {
+    uint64_t numero_pares = numero_bloques / (2 * paso);
+    ParallelExecutor::run(numero_pares, hilos_reduccion, [&](uint64_t par) {
+      double* destino = parciales + 2 * par * paso * longitud;
+      const double* origen = destino + paso * longitud;
+      for (uint64_t i = 0; i < longitud; ++i) {
+        destino[i] += origen[i];
+      }
+    });
+  }
+}
+
+/**
+ * @brief Método para elegir los bits libres que dividen el subcubo en bloques
+ *        independientes para la marginalización paralela
+ * @param[in] libres: Bits libres candidatos (los más altos del subcubo)
+ * @param[in] bits_libres: Número total de bits libres del subcubo
+ * @param[in] estados_interes: Tamaño del histograma de interés
+ * @return Máscara con los bits libres más altos que definen los bloques, o 0
+ *         si el subcubo es demasiado pequeño para dividirlo
+ */
+uint64_t ConditionalInferenceEngine::partitionBits(
+    uint64_t libres, int bits_libres, uint64_t estados_interes) const {
+  int bits_particion =
+      std::clamp(bits_libres - kBitsMinimosPorBloque, 0, kBitsMaximosParticion);
+  bits_particion = std::min(bits_particion, countBits(libres));
+  // Limitamos la memoria de los histogramas parciales
+  while (bits_particion > 0 &&
+         (estados_interes << bits_particion) > kMaximoEstadosParciales) {
+    bits_particion--;
+  }
+
+  uint64_t mascara = 0;
+  for (int i = 0; i < bits_particion; ++i) {
+    uint64_t bit = 1ULL << (63 - std::countl_zero(libres & ~mascara));
+    mascara |= bit;
+  }
+  return mascara;
+}
+
+/**
+ * @brief Método para forzar el núcleo de reducción vectorial del motor
+ * @param[in] nucleo: Núcleo a utilizar
+ * @throws std::invalid_argument si la CPU no soporta el núcleo solicitado
+ */
+void ConditionalInferenceEngine::setSimdKernel(SimdKernel nucleo) {
+  if (static_cast<int>(nucleo) >
+      static_cast<int>(SimdReducer::detectKernel())) {
+    throw std::invalid_argument(
+        "Error: La CPU no soporta el núcleo vectorial solicitado");
+  }
+  nucleo_simd_ = nucleo;
+}
+
+/**
+ * @brief Método para forzar el núcleo de manipulación de bits del motor
+ * @param[in] nucleo: Núcleo a utilizar
+ * @throws std::invalid_argument si se solicita BMI2 y la CPU no lo soporta
+ */
+void ConditionalInferenceEngine::setBitKernel(BitKernel nucleo) {
+  if (nucleo == BitKernel::kBmi2 &&
+      BitExtractor::detectKernel() != BitKernel::kBmi2) {
+    throw std::invalid_argument("Error: La CPU no soporta BMI2");
+  }
+  nucleo_bits_ = nucleo;
+}
+
+/**
+ * @brief Función para obtener el cuantil de la normal estándar que deja una
+ *        probabilidad central dada (bisección sobre erf)
+ * @param[in] confianza: Probabilidad central, en (0, 1)
+ * @return z tal que P(|Z| <= z) = confianza
+ */
+static double normalQuantile(double confianza) {
+  double inferior = 0.0;
+  double superior = 40.0;
+  for (int iteracion = 0; iteracion < 100; ++iteracion) {
+    double medio = 0.5 * (inferior + superior);
+    if (std::erf(medio / std::sqrt(2.0)) < confianza) {
+      inferior = medio;
+    } else {
+      superior = medio;
+    }
+  }
+  return 0.5 * (inferior + superior);
+}
+
+/**
+ * @brief Método para estimar la distribución condicional P(X_I | X_C = c)
+ *        por muestreo. Las muestras se generan en rondas de kLotesPorRonda
+ *        lotes repartidos entre hilos; cada lote usa el flujo aleatorio de su
+ *        índice global y los lotes se combinan en orden, por lo que el
+ *        resultado depende de la semilla y no del número de hilos. Tras cada
+ *        ronda se calculan los intervalos de confianza del estimador
+ *        autonormalizado y se comprueban los criterios de parada (el
+ *        presupuesto de tiempo se respeta con la granularidad de una ronda;
+ *        el de muestras, exactamente).
+ * @param[in] consulta: Consulta condicional (con las máscaras calculadas)
+ * @param[in] opciones: Método de muestreo y criterios de parada
+ * @return Estimación, semiamplitudes de los intervalos y métricas
+ * @throws std::invalid_argument si los parámetros no son válidos o se pide
+ *         muestreo por rechazo sobre un modelo factorizado
+ */
+ApproximateInferenceResult
+ConditionalInferenceEngine::computeConditionalApproximate(
+    const ConditionalQuery& consulta, const SamplingOptions& opciones) {
+  if (!(opciones.error_maximo > 0.0) || !(opciones.confianza > 0.0) ||
+      !(opciones.confianza < 1.0) || opciones.tiempo_maximo < 0.0) {
+    throw std::invalid_argument(
+        "Error: El error máximo debe ser positivo y la confianza estar en "
+        "(0, 1)");
+  }
+  bool rechazo = opciones.metodo == SamplingMethod::kRejection;
+  if (rechazo && modelo_factorizado_) {
+    throw std::invalid_argument(
+        "Error: El muestreo por rechazo requiere una tabla densa o dispersa");
+  }
+  auto inicio = std::chrono::high_resolution_clock::now();
+
+  uint64_t mascara_todas = allVariablesMask();
+  uint64_t maskC = consulta.getMaskC() & mascara_todas;
+  uint64_t valC = consulta.getValC();
+  uint64_t maskI = consulta.getMaskI() & mascara_todas;
+  int bits_interes = countBits(maskI);
+  uint64_t estados_interes = 1ULL << bits_interes;
+  uint64_t libres = mascara_todas & ~maskC;
+  uint64_t mascara_indice =
+      countBits(libres) >= 64 ? ~0ULL : (1ULL << countBits(libres)) - 1;
+  BitExtractor interes(maskI);
+  BitExtractor subcubo(libres);
+  const IDistribution& distribucion = distribution();
+  if (rechazo) {
+    prepareSampler();
+  }
+  bool masa_nula = (valC & ~maskC) != 0 || (rechazo && !muestreador_);
+  double z = normalQuantile(opciones.confianza);
+
+  // Cada lote acumula Σw y Σw² por estado de interés
+  uint64_t lotes = std::clamp<uint64_t>(
+      kMaximoEstadosParciales / (2 * estados_interes), 1, kLotesPorRonda);
+  uint64_t longitud_lote = 2 * estados_interes;
+  if (parciales_.size() < lotes * longitud_lote) {
+    parciales_.resize(lotes * longitud_lote);
+  }
+  std::vector<double> suma(estados_interes, 0.0);
+  std::vector<double> suma_cuadrados(estados_interes, 0.0);
+  std::vector<double> estimacion(estados_interes, 0.0);
+
+  ApproximateInferenceResult resultado;
+  resultado.semiamplitudes.assign(estados_interes, 0.0);
+  uint64_t lote_global = 0;
+  while (!masa_nula && resultado.muestras < opciones.muestras_maximas) {
+    // La última ronda se recorta al presupuesto que queda: menos lotes y el
+    // último más corto (un prefijo de su flujo aleatorio)
+    uint64_t restantes = opciones.muestras_maximas - resultado.muestras;
+    uint64_t lotes_ronda =
+        std::min(lotes, (restantes + kMuestrasPorLote - 1) / kMuestrasPorLote);
+    ParallelExecutor::run(lotes_ronda, numero_hilos_, [&](uint64_t lote) {
+      double* acumulado = parciales_.data() + lote * longitud_lote;
+      std::fill_n(acumulado, longitud_lote, 0.0);
+      CounterRng aleatorio(opciones.semilla, lote_global + lote);
+      uint64_t muestras_lote =
+          std::min(kMuestrasPorLote, restantes - lote * kMuestrasPorLote);
+      for (uint64_t k = 0; k < muestras_lote; ++k) {
+        uint64_t estado;
+        double peso;
+        if (rechazo) {
+          estado = muestreador_->draw(aleatorio);
+          if ((estado & maskC) != valC) {
+            continue;
+          }
+          peso = 1.0;
+        } else {
+          estado = valC | subcubo.deposit(aleatorio.next() & mascara_indice);
+          peso = distribucion.getProbability(estado);
+        }
+        uint64_t indice = interes.extract(estado);
+        acumulado[indice] += peso;
+        acumulado[estados_interes + indice] += peso * peso;
+      }
+    });
+    for (uint64_t lote = 0; lote < lotes_ronda; ++lote) {
+      const double* acumulado = parciales_.data() + lote * longitud_lote;
+      for (uint64_t i = 0; i < estados_interes; ++i) {
+        suma[i] += acumulado[i];
+        suma_cuadrados[i] += acumulado[estados_interes + i];
+      }
+    }
+    lote_global += lotes_ronda;
+    resultado.muestras +=
+        std::min(lotes_ronda * kMuestrasPorLote, restantes);
+
+    // Varianza del estimador autonormalizado p_i = S_i / W:
+    // Σ w²(1[i] - p_i)² / W² = (S2_i (1 - p_i)² + (W2 - S2_i) p_i²) / W²
+    double total = 0.0;
+    double total_cuadrados = 0.0;
+    for (uint64_t i = 0; i < estados_interes; ++i) {
+      total += suma[i];
+      total_cuadrados += suma_cuadrados[i];
+    }
+    double error = 0.0;
+    if (total > 0.0) {
+      for (uint64_t i = 0; i < estados_interes; ++i) {
+        double p = suma[i] / total;
+        double varianza = (suma_cuadrados[i] * (1.0 - p) * (1.0 - p) +
+                           (total_cuadrados - suma_cuadrados[i]) * p * p) /
+                          (total * total);
+        estimacion[i] = p;
+        resultado.semiamplitudes[i] = z * std::sqrt(varianza);
+        error = std::max(error, resultado.semiamplitudes[i]);
+      }
+      resultado.tamano_efectivo = total * total / total_cuadrados;
+    }
+    resultado.convergido = total > 0.0 &&
+                           resultado.tamano_efectivo >= kTamanoEfectivoMinimo &&
+                           error <= opciones.error_maximo;
+    double transcurrido =
+        std::chrono::duration<double, std::micro>(
+            std::chrono::high_resolution_clock::now() - inicio)
+            .count();
+    if (resultado.convergido ||
+        (opciones.tiempo_maximo > 0.0 &&
+         transcurrido >= opciones.tiempo_maximo)) {
+      break;
+    }
+  }
+
+  resultado.distribucion = buildDistribution(estimacion.data(), bits_interes);
+  resultado.tiempo_ejecucion =
+      std::chrono::duration<double, std::micro>(
+          std::chrono::high_resolution_clock::now() - inicio)
+          .count();
+  return resultado;
+}
+
+/**
+ * @brief Método para calcular un lote de distribuciones condicionales con una
+ *        sola pasada sobre la distribución conjunta. La tabla se recorre en
+ *        bloques que caben en caché y, por cada bloque, se actualizan los
+ *        histogramas de todas las consultas.
+ *
+ *        Las consultas con poca evidencia se agrupan según la unión de sus
+ *        variables (interés y condicionadas): cada grupo acumula en la pasada
+ *        una única marginal de a lo sumo 2^14 estados, de la que después se
+ *        responden todas sus consultas. Así el coste por estado de la pasada
+ *        depende del número de grupos y no del número de consultas. Las
+ *        consultas con mucha evidencia recorren directamente su subcubo
+ *        consistente dentro de cada bloque.
+ * @param[in] consultas: Consultas condicionales (con las máscaras calculadas)
+ * @return Un resultado por consulta, en el mismo orden. El tiempo de
+ *         ejecución de cada resultado es el de la pasada completa del lote.
+ */
+std::vector<InferenceResult> ConditionalInferenceEngine::computeConditionalBatch(
+    std::span<const ConditionalQuery> consultas) {
+  auto inicio = std::chrono::high_resolution_clock::now();
+
+  // Sobre una distribución dispersa cada consulta ya es proporcional al
+  // soporte, y sobre un modelo factorizado se resuelve en el árbol de unión:
+  // se resuelven una a una, agrupadas por evidencia para calibrar el árbol
+  // una sola vez por grupo
+  if (distribucion_dispersa_ || modelo_factorizado_) {
+    std::vector<size_t> orden(consultas.size());
+    std::iota(orden.begin(), orden.end(), 0);
+    std::stable_sort(orden.begin(), orden.end(), [&](size_t a, size_t b) {
+      return std::pair(consultas[a].getMaskC(), consultas[a].getValC()) <
+             std::pair(consultas[b].getMaskC(), consultas[b].getValC());
+    });
+    std::vector<InferenceResult> resultados(consultas.size());
+    for (size_t i : orden) {
+      resultados[i] = computeConditional(consultas[i]);
+    }
+    double tiempo = std::chrono::duration<double, std::micro>(
+                        std::chrono::high_resolution_clock::now() - inicio)
+                        .count();
+    for (auto& resultado : resultados) {
+      resultado.tiempo_ejecucion = tiempo;
+    }
+    return resultados;
+  }
+
+  // Cada bloque fija los bits altos del estado y contiene todos los bits
+  // bajos
+  uint64_t mascara_todas = allVariablesMask();
+  int bits_bloque =
+      std::min(distribucion_conjunta_->getNumberVariables(), kBitsBloqueLote);
+  uint64_t mascara_bloque = (1ULL << bits_bloque) - 1;
+  uint64_t numero_bloques =
+      distribucion_conjunta_->getStateSpaceSize() >> bits_bloque;
+
+  struct BatchGroup {
+    uint64_t variables;
+    MarginalizationPlan plan;
+    uint64_t desplazamiento;
+  };
+  // Las máscaras de cada entrada están en el orden físico de la tabla
+  struct BatchEntry {
+    uint64_t maskC;
+    uint64_t valC;
+    uint64_t maskI;
+    uint64_t interes_logico;
+    bool factible;
+    int grupo;
+    MarginalizationPlan plan;
+    uint64_t desplazamiento;
+  };
+  std::vector<BatchGroup> grupos;
+  std::vector<BatchEntry> lote;
+  lote.reserve(consultas.size());
+  for (const auto& consulta : consultas) {
+    uint64_t maskC = consulta.getMaskC() & mascara_todas;
+    uint64_t maskI = consulta.getMaskI() & mascara_todas;
+    BatchEntry entrada{distribucion_conjunta_->toPhysicalState(maskC),
+                       distribucion_conjunta_->toPhysicalState(
+                           consulta.getValC() & mascara_todas),
+                       distribucion_conjunta_->toPhysicalState(maskI),
+                       maskI,
+                       (consulta.getValC() & ~maskC) == 0,
+                       -1,
+                       {},
+                       0};
+    uint64_t variables = entrada.maskC | entrada.maskI;
+    if (entrada.factible && countBits(entrada.maskC) <= kMaximoEvidenciaGrupo &&
+        countBits(variables) <= kBitsMaximosGrupo) {
+      for (size_t g = 0; g < grupos.size() && entrada.grupo < 0; ++g) {
+        if (countBits(grupos[g].variables | variables) <= kBitsMaximosGrupo) {
+          grupos[g].variables |= variables;
+          entrada.grupo = static_cast<int>(g);
+        }
+      }
+      if (entrada.grupo < 0) {
+        entrada.grupo = static_cast<int>(grupos.size());
+        grupos.push_back({variables, {}, 0});
+      }
+    }
+    lote.push_back(std::move(entrada));
+  }
+
+  // Disposición de los histogramas de la pasada: primero las marginales de
+  // los grupos y después las consultas directas
+  uint64_t longitud_total = 0;
+  for (auto& grupo : grupos) {
+    grupo.plan = makePlan(mascara_bloque, grupo.variables);
+    grupo.desplazamiento = longitud_total;
+    longitud_total += grupo.plan.estados_interes;
+  }
+  for (auto& entrada : lote) {
+    if (entrada.factible && entrada.grupo < 0) {
+      entrada.plan =
+          makePlan(mascara_todas & ~entrada.maskC & mascara_bloque,
+                   entrada.maskI);
+      entrada.desplazamiento = longitud_total;
+      longitud_total += entrada.plan.estados_interes;
+    }
+  }
+
+  // Los bloques se agrupan en tramos consecutivos con histogramas parciales
+  // propios. Como en prob_cond_bin, el número de tramos depende solo del
+  // lote y no del número de hilos.
+  uint64_t numero_tramos = std::min(numero_bloques, kMaximoTramosLote);
+  while (numero_tramos > 1 &&
+         numero_tramos * longitud_total > kMaximoEstadosParciales) {
+    numero_tramos /= 2;
+  }
+  uint64_t bloques_por_tramo = numero_bloques / numero_tramos;
+  std::vector<double> parciales(numero_tramos * longitud_total, 0.0);
+  distribucion_conjunta_->visitProbabilities([&](const auto* probabilidades) {
+    ParallelExecutor::run(numero_tramos, numero_hilos_, [&](uint64_t tramo) {
+      double* destino = parciales.data() + tramo * longitud_total;
+      uint64_t primero = tramo * bloques_por_tramo;
+      for (uint64_t bloque = primero; bloque < primero + bloques_por_tramo;
+           ++bloque) {
+        uint64_t alta = bloque << bits_bloque;
+        for (const auto& grupo : grupos) {
+          accumulate(grupo.plan, probabilidades, alta,
+                     grupo.plan.libres_exteriores,
+                     destino + grupo.desplazamiento);
+        }
+        for (const auto& entrada : lote) {
+          if (!entrada.factible || entrada.grupo >= 0 ||
+              (alta & entrada.maskC & ~mascara_bloque) !=
+                  (entrada.valC & ~mascara_bloque)) {
+            continue;
+          }
+          accumulate(entrada.plan, probabilidades,
+                     alta | (entrada.valC & mascara_bloque),
+                     entrada.plan.libres_exteriores,
+                     destino + entrada.desplazamiento);
+        }
+      }
+    });
+  });
+  reducePartials(parciales.data(), numero_tramos, longitud_total);
+
+  std::vector<InferenceResult> resultados(lote.size());
+  std::vector<double> salida;
+  for (size_t i = 0; i < lote.size(); ++i) {
+    const BatchEntry& entrada = lote[i];
+    int numero_bits_interes = countBits(entrada.maskI);
+    salida.assign(1ULL << numero_bits_interes, 0.0);
+    if (entrada.grupo >= 0) {
+      // La consulta se resuelve sobre la marginal de su grupo
+      const BatchGroup& grupo = grupos[entrada.grupo];
+      marginalizeCompact(parciales.data() + grupo.desplazamiento,
+                         grupo.variables, entrada.maskC, entrada.valC,
+                         entrada.maskI, salida.data());
+      resultados[i].estados_evaluados =
+          distribucion_conjunta_->getStateSpaceSize();
+    } else if (entrada.factible) {
+      std::memcpy(salida.data(), parciales.data() + entrada.desplazamiento,
+                  salida.size() * sizeof(double));
+      resultados[i].estados_evaluados =
+          1ULL << countBits(mascara_todas & ~entrada.maskC);
+    }
+    reorderInterest(entrada.interes_logico, salida.data());
+    normalizeHistogram(salida.data(), salida.size());
+    resultados[i].distribucion =
+        buildDistribution(salida.data(), numero_bits_interes);
+  }
+
+  auto fin = std::chrono::high_resolution_clock::now();
+  double tiempo =
+      std::chrono::duration<double, std::micro>(fin - inicio).count();
+  for (auto& resultado : resultados) {
+    resultado.tiempo_ejecucion = tiempo;
+  }
+  return resultados;
+}
+
+/**
+ * @brief Función para plegar un bloque de 2^bits probabilidades: en cada
+ *        nivel la mitad superior (los estados con el bit más alto que queda
+ *        a 1) se suma sobre la inferior con el núcleo vectorial, que
+ *        devuelve a la vez la masa de esa mitad. El coste total es 2^(bits-1)
+ *        + 2^(bits-2) + ... < 2^bits sumas, es decir, menos de una suma por
+ *        estado para todas las variables.
+ * @param[in,out] bloque: Probabilidades del bloque (se destruyen)
+ * @param[in] bits: Número de bits del bloque
+ * @param[in,out] sumas: sumas[l] acumula la masa de los estados con el bit
+ *                       l a 1
+ * @param[in] plegar: Núcleo de plegado (SimdReducer::foldFunction)
+ * @return Masa total del bloque
+ */
+static double foldBlock(double* bloque, int bits, double* sumas,
+                        SimdReducer::FoldFunction plegar) {
+  for (int l = bits - 1; l >= 0; --l) {
+    sumas[l] += plegar(bloque, 1ULL << l);
+  }
+  return bloque[0];
+}
+
+/**
+ * @brief Función para plegar un bloque acumulando también las parejas de
+ *        bits: tras sumar la mitad con el bit l a 1 sobre la inferior, esa
+ *        mitad sigue intacta y, plegada sobre los bits inferiores, da la
+ *        masa de cada pareja (l', l). El coste sigue siendo lineal en el
+ *        tamaño del bloque (menos de dos sumas por estado).
+ * @param[in,out] bloque: Probabilidades del bloque (se destruyen)
+ * @param[in] bits: Número de bits del bloque
+ * @param[in,out] sumas: sumas[l] acumula la masa con el bit l a 1
+ * @param[in,out] parejas: parejas[l * bits + l'] (l' < l) acumula la masa
+ *                         con los bits l' y l a 1
+ * @param[in] plegar: Núcleo de plegado (SimdReducer::foldFunction)
+ * @return Masa total del bloque
+ */
+static double foldBlockPairs(double* bloque, int bits, double* sumas,
+                             double* parejas,
+                             SimdReducer::FoldFunction plegar) {
+  for (int l = bits - 1; l >= 0; --l) {
+    uint64_t mitad = 1ULL << l;
+    sumas[l] += plegar(bloque, mitad);
+    foldBlock(bloque + mitad, l, parejas + l * bits, plegar);
+  }
+  return bloque[0];
+}
+
+/**
+ * @brief Método para calcular las marginales a posteriori de todas las
+ *        variables con una sola pasada. Sobre la tabla densa la masa de cada
+ *        variable se acumula por bits plegando bloques del subcubo de la
+ *        evidencia, en lugar de recorrer el subcubo una vez por variable;
+ *        sobre la distribución dispersa se recorre su soporte una vez. Con
+ *        un modelo factorizado se resuelve una consulta por variable (o
+ *        pareja) sobre el árbol de unión, calibrado una sola vez.
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] con_parejas: true para calcular también las parejas
+ * @return Marginales (y parejas) normalizadas por la masa de la evidencia
+ *         (sin normalizar si esa masa es despreciable, y a cero si valC
+ *         fija a 1 alguna variable fuera de maskC). El resultado sobre la
+ *         tabla densa no depende del número de hilos.
+ */
+PosteriorMarginals ConditionalInferenceEngine::computeAllMarginals(
+    uint64_t maskC, uint64_t valC, bool con_parejas) {
+  auto inicio = std::chrono::high_resolution_clock::now();
+  uint64_t mascara_todas = allVariablesMask();
+  int numero_variables = countBits(mascara_todas);
+  PosteriorMarginals resultado;
+  resultado.marginales.assign(numero_variables, 0.0);
+  if (con_parejas) {
+    resultado.parejas.assign(numero_variables * numero_variables, 0.0);
+  }
+  // Como en marginalize, una evidencia con bits fuera de maskC no tiene masa
+  maskC &= mascara_todas;
+  if ((valC & ~maskC) != 0) {
+    resultado.tiempo_ejecucion =
+        std::chrono::duration<double, std::micro>(
+            std::chrono::high_resolution_clock::now() - inicio)
+            .count();
+    return resultado;
+  }
+  auto pareja = [&](int i, int j) -> double& {
+    return resultado.parejas[i * numero_variables + j];
+  };
+  auto observada = [&](int variable) {
+    return static_cast<double>((valC >> variable) & 1ULL);
+  };
+
+  if (modelo_factorizado_) {
+    resultado.estados_evaluados = 0;
+    for (int i = 0; i < numero_variables; ++i) {
+      if (maskC & (1ULL << i)) {
+        resultado.marginales[i] = observada(i);
+        continue;
+      }
+      double histograma[2];
+      computeInto(maskC, valC, 1ULL << i, histograma);
+      resultado.marginales[i] = histograma[1];
+      resultado.estados_evaluados += estados_evaluados_;
+    }
+    for (int i = 0; con_parejas && i < numero_variables; ++i) {
+      pareja(i, i) = resultado.marginales[i];
+      for (int j = i + 1; j < numero_variables; ++j) {
+        double histograma[4];
+        if (maskC & ((1ULL << i) | (1ULL << j))) {
+          histograma[3] = (maskC & (1ULL << i))
+                              ? observada(i) * resultado.marginales[j]
+                              : observada(j) * resultado.marginales[i];
+        } else {
+          computeInto(maskC, valC, (1ULL << i) | (1ULL << j), histograma);
+          resultado.estados_evaluados += estados_evaluados_;
+        }
+        pareja(i, j) = pareja(j, i) = histograma[3];
+      }
+    }
+  } else {
+    // sumas y parejas se indexan por el bit de cada variable en la tabla
+    // recorrida (el bit físico en la tabla densa)
+    std::vector<double> sumas(numero_variables, 0.0);
+    std::vector<double> parejas(
+        con_parejas ? numero_variables * numero_variables : 0, 0.0);
+    std::array<int, 64> bit;
+    double total = 0.0;
+    if (distribucion_conjunta_) {
+      total = accumulateAllMarginals(maskC, valC, con_parejas, sumas.data(),
+                                     parejas.data());
+      for (int i = 0; i < numero_variables; ++i) {
+        bit[i] = std::countr_zero(
+            distribucion_conjunta_->toPhysicalState(1ULL << i));
+      }
+      resultado.estados_evaluados =
+          1ULL << countBits(mascara_todas & ~maskC);
+    } else {
+      const auto& indices = distribucion_dispersa_->getIndices();
+      const auto& valores = distribucion_dispersa_->getValues();
+      for (size_t k = 0; k < indices.size(); ++k) {
+        if ((indices[k] & maskC) != valC) {
+          continue;
+        }
+        double probabilidad = valores[k];
+        total += probabilidad;
+        for (uint64_t resto = indices[k] & ~maskC; resto != 0;
+             resto &= resto - 1) {
+          int i = std::countr_zero(resto);
+          sumas[i] += probabilidad;
+          for (uint64_t otros = resto & (resto - 1); con_parejas && otros;
+               otros &= otros - 1) {
+            parejas[i * numero_variables + std::countr_zero(otros)] +=
+                probabilidad;
+          }
+        }
+      }
+      std::iota(bit.begin(), bit.begin() + numero_variables, 0);
+      resultado.estados_evaluados = indices.size();
+    }
+
+    double divisor = total > 1e-10 ? total : 1.0;
+    for (int i = 0; i < numero_variables; ++i) {
+      resultado.marginales[i] = (maskC & (1ULL << i))
+                                    ? observada(i)
+                                    : sumas[bit[i]] / divisor;
+    }
+    for (int i = 0; con_parejas && i < numero_variables; ++i) {
+      pareja(i, i) = resultado.marginales[i];
+      for (int j = i + 1; j < numero_variables; ++j) {
+        double valor;
+        if (maskC & (1ULL << i)) {
+          valor = observada(i) * resultado.marginales[j];
+        } else if (maskC & (1ULL << j)) {
+          valor = observada(j) * resultado.marginales[i];
+        } else {
+          int menor = std::min(bit[i], bit[j]);
+          int mayor = std::max(bit[i], bit[j]);
+          valor = parejas[menor * numero_variables + mayor] / divisor;
+        }
+        pareja(i, j) = pareja(j, i) = valor;
+      }
+    }
+  }
+
+  resultado.tiempo_ejecucion =
+      std::chrono::duration<double, std::micro>(
+          std::chrono::high_resolution_clock::now() - inicio)
+          .count();
+  return resultado;
+}
+
+/**
+ * @brief Método para acumular la masa de cada variable y de cada pareja de
+ *        variables en el subcubo de la evidencia de la tabla densa. Los
+ *        kBitsBloqueMarginales bits libres más bajos forman bloques que se
+ *        copian y se pliegan (foldBlock); los bits libres restantes son
+ *        constantes en cada bloque, así que reciben la masa del bloque
+ *        entera. Los bloques se reparten en un número de tramos que no
+ *        depende de los hilos y los tramos se suman en orden. Cada tramo
+ *        pliega en su parte de la memoria de trabajo del motor, que solo
+ *        crece.
+ * @param[in] maskC: Máscara lógica de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] con_parejas: true para acumular también las parejas
+ * @param[out] sumas: Masa con cada bit físico a 1 (N posiciones a cero)
+ * @param[out] parejas: Masa con cada pareja de bits físicos p < p' a 1, en
+ *                      parejas[p * N + p'] (N x N posiciones a cero)
+ * @return Masa total del subcubo de la evidencia
+ */
+double ConditionalInferenceEngine::accumulateAllMarginals(
+    uint64_t maskC, uint64_t valC, bool con_parejas, double* sumas,
+    double* parejas) {
+  const BinaryDistribution& distribucion = *distribucion_conjunta_;
+  int numero_variables = distribucion.getNumberVariables();
+  uint64_t base = distribucion.toPhysicalState(valC);
+  uint64_t libres = allVariablesMask() & ~distribucion.toPhysicalState(maskC);
+  int bits_bloque = std::min(countBits(libres), kBitsBloqueMarginales);
+
+  // Los bits libres más bajos forman el bloque que se pliega
+  std::array<int, 64> posicion;
+  uint64_t interior = 0;
+  uint64_t resto = libres;
+  for (int l = 0; l < bits_bloque; ++l) {
+    posicion[l] = std::countr_zero(resto);
+    interior |= resto & -resto;
+    resto &= resto - 1;
+  }
+  uint64_t exterior = libres & ~interior;
+  uint64_t longitud_bloque = 1ULL << bits_bloque;
+  BitExtractor enumerar_interior(interior);
+  BitExtractor enumerar_exterior(exterior);
+  bool contiguo = interior == longitud_bloque - 1;
+  if (!contiguo) {
+    desplazamientos_.resize(longitud_bloque);
+    for (uint64_t m = 0; m < longitud_bloque; ++m) {
+      desplazamientos_[m] = enumerar_interior.deposit(m);
+    }
+  }
+  const uint64_t* desplazamientos = desplazamientos_.data();
+  SimdReducer::FoldFunction plegar = SimdReducer::foldFunction(nucleo_simd_);
+
+  uint64_t bloques = 1ULL << countBits(exterior);
+  uint64_t tramos = std::min(bloques, kMaximoTramosLote);
+  uint64_t bloques_tramo = (bloques + tramos - 1) / tramos;
+  uint64_t tamano_parejas =
+      con_parejas ? numero_variables * numero_variables : 0;
+  uint64_t tamano_parcial = numero_variables + 1 + tamano_parejas;
+  // Memoria de trabajo de cada tramo: bloque, masas locales por bit y por
+  // pareja de bits
+  uint64_t tamano_locales_parejas =
+      con_parejas ? bits_bloque * bits_bloque : 0;
+  uint64_t tamano_trabajo =
+      longitud_bloque + bits_bloque + tamano_locales_parejas;
+  if (parciales_.size() < tramos * tamano_parcial) {
+    parciales_.resize(tramos * tamano_parcial);
+  }
+  if (pliegues_.size() < tramos * tamano_trabajo) {
+    pliegues_.resize(tramos * tamano_trabajo);
+  }
+  std::fill_n(parciales_.begin(), tramos * tamano_parcial, 0.0);
+
+  distribucion.visitProbabilities([&](const auto* tabla) {
+    ParallelExecutor::run(tramos, numero_hilos_, [&](uint64_t tramo) {
+      double* parcial = parciales_.data() + tramo * tamano_parcial;
+      double* parejas_parcial = parcial + numero_variables + 1;
+      double* bloque = pliegues_.data() + tramo * tamano_trabajo;
+      double* locales = bloque + longitud_bloque;
+      double* locales_parejas = locales + bits_bloque;
+      uint64_t primero = tramo * bloques_tramo;
+      uint64_t ultimo = std::min(primero + bloques_tramo, bloques);
+      for (uint64_t b = primero; b < ultimo; ++b) {
+        uint64_t origen = base | enumerar_exterior.deposit(b);
+        if (contiguo) {
+          for (uint64_t m = 0; m < longitud_bloque; ++m) {
+            bloque[m] = static_cast<double>(tabla[origen + m]);
+          }
+        } else {
+          for (uint64_t m = 0; m < longitud_bloque; ++m) {
+            bloque[m] = static_cast<double>(tabla[origen | desplazamientos[m]]);
+          }
+        }
+        std::fill_n(locales, bits_bloque, 0.0);
+        std::fill_n(locales_parejas, tamano_locales_parejas, 0.0);
+        double masa = con_parejas
+                          ? foldBlockPairs(bloque, bits_bloque, locales,
+                                           locales_parejas, plegar)
+                          : foldBlock(bloque, bits_bloque, locales, plegar);
+
+        parcial[numero_variables] += masa;
+        for (int l = 0; l < bits_bloque; ++l) {
+          parcial[posicion[l]] += locales[l];
+        }
+        // Los bits exteriores a 1 lo están en todo el bloque
+        uint64_t fijos = origen & exterior;
+        for (uint64_t resto_fijos = fijos; resto_fijos != 0;
+             resto_fijos &= resto_fijos - 1) {
+          parcial[std::countr_zero(resto_fijos)] += masa;
+        }
+        if (!con_parejas) {
+          continue;
+        }
+        for (int l = 0; l < bits_bloque; ++l) {
+          for (int l2 = l + 1; l2 < bits_bloque; ++l2) {
+            parejas_parcial[posicion[l] * numero_variables + posicion[l2]] +=
+                locales_parejas[l2 * bits_bloque + l];
+          }
+        }
+        for (uint64_t resto_fijos = fijos; resto_fijos != 0;
+             resto_fijos &= resto_fijos - 1) {
+          int p = std::countr_zero(resto_fijos);
+          // Los bits interiores son siempre más bajos que los exteriores
+          for (int l = 0; l < bits_bloque; ++l) {
+            parejas_parcial[posicion[l] * numero_variables + p] += locales[l];
+          }
+          for (uint64_t otros = resto_fijos & (resto_fijos - 1); otros != 0;
+               otros &= otros - 1) {
+            parejas_parcial[p * numero_variables + std::countr_zero(otros)] +=
+                masa;
+          }
+        }
+      }
+    });
+  });
+
+  double total = 0.0;
+  for (uint64_t tramo = 0; tramo < tramos; ++tramo) {
+    const double* parcial = parciales_.data() + tramo * tamano_parcial;
+    for (int p = 0; p < numero_variables; ++p) {
+      sumas[p] += parcial[p];
+    }
+    total += parcial[numero_variables];
+    for (uint64_t k = 0; k < tamano_parejas; ++k) {
+      parejas[k] += parcial[numero_variables + 1 + k];
+    }
+  }
+  return total;
+}
+
+/**
+ * @brief Método para pasar un histograma de interés del orden físico de sus
+ *        variables al orden lógico (no hace nada si ambos coinciden)
+ * @param[in] maskI: Máscara lógica de variables de interés
+ * @param[in,out] salida: Histograma de 2^|I| posiciones
+ */
+void ConditionalInferenceEngine::reorderInterest(uint64_t maskI,
+                                                 double* salida) {
+  if (!distribucion_conjunta_ || distribucion_conjunta_->hasIdentityOrder()) {
+    return;
+  }
+  // La copia física reutiliza la memoria de consultas anteriores
+  reorderCompactedIndex(maskI, distribucion_conjunta_->getPhysicalPositions(),
+                        salida, reordenacion_);
+}
+
+/**
+ * @brief Método para normalizar un histograma para que sume 1 (si su masa no
+ *        es despreciable)
+ * @param[in,out] salida: Histograma a normalizar
+ * @param[in] longitud: Número de posiciones del histograma
+ */
+void ConditionalInferenceEngine::normalizeHistogram(double* salida,
+                                                    uint64_t longitud) const {
+  double suma = 0.0;
+  for (uint64_t i = 0; i < longitud; ++i) {
+    suma += salida[i];
+  }
+  if (suma > 1e-10) {
+    for (uint64_t i = 0; i < longitud; ++i) {
+      salida[i] /= suma;
+    }
+  }
+}
+
+/**
+ * @brief Método para marginalizar sobre una tabla compacta que contiene solo
+ *        un subconjunto de las variables (una vista o la marginal de un grupo
+ *        del lote), trasladando las máscaras de la consulta a las
+ *        coordenadas compactas de la tabla
+ * @param[in] tabla: Marginal P(X_V) indexada por los bits de V compactados
+ * @param[in] variables: Máscara de las variables V de la tabla
+ * @param[in] maskC: Máscara de variables condicionadas (contenida en V)
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] maskI: Máscara de variables de interés (contenida en V)
+ * @param[out] salida: Histograma de 2^|I| posiciones inicializado a cero
+ * @return Número de estados de la tabla recorridos
+ */
+uint64_t ConditionalInferenceEngine::marginalizeCompact(
+    const double* tabla, uint64_t variables, uint64_t maskC, uint64_t valC,
+    uint64_t maskI, double* salida) const {
+  BitExtractor compactar(variables);
+  uint64_t libres =
+      ((1ULL << compactar.getNumberBits()) - 1) & ~compactar.extract(maskC);
+  MarginalizationPlan plan = makePlan(libres, compactar.extract(maskI));
+  accumulate(plan, tabla, compactar.extract(valC), plan.libres_exteriores,
+             salida);
+  return 1ULL << countBits(libres);
+}
+
+/**
+ * @brief Método para construir la distribución resultado a partir de un
+ *        histograma ya normalizado
+ * @param[in] salida: Probabilidades condicionales de los estados de interés
+ * @param[in] numero_bits_interes: Número de variables de interés
+ * @return Distribución binaria sobre las variables de interés
+ */
+std::unique_ptr<BinaryDistribution>
+ConditionalInferenceEngine::buildDistribution(const double* salida,
+                                              int numero_bits_interes) const {
+  auto distribucion =
+      std::make_unique<BinaryDistribution>(numero_bits_interes);
+  distribucion->assignProbabilities(
+      std::span<const double>(salida, 1ULL << numero_bits_interes));
+  return distribucion;
+}
+
 /**
  * @brief Método para verificar si una configuración es consistente con las
  *        condiciones
@@ -114,6 +1378,105 @@ bool ConditionalInferenceEngine::isConsistent(uint64_t estado, uint64_t maskC,
   return (estado & maskC) == valC;
 }
 
+/**
+ * @brief Método para obtener la máscara con todas las variables de la
+ *        distribución conjunta
+ * @return Máscara con los N bits menos significativos a 1
+ */
+uint64_t ConditionalInferenceEngine::allVariablesMask() const {
+  int numero_variables =
+      distribucion_dispersa_ ? distribucion_dispersa_->getNumberVariables()
+      : modelo_factorizado_  ? modelo_factorizado_->getNumberVariables()
+                             : distribucion_conjunta_->getNumberVariables();
+  return numero_variables >= 64 ? ~0ULL : (1ULL << numero_variables) - 1;
+}
+
+/**
+ * @brief Método para obtener la versión de la distribución consultada
+ * @return Contador de modificaciones de la distribución densa, dispersa o
+ *         factorizada
+ */
+uint64_t ConditionalInferenceEngine::distributionVersion() const {
+  return distribucion_dispersa_ ? distribucion_dispersa_->getVersion()
+         : modelo_factorizado_  ? modelo_factorizado_->getVersion()
+                                : distribucion_conjunta_->getVersion();
+}
+
+/**
+ * @brief Método para obtener la distribución consultada
+ * @return Distribución densa, dispersa o modelo factorizado del motor
+ */
+const IDistribution& ConditionalInferenceEngine::distribution() const {
+  if (distribucion_dispersa_) {
+    return *distribucion_dispersa_;
+  }
+  if (modelo_factorizado_) {
+    return *modelo_factorizado_;
+  }
+  return *distribucion_conjunta_;
+}
+
+/**
+ * @brief Método para preparar la tabla de alias de la conjunta (densa o
+ *        dispersa). Se reconstruye solo si la distribución ha cambiado.
+ */
+void ConditionalInferenceEngine::prepareSampler() {
+  if (muestreador_ && muestreador_->getVersion() == distributionVersion()) {
+    return;
+  }
+  try {
+    muestreador_ = distribucion_dispersa_
+                       ? std::make_unique<AliasSampler>(*distribucion_dispersa_)
+                       : std::make_unique<AliasSampler>(*distribucion_conjunta_,
+                                                        numero_hilos_);
+  } catch (const std::invalid_argument&) {
+    // Distribución sin masa: no hay nada que muestrear
+    muestreador_.reset();
+  }
+}
+
+/**
+ * @brief Método para resolver una consulta sobre el árbol de unión: el árbol
+ *        se reconstruye si el modelo ha cambiado y se calibra si la evidencia
+ *        es distinta de la de la consulta anterior. Si ningún clique
+ *        contiene las variables de interés, la consulta se resuelve por
+ *        eliminación de variables.
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] maskI: Máscara de variables de interés
+ * @param[out] salida: Histograma de 2^|I| posiciones
+ */
+void ConditionalInferenceEngine::marginalizeFactorized(uint64_t maskC,
+                                                       uint64_t valC,
+                                                       uint64_t maskI,
+                                                       double* salida) {
+  std::vector<int> condicionadas;
+  std::vector<int> valores;
+  for (uint64_t resto = maskC; resto != 0; resto &= resto - 1) {
+    int variable = std::countr_zero(resto);
+    condicionadas.push_back(variable);
+    valores.push_back((valC >> variable) & 1);
+  }
+  std::vector<int> interes;
+  for (uint64_t resto = maskI; resto != 0; resto &= resto - 1) {
+    interes.push_back(std::countr_zero(resto));
+  }
+
+  if (arbol_->getVersion() != modelo_factorizado_->getVersion()) {
+    arbol_ = std::make_unique<JunctionTree>(*modelo_factorizado_);
+  }
+  estados_evaluados_ = 0;
+  if (!arbol_->isCalibratedFor(condicionadas, valores)) {
+    arbol_->calibrate(condicionadas, valores, numero_hilos_);
+    estados_evaluados_ = arbol_->getCalibrationStates();
+  }
+  if (!arbol_->computeMarginal(interes, salida)) {
+    VariableEliminationEngine eliminacion(*modelo_factorizado_);
+    eliminacion.computePosterior(interes, condicionadas, valores, salida);
+    estados_evaluados_ += eliminacion.getLastStates();
+  }
+}
+
 /**
  * @brief Método para extraer los bits de interés de un estado dado una máscara
  * @param[in] estado: Estado completo
@@ -121,18 +1484,22 @@ bool ConditionalInferenceEngine::isConsistent(uint64_t estado, uint64_t maskC,
  */
 uint64_t ConditionalInferenceEngine::extractInterestBits(uint64_t estado,
                                                           uint64_t maskI) const {
+  if (nucleo_bits_ == BitKernel::kBmi2) {
+    return BitExtractor::extractBmi2(estado, maskI);
+  }
+
+  // Recorremos solo los bits activos de la máscara, del menos significativo
+  // al más significativo
   uint64_t resultado = 0;
   int bit_resultado = 0;
-  
-  for (int bit = 0; bit < 64; ++bit) {
-    if (maskI & (1ULL << bit)) {
-      if (estado & (1ULL << bit)) {
-        resultado |= (1ULL << bit_resultado);
-      }
-      bit_resultado++;
+  while (maskI) {
+    uint64_t bit = maskI & -maskI;
+    if (estado & bit) {
+      resultado |= (1ULL << bit_resultado);
     }
+    bit_resultado++;
+    maskI ^= bit;
   }
-  
   return resultado;
 }
 
@@ -142,10 +1509,5 @@ uint64_t ConditionalInferenceEngine::extractInterestBits(uint64_t estado,
  * @return Número de bits a 1 en la máscara
  */
 int ConditionalInferenceEngine::countBits(uint64_t mascara) const {
-  int cuenta = 0;
-  while (mascara) {
-    cuenta += mascara & 1;
-    mascara >>= 1;
-  }
-  return cuenta;
+  return std::popcount(mascara);
 }
@@ -18,10 +18,21 @@
 
 #include <memory>
 #include <chrono>
+#include <optional>
+#include <span>
 #include <vector>
 
 #include "../distribution/binary_distribution/binary_distribution.h"
+#include "../distribution/sparse_distribution/sparse_distribution.h"
+#include "../distribution/factor_graph/factor_graph.h"
+#include "../junction_tree/junction_tree.h"
+#include "../alias_sampler/alias_sampler.h"
 #include "../conditional_query/conditional_query.h"
+#include "../bit_extractor/bit_extractor.h"
+#include "../simd_reducer/simd_reducer.h"
+#include "../query_cache/query_cache.h"
+#include "../superset_sum_index/superset_sum_index.h"
+#include "../materialized_views/materialized_views.h"
 
 struct InferenceResult {
   //-----------------------------------CONSTRUCTOR----------------------------------
@@ -37,18 +48,155 @@ struct InferenceResult {
   uint64_t estados_evaluados;
 };
 
+/**
+ * @brief Métodos de muestreo de la inferencia aproximada
+ */
+enum class SamplingMethod {
+  /// Muestras de la conjunta; se descartan las que contradicen la evidencia
+  kRejection,
+  /// Muestras uniformes del subcubo consistente con la evidencia, ponderadas
+  /// por su probabilidad (no requiere preparar la conjunta)
+  kLikelihoodWeighting
+};
+
+/**
+ * @brief Parámetros de parada de la inferencia aproximada. El muestreo se
+ *        detiene con el primero de los criterios que se cumpla.
+ */
+struct SamplingOptions {
+  SamplingMethod metodo = SamplingMethod::kLikelihoodWeighting;
+  /// error_maximo: Semiamplitud máxima del intervalo de confianza de cada
+  ///               probabilidad
+  double error_maximo = 0.01;
+  /// confianza: Nivel de confianza de los intervalos, en (0, 1)
+  double confianza = 0.95;
+  /// tiempo_maximo: Presupuesto de tiempo en microsegundos (0: sin límite)
+  double tiempo_maximo = 0.0;
+  /// muestras_maximas: Número máximo de muestras generadas
+  uint64_t muestras_maximas = 1ULL << 26;
+  /// semilla: Semilla de los flujos aleatorios
+  uint64_t semilla = 0;
+};
+
+struct ApproximateInferenceResult {
+  /// distribucion: Estimación de la distribución condicional
+  std::unique_ptr<BinaryDistribution> distribucion;
+  /// semiamplitudes: Semiamplitud del intervalo de confianza de cada
+  ///                 probabilidad estimada
+  std::vector<double> semiamplitudes;
+  /// tiempo_ejecucion: Tiempo de ejecución en microsegundos
+  double tiempo_ejecucion = 0.0;
+  /// muestras: Número de muestras generadas (incluidas las rechazadas)
+  uint64_t muestras = 0;
+  /// tamano_efectivo: Tamaño muestral efectivo (Σw)² / Σw²
+  double tamano_efectivo = 0.0;
+  /// convergido: true si se alcanzó error_maximo antes que los límites
+  bool convergido = false;
+};
+
+/**
+ * @brief Estructura con las marginales a posteriori de todas las variables
+ *        dada una evidencia
+ */
+struct PosteriorMarginals {
+  /// marginales: P(X_i = 1 | X_C = c) de cada variable i (las variables
+  ///             condicionadas toman su valor observado)
+  std::vector<double> marginales;
+  /// parejas: P(X_i = 1, X_j = 1 | X_C = c) en una matriz N x N por filas,
+  ///          simétrica y con las marginales en la diagonal (vacía si no se
+  ///          piden las parejas)
+  std::vector<double> parejas;
+  /// tiempo_ejecucion: Tiempo de ejecución en microsegundos
+  double tiempo_ejecucion = 0.0;
+  /// estados_evaluados: Número de estados recorridos
+  uint64_t estados_evaluados = 0;
+};
+
 class ConditionalInferenceEngine {
  public:
   //-------------------------CONSTRUCTOR-------------------------
-  explicit ConditionalInferenceEngine(const BinaryDistribution&);
+  explicit ConditionalInferenceEngine(const BinaryDistribution&, int = 1);
+  explicit ConditionalInferenceEngine(const SparseDistribution&, int = 1);
+  explicit ConditionalInferenceEngine(const FactorGraph&, int = 1);
 
   //-------------------------MÉTODOS-------------------------
   /// Método principal para calcular la distribución condicional P(X_I | X_C = c)
   InferenceResult computeConditional(const ConditionalQuery&);
+  /// Método para calcular un lote de consultas con una sola pasada sobre la
+  /// distribución conjunta
+  std::vector<InferenceResult> computeConditionalBatch(
+      std::span<const ConditionalQuery>);
+  /// Métodos para calcular P(X_I | X_C = c) sin reservar memoria: en un
+  /// búfer del llamador o en la memoria de resultados del motor (la vista
+  /// es válida hasta la siguiente consulta)
+  std::span<const double> computeConditionalInto(const ConditionalQuery&,
+                                                 std::span<double>);
+  std::span<const double> computeConditionalView(const ConditionalQuery&);
   /// Método para calcular la distribución condicional P(X_I | X_C = c) usando marginalización
   double* prob_cond_bin(uint64_t, uint64_t, uint64_t);
+  /// Método para calcular P(X_i = 1 | X_C = c) de todas las variables (y, si
+  /// se pide, P(X_i = 1, X_j = 1 | X_C = c) de todas las parejas) con una
+  /// sola pasada sobre el subcubo de la evidencia
+  PosteriorMarginals computeAllMarginals(uint64_t, uint64_t, bool = false);
+  /// Método para estimar P(X_I | X_C = c) por muestreo, con intervalos de
+  /// confianza
+  ApproximateInferenceResult computeConditionalApproximate(
+      const ConditionalQuery&, const SamplingOptions& = {});
+  /// Método para consultar el núcleo de bits elegido al construir el motor
+  BitKernel getBitKernel() const { return nucleo_bits_; }
+  /// Método para forzar un núcleo de bits concreto (pruebas y comparativas)
+  void setBitKernel(BitKernel);
+  /// Métodos para consultar y forzar el núcleo de reducción vectorial
+  SimdKernel getSimdKernel() const { return nucleo_simd_; }
+  void setSimdKernel(SimdKernel);
+  /// Métodos para consultar y establecer el número de hilos de la
+  /// marginalización (el resultado no depende de este valor)
+  int getNumberThreads() const { return numero_hilos_; }
+  void setNumberThreads(int);
+  /// Métodos para configurar la caché de resultados (capacidad en número de
+  /// probabilidades almacenadas; 0 la desactiva) y consultar sus contadores
+  void setCacheCapacity(uint64_t capacidad) { cache_.setCapacity(capacidad); }
+  const CacheStatistics& getCacheStatistics() const {
+    return cache_.getStatistics();
+  }
+  /// Método para asociar un índice de sumas sobre superconjuntos (nullptr lo
+  /// desasocia). Solo se usa si se construyó a partir de esta misma
+  /// distribución en su versión actual y su coste estimado es menor que el
+  /// del recorrido.
+  void setSupersetSumIndex(std::shared_ptr<const SupersetSumIndex> indice) {
+    indice_superconjuntos_ = std::move(indice);
+  }
+  /// Método para asociar un conjunto de vistas materializadas (nullptr lo
+  /// desasocia). Solo se usan si se calcularon a partir de esta misma
+  /// distribución en su versión actual; si no, hay que refrescarlas.
+  void setMaterializedViews(std::shared_ptr<const MaterializedViews> vistas) {
+    vistas_ = std::move(vistas);
+  }
 
  protected:
+  /**
+   * @brief Estructura con la preparación de la marginalización de una
+   *        consulta: tramo contiguo de bits bajos y núcleos a utilizar
+   */
+  struct MarginalizationPlan {
+    /// maskI: Máscara de variables de interés
+    uint64_t maskI;
+    /// estados_interes: Tamaño del histograma de interés (2^|I|)
+    uint64_t estados_interes;
+    /// libres_exteriores: Bits libres a enumerar fuera del tramo contiguo
+    uint64_t libres_exteriores;
+    /// longitud_bloque: Longitud del tramo contiguo de bits bajos
+    ///                  marginalizados que se reduce vectorialmente
+    uint64_t longitud_bloque;
+    /// sumar: Función de reducción de tramos contiguos
+    SimdReducer::SumFunction sumar;
+    /// sumar_float, sumar_bfloat16: Ídem para tablas float y bfloat16
+    SimdReducer::SumFunctionFloat sumar_float;
+    SimdReducer::SumFunctionBfloat16 sumar_bfloat16;
+    /// extractor: Tablas de extracción (solo con el núcleo software)
+    std::optional<BitExtractor> extractor;
+  };
+
   //-----------------MÉTODOS PROTEGIDOS-----------------
   /// Método para verificar si una configuración es consistente con las condiciones
   bool isConsistent(uint64_t, uint64_t, uint64_t) const;
@@ -56,10 +204,134 @@ class ConditionalInferenceEngine {
   uint64_t extractInterestBits(uint64_t, uint64_t) const;
   /// Método para contar el número de bits activos en una máscara
   int countBits(uint64_t) const;
+  /// Método para obtener la máscara con todas las variables de la distribución
+  uint64_t allVariablesMask() const;
+  /// Método para obtener la versión de la distribución consultada
+  uint64_t distributionVersion() const;
+  /// Método para resolver una consulta sobre el árbol de unión del modelo
+  /// factorizado
+  void marginalizeFactorized(uint64_t, uint64_t, uint64_t, double*);
+  /// Método para obtener la distribución consultada, sea cual sea su tipo
+  const IDistribution& distribution() const;
+  /// Método para preparar la tabla de alias de la conjunta
+  void prepareSampler();
+  /// Método para calcular la distribución condicional en un búfer
+  void computeInto(uint64_t, uint64_t, uint64_t, double*);
+  /// Método para acumular la masa sin normalizar de cada estado de interés
+  void marginalize(uint64_t, uint64_t, uint64_t, double*);
+  void marginalizeTable(uint64_t, uint64_t, uint64_t, double*);
+  void reorderInterest(uint64_t, double*);
+  /// Método para elegir los bits libres que dividen el subcubo en bloques
+  uint64_t partitionBits(uint64_t, int, uint64_t) const;
+  /// Método para preparar la marginalización de una consulta
+  MarginalizationPlan makePlan(uint64_t, uint64_t) const;
+  /// Método para acumular la masa de un subcubo según el plan de una consulta
+  template <class Valor>
+  void accumulate(const MarginalizationPlan&, const Valor*, uint64_t,
+                  uint64_t, double*) const;
+  /// Método para acumular por bits la masa de cada variable y de cada pareja
+  /// de variables en el subcubo de la evidencia de la tabla densa
+  double accumulateAllMarginals(uint64_t, uint64_t, bool, double*, double*);
+  /// Método para combinar histogramas parciales con una reducción en árbol
+  void reducePartials(double*, uint64_t, uint64_t) const;
+  /// Método para normalizar un histograma para que sume 1
+  void normalizeHistogram(double*, uint64_t) const;
+  /// Método para marginalizar sobre una tabla compacta de un subconjunto de
+  /// variables (vistas y marginales de grupo)
+  uint64_t marginalizeCompact(const double*, uint64_t, uint64_t, uint64_t,
+                              uint64_t, double*) const;
+  /// Método para construir la distribución resultado de un histograma
+  std::unique_ptr<BinaryDistribution> buildDistribution(const double*,
+                                                        int) const;
 
  private:
-  //-----------------ATRIBUTO-----------------
-  /// distribucion_conjunta_: Referencia a la distribución conjunta sobre la
-  ///                         que se realizarán las inferencias
-  const BinaryDistribution& distribucion_conjunta_;
+  //-----------------CONSTANTES-----------------
+  /// kBitsMinimosPorBloque: Cada bloque paralelo recorre al menos 2^14 estados
+  static constexpr int kBitsMinimosPorBloque = 14;
+  /// kBitsMaximosParticion: Como máximo se generan 2^6 = 64 bloques
+  static constexpr int kBitsMaximosParticion = 6;
+  /// kMaximoEstadosParciales: Límite de posiciones entre todos los
+  ///                          histogramas parciales (32 MB de doubles)
+  static constexpr uint64_t kMaximoEstadosParciales = 1ULL << 22;
+  /// kMinimoEstadosReduccionParalela: Tamaño de histograma a partir del cual
+  ///                                  la reducción también se reparte
+  static constexpr uint64_t kMinimoEstadosReduccionParalela = 1ULL << 16;
+  /// kBitsMinimosBloqueContiguo: Los tramos contiguos de bits marginalizados
+  ///                             se reducen vectorialmente a partir de 2^3
+  static constexpr int kBitsMinimosBloqueContiguo = 3;
+  /// kBitsBloqueLote: Los lotes recorren la tabla en bloques de 2^15 estados
+  ///                  (256 KB de doubles, residentes en caché)
+  static constexpr int kBitsBloqueLote = 15;
+  /// kMaximoTramosLote: Número máximo de tramos paralelos de un lote
+  static constexpr uint64_t kMaximoTramosLote = 64;
+  /// kBitsMaximosGrupo: Las marginales de grupo de un lote tienen a lo sumo
+  ///                    2^14 estados (128 KB de doubles)
+  static constexpr int kBitsMaximosGrupo = 14;
+  /// kMaximoEvidenciaGrupo: Las consultas con más variables condicionadas
+  ///                        recorren su subcubo directamente, porque es al
+  ///                        menos 8 veces menor que la tabla completa
+  static constexpr int kMaximoEvidenciaGrupo = 2;
+  /// kBitsBloqueMarginales: Las marginales de todas las variables se
+  ///                        acumulan plegando bloques de 2^12 estados
+  ///                        (32 KB de doubles)
+  static constexpr int kBitsBloqueMarginales = 12;
+  /// kMuestrasPorLote: Muestras de cada tarea del muestreo aproximado (cada
+  ///                   lote usa su propio flujo aleatorio)
+  static constexpr uint64_t kMuestrasPorLote = 1024;
+  /// kLotesPorRonda: Lotes entre comprobaciones de los criterios de parada
+  static constexpr uint64_t kLotesPorRonda = 64;
+  /// kTamanoEfectivoMinimo: Tamaño muestral efectivo mínimo para dar por
+  ///                        buenos los intervalos de confianza
+  static constexpr double kTamanoEfectivoMinimo = 100.0;
+
+  //-----------------ATRIBUTOS-----------------
+  /// distribucion_conjunta_: Distribución conjunta densa sobre la que se
+  ///                         realizarán las inferencias (nullptr si el motor
+  ///                         trabaja sobre otro tipo de distribución)
+  const BinaryDistribution* distribucion_conjunta_;
+  /// distribucion_dispersa_: Distribución conjunta dispersa (nullptr si el
+  ///                         motor trabaja sobre otro tipo de distribución)
+  const SparseDistribution* distribucion_dispersa_;
+  /// modelo_factorizado_: Modelo factorizado (nullptr si el motor trabaja
+  ///                      sobre otro tipo de distribución)
+  const FactorGraph* modelo_factorizado_;
+  /// arbol_: Árbol de unión del modelo factorizado, calibrado con la
+  ///         evidencia de la última consulta
+  std::unique_ptr<JunctionTree> arbol_;
+  /// nucleo_bits_: Núcleo de extracción de bits (BMI2 o tablas) detectado
+  ///               por CPUID al construir el motor
+  BitKernel nucleo_bits_;
+  /// nucleo_simd_: Núcleo de reducción vectorial (AVX-512, AVX2 o escalar)
+  ///               detectado por CPUID al construir el motor
+  SimdKernel nucleo_simd_;
+  /// numero_hilos_: Número de hilos usados en la marginalización
+  int numero_hilos_;
+  /// cache_: Caché LRU de resultados de prob_cond_bin
+  QueryCache cache_;
+  /// version_cache_: Versión de la distribución a la que corresponde la
+  ///                 caché
+  uint64_t version_cache_;
+  /// indice_superconjuntos_: Índice opcional de sumas sobre superconjuntos
+  std::shared_ptr<const SupersetSumIndex> indice_superconjuntos_;
+  /// vistas_: Vistas materializadas opcionales
+  std::shared_ptr<const MaterializedViews> vistas_;
+  /// estados_evaluados_: Número de estados visitados en la última llamada a
+  ///                     prob_cond_bin
+  uint64_t estados_evaluados_;
+  /// resultado_: Memoria de resultados de computeConditionalView
+  std::vector<double> resultado_;
+  /// parciales_: Histogramas parciales de la marginalización por bloques (y
+  ///             subcubo de trabajo del índice de superconjuntos)
+  std::vector<double> parciales_;
+  /// reordenacion_: Copia física del histograma al pasarlo a orden lógico
+  std::vector<double> reordenacion_;
+  /// pliegues_: Bloques y masas locales de cada tramo de
+  ///            accumulateAllMarginals
+  std::vector<double> pliegues_;
+  /// desplazamientos_: Desplazamiento de cada estado de un bloque no
+  ///                   contiguo de accumulateAllMarginals
+  std::vector<uint64_t> desplazamientos_;
+  /// muestreador_: Tabla de alias de la conjunta para el muestreo por
+  ///               rechazo (nullptr si la distribución no tiene masa)
+  std::unique_ptr<AliasSampler> muestreador_;
 };
\ No newline at end of file
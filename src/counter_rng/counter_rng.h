@@ -0,0 +1,60 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   counter_rng.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase CounterRng, generador pseudoaleatorio
+ *         basado en contador (SplitMix64) con flujos independientes.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Clase que genera números pseudoaleatorios como función de una
+ *        semilla, un flujo y un contador: el valor k-ésimo del flujo f es
+ *        mix(clave(semilla, f) + k·γ), con la función de mezcla de
+ *        SplitMix64. No hay estado compartido, de modo que cada tarea de un
+ *        reparto entre hilos usa su propio flujo y el resultado no depende
+ *        del número de hilos ni del orden de ejecución.
+ */
+class CounterRng {
+ public:
+  //-------------------------CONSTRUCTOR-------------------------
+  CounterRng(uint64_t semilla, uint64_t flujo)
+      : clave_(mix(semilla ^ mix(flujo + kIncremento))), contador_(0) {}
+
+  //-------------------------MÉTODOS-------------------------
+  /// Siguiente valor de 64 bits del flujo
+  uint64_t next() { return mix(clave_ + contador_++ * kIncremento); }
+  /// Siguiente valor uniforme en [0, 1) con 53 bits de precisión
+  double nextDouble() { return (next() >> 11) * 0x1.0p-53; }
+  /// Valor uniforme de 64 bits asociado a un índice, sin estado
+  static uint64_t at(uint64_t semilla, uint64_t indice) {
+    return mix(mix(semilla) + indice * kIncremento);
+  }
+  /// Función de mezcla (finalizador de SplitMix64), biyectiva en 64 bits
+  static uint64_t mix(uint64_t valor) {
+    valor = (valor ^ (valor >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    valor = (valor ^ (valor >> 27)) * 0x94d049bb133111ebULL;
+    return valor ^ (valor >> 31);
+  }
+
+ private:
+  //-----------------CONSTANTES-----------------
+  /// kIncremento: Constante de Weyl de SplitMix64 (2^64 / φ, impar)
+  static constexpr uint64_t kIncremento = 0x9e3779b97f4a7c15ULL;
+
+  //-----------------ATRIBUTOS-----------------
+  /// clave_: Desplazamiento del flujo dentro de la secuencia de Weyl
+  uint64_t clave_;
+  /// contador_: Número de valores generados en el flujo
+  uint64_t contador_;
+};
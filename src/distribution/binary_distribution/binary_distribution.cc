@@ -20,35 +20,103 @@
 #include <iomanip>
 #include <fstream>
 #include <cmath>
+#include <cstring>
+#include <array>
+#include <charconv>
+#include <bit>
+#include <numeric>
+#include <numbers>
+#include <type_traits>
+#include <atomic>
 
 #include "binary_distribution.h"
+#include "binary_file_format.h"
+#include "csv_file_format.h"
+#include "../../bit_extractor/bit_extractor.h"
+#include "../../counter_rng/counter_rng.h"
+#include "../../parallel_executor/parallel_executor.h"
 
 /**
  * @brief Constructor que inicializa la distribución con un número dado de
  *        variables
  * @param[in] numero_variables: Número de variables binarias (N)
+ * @param[in] tipo: Tipo de almacenamiento de la tabla
  * @throws std::invalid_argument si el número de variables es menor o igual a 0
  *         o mayor a 64
  */
-BinaryDistribution::BinaryDistribution(int numero_variables)
-    : numero_variables_(numero_variables) {
+BinaryDistribution::BinaryDistribution(int numero_variables, StorageType tipo)
+    : numero_variables_(numero_variables), tipo_almacenamiento_(tipo) {
   if (numero_variables <= 0 || numero_variables > 64) {
     throw std::invalid_argument(
         "Error: El número de variables debe estar entre 1 y 64");
   }
     
   tamano_espacio_estados_ = 1ULL << numero_variables_;
-  probabilidades_.resize(tamano_espacio_estados_, 0.0);
+  allocateTable();
+  resetVariableOrder();
 }
 
 /**
  * @brief Constructor que carga la distribución desde un archivo CSV
  * @param[in] nombre_archivo: Ruta del archivo CSV
+ * @param[in] tipo: Tipo de almacenamiento de la tabla
+ * @param[in] numero_hilos: Número de hilos para analizar el archivo
  * @throws std::runtime_error si hay errores al leer el archivo o al parsear
  *         su contenido
  */
-BinaryDistribution::BinaryDistribution(const std::string& nombre_archivo) {
-  loadFromCSV(nombre_archivo);
+BinaryDistribution::BinaryDistribution(const std::string& nombre_archivo,
+                                       StorageType tipo, int numero_hilos)
+    : tipo_almacenamiento_(tipo) {
+  loadFromCSV(nombre_archivo, numero_hilos);
+}
+
+/**
+ * @brief Constructor que carga la distribución desde un archivo en el formato
+ *        indicado. Un archivo binario se proyecta en memoria en O(1): no se
+ *        lee ni se verifica la tabla (ver verifyChecksum).
+ * @param[in] nombre_archivo: Ruta del archivo
+ * @param[in] formato: Formato del archivo (CSV se carga en double)
+ * @throws std::runtime_error si hay errores al leer el archivo o su cabecera
+ */
+BinaryDistribution::BinaryDistribution(const std::string& nombre_archivo,
+                                       FileFormat formato) {
+  if (formato == FileFormat::kBinary) {
+    mapBinary(nombre_archivo);
+  } else {
+    loadFromCSV(nombre_archivo, 1);
+  }
+}
+
+/**
+ * @brief Método para obtener la tabla de probabilidades en orden físico
+ * @return Vista de la tabla
+ * @throws std::runtime_error si la tabla no se almacena en double (usar
+ *         visitProbabilities)
+ */
+std::span<const double> BinaryDistribution::getProbabilities() const {
+  if (tipo_almacenamiento_ != StorageType::kDouble) {
+    throw std::runtime_error(
+        "Error: La distribución no se almacena en double");
+  }
+  return {visitProbabilities([](const auto* tabla) {
+            return reinterpret_cast<const double*>(tabla);
+          }),
+          tamano_espacio_estados_};
+}
+
+/**
+ * @brief Método que reserva la tabla del tipo de almacenamiento en uso con
+ *        todas las probabilidades a cero
+ */
+void BinaryDistribution::allocateTable() {
+  archivo_mapeado_.reset();
+  datos_mapeados_ = nullptr;
+  probabilidades_ = std::vector<double>();
+  probabilidades_simples_ = std::vector<float>();
+  probabilidades_bfloat16_ = std::vector<Bfloat16>();
+  visitTable([this](auto& tabla) {
+    tabla.resize(tamano_espacio_estados_);
+  });
 }
 
 /**
@@ -61,7 +129,10 @@ double BinaryDistribution::getProbability(uint64_t indice) const {
   if (indice >= tamano_espacio_estados_) {
     throw std::out_of_range("Error: Índice fuera de rango");
   }
-  return probabilidades_[indice];
+  uint64_t fisico = toPhysicalState(indice);
+  return visitProbabilities([fisico](const auto* tabla) -> double {
+    return tabla[fisico];
+  });
 }
 
 /**
@@ -79,23 +150,54 @@ void BinaryDistribution::setProbability(uint64_t indice, double probabilidad) {
     throw std::invalid_argument(
         "Error: La probabilidad debe estar entre 0 y 1");
   }
-  probabilidades_[indice] = probabilidad;
+  uint64_t fisico = toPhysicalState(indice);
+  visitTable([&](auto& tabla) {
+    using Valor = typename std::remove_reference_t<decltype(tabla)>::value_type;
+    tabla[fisico] = Valor(probabilidad);
+  });
+  version_++;
+}
+
+/**
+ * @brief Método para asignar la tabla completa en orden lógico de una sola
+ *        vez, sin comprobar cada probabilidad
+ * @param[in] probabilidades: Probabilidad de cada estado lógico
+ * @throws std::invalid_argument si no contiene 2^N probabilidades
+ */
+void BinaryDistribution::assignProbabilities(
+    std::span<const double> probabilidades) {
+  if (probabilidades.size() != tamano_espacio_estados_) {
+    throw std::invalid_argument(
+        "Error: Se esperaban 2^N probabilidades");
+  }
+  visitTable([&](auto& tabla) {
+    using Valor = typename std::remove_reference_t<decltype(tabla)>::value_type;
+    for (uint64_t i = 0; i < tamano_espacio_estados_; ++i) {
+      tabla[toPhysicalState(i)] = Valor(probabilidades[i]);
+    }
+  });
+  version_++;
 }
 
 /**
  * @brief Método para validar que la distribución esté correctamente normalizada
- * @return true si la suma de las probabilidades es 1 (dentro de una tolerancia),
- *         false en caso contrario
+ * @return true si la suma de las probabilidades es 1 (dentro de una tolerancia
+ *         que incluye el error de redondeo del almacenamiento), false en caso
+ *         contrario
  */
 bool BinaryDistribution::isValid() const {
-  double suma = 0.0;
-  for (double probabilidad : probabilidades_) {
-    if (probabilidad < -EPSILON || probabilidad > 1.0 + EPSILON) {
-      return false;
-    }
-    suma += probabilidad;
-  }
-  return std::abs(suma - 1.0) < EPSILON;
+  return isValid(1);
+}
+
+/**
+ * @brief Método para validar la distribución resumiendo la tabla en paralelo
+ * @param[in] numero_hilos: Número de hilos que resumen los bloques
+ * @return true si todas las probabilidades están en [0, 1] y suman 1 (dentro
+ *         de la tolerancia del almacenamiento), false en caso contrario. El
+ *         resultado no depende del número de hilos
+ */
+bool BinaryDistribution::isValid(int numero_hilos) const {
+  return isValidSummary(summarizeTable(numero_hilos));
 }
 
 /**
@@ -104,19 +206,123 @@ bool BinaryDistribution::isValid() const {
  *         (no se puede normalizar)
  */
 void BinaryDistribution::normalize() {
-  double suma = 0.0;
-  for (double probabilidad : probabilidades_) {
-    suma += probabilidad;
+  normalize(1);
+}
+
+/**
+ * @brief Método para normalizar la distribución en paralelo: una pasada
+ *        vectorial calcula la suma y otra divide cada bloque entre ella
+ * @param[in] numero_hilos: Número de hilos que procesan los bloques
+ * @throws std::runtime_error si la suma de las probabilidades es cero
+ *         (no se puede normalizar)
+ */
+void BinaryDistribution::normalize(int numero_hilos) {
+  rescaleTable(summarizeTable(numero_hilos).suma, numero_hilos);
+}
+
+/**
+ * @brief Método para validar y, solo si hace falta, normalizar la
+ *        distribución. La validación y la suma que necesita la normalización
+ *        salen de la misma pasada, así que una tabla ya válida se lee una
+ *        sola vez (y una tabla proyectada no se copia a memoria propia)
+ * @param[in] numero_hilos: Número de hilos que procesan los bloques
+ * @return true si la distribución no era válida y se ha normalizado
+ * @throws std::runtime_error si hace falta normalizar y la suma de las
+ *         probabilidades es cero
+ */
+bool BinaryDistribution::normalizeIfInvalid(int numero_hilos) {
+  BlockSummary resumen = summarizeTable(numero_hilos);
+  if (isValidSummary(resumen)) {
+    return false;
   }
-  
-  if (suma < EPSILON) {
+  rescaleTable(resumen.suma, numero_hilos);
+  return true;
+}
+
+/**
+ * @brief Método para calcular en una sola pasada la suma y el rango de la
+ *        tabla. Cada bloque de tamaño fijo se resume con el núcleo vectorial
+ *        y los resúmenes se combinan por parejas en un árbol de forma fija,
+ *        de modo que la suma es la misma con cualquier número de hilos
+ * @param[in] numero_hilos: Número de hilos que resumen los bloques
+ * @return Suma, mínimo y máximo de las probabilidades
+ */
+BlockSummary BinaryDistribution::summarizeTable(int numero_hilos) const {
+  static const SimdKernel nucleo = SimdReducer::detectKernel();
+  uint64_t bloques = (tamano_espacio_estados_ + kEstadosBloqueResumen - 1) /
+                     kEstadosBloqueResumen;
+  std::vector<BlockSummary> resumenes(bloques);
+  visitProbabilities([&](const auto* tabla) {
+    using Valor = std::remove_cv_t<std::remove_pointer_t<decltype(tabla)>>;
+    auto resumir = [] {
+      if constexpr (std::is_same_v<Valor, float>) {
+        return SimdReducer::summaryFunctionFloat(nucleo);
+      } else if constexpr (std::is_same_v<Valor, Bfloat16>) {
+        return SimdReducer::summaryFunctionBfloat16(nucleo);
+      } else {
+        return SimdReducer::summaryFunction(nucleo);
+      }
+    }();
+    ParallelExecutor::run(bloques, numero_hilos, [&](uint64_t bloque) {
+      uint64_t inicio = bloque * kEstadosBloqueResumen;
+      resumenes[bloque] = resumir(
+          tabla + inicio,
+          std::min(kEstadosBloqueResumen, tamano_espacio_estados_ - inicio));
+    });
+  });
+
+  for (uint64_t paso = 1; paso < bloques; paso *= 2) {
+    for (uint64_t i = 0; i + paso < bloques; i += 2 * paso) {
+      const BlockSummary& otro = resumenes[i + paso];
+      resumenes[i].suma += otro.suma;
+      resumenes[i].minimo = std::min(resumenes[i].minimo, otro.minimo);
+      resumenes[i].maximo = std::max(resumenes[i].maximo, otro.maximo);
+    }
+  }
+  return resumenes[0];
+}
+
+/**
+ * @brief Método para decidir si un resumen de la tabla corresponde a una
+ *        distribución válida
+ * @param[in] resumen: Suma y rango de las probabilidades
+ * @return true si el rango está en [0, 1] y la suma es 1 (dentro de la
+ *         tolerancia del almacenamiento); false también si la suma es NaN
+ */
+bool BinaryDistribution::isValidSummary(const BlockSummary& resumen) const {
+  double tolerancia =
+      std::max(EPSILON, storageRelativeError(tipo_almacenamiento_));
+  return resumen.minimo >= -EPSILON && resumen.maximo <= 1.0 + EPSILON &&
+         std::abs(resumen.suma - 1.0) < tolerancia;
+}
+
+/**
+ * @brief Método para dividir en paralelo todas las probabilidades entre su
+ *        suma
+ * @param[in] suma: Suma de las probabilidades de la tabla
+ * @param[in] numero_hilos: Número de hilos que procesan los bloques
+ * @throws std::runtime_error si la suma es cero (o no es un número)
+ */
+void BinaryDistribution::rescaleTable(double suma, int numero_hilos) {
+  if (!(suma >= EPSILON)) {
     throw std::runtime_error(
         "Error: No se puede normalizar, la suma de probabilidades es cero");
   }
-  
-  for (double& probabilidad : probabilidades_) {
-    probabilidad /= suma;
-  }
+  uint64_t bloques = (tamano_espacio_estados_ + kEstadosBloqueResumen - 1) /
+                     kEstadosBloqueResumen;
+  visitTable([&](auto& tabla) {
+    using Valor = typename std::remove_reference_t<decltype(tabla)>::value_type;
+    ParallelExecutor::run(bloques, numero_hilos, [&](uint64_t bloque) {
+      uint64_t inicio = bloque * kEstadosBloqueResumen;
+      uint64_t fin =
+          std::min(inicio + kEstadosBloqueResumen, tamano_espacio_estados_);
+      Valor* datos = tabla.data();
+      for (uint64_t i = inicio; i < fin; ++i) {
+        datos[i] = Valor(static_cast<double>(datos[i]) / suma);
+      }
+    });
+  });
+  version_++;
 }
 
 /**
@@ -136,21 +342,22 @@ void BinaryDistribution::display() const {
             << std::endl;
   
   for (uint64_t i = 0; i < tamano_espacio_estados_; ++i) {
-    if (probabilidades_[i] > EPSILON) {
+    double probabilidad = getProbability(i);
+    if (probabilidad > EPSILON) {
       std::string binario = indexToBinary(i);
       std::cout << std::setw(8) << binario << " |";
       for (char bit : binario) {
         std::cout << "  " << bit;
       }
-      std::cout << " | " << std::setw(10) << probabilidades_[i] << std::endl;
+      std::cout << " | " << std::setw(10) << probabilidad << std::endl;
     }
   }
   std::cout << std::endl;
 
-  std::cout << "Suma total de probabilidades: "
-            << std::accumulate(probabilidades_.begin(), probabilidades_.end(),
-                               0.0)
-            << std::endl;
+  double suma = visitProbabilities([this](const auto* tabla) {
+    return std::accumulate(tabla, tabla + tamano_espacio_estados_, 0.0);
+  });
+  std::cout << "Suma total de probabilidades: " << suma << std::endl;
 }
 
 /**
@@ -160,32 +367,228 @@ void BinaryDistribution::display() const {
  */
 void BinaryDistribution::exportToCSV(
     const std::string& nombre_archivo) const {
-  std::ofstream archivo(nombre_archivo);
+  exportToCSV(nombre_archivo, 1);
+}
+
+/**
+ * @brief Método para exportar la distribución a un archivo CSV. Los estados
+ *        se formatean en bloques sobre búferes reutilizables (los bits con
+ *        una tabla por byte y la probabilidad con std::to_chars); en cada
+ *        ronda varios hilos formatean un bloque cada uno y los búferes se
+ *        escriben en orden. La salida es idéntica a la de un solo hilo.
+ * @param[in] nombre_archivo: Ruta del archivo CSV de salida
+ * @param[in] numero_hilos: Número de hilos que formatean bloques
+ * @throws std::runtime_error si no se puede abrir o escribir el archivo, o
+ *         si alguna probabilidad no cabe en kMaximoCaracteresValor
+ */
+void BinaryDistribution::exportToCSV(const std::string& nombre_archivo,
+                                     int numero_hilos) const {
+  std::ofstream archivo(nombre_archivo, std::ios::binary);
   if (!archivo.is_open()) {
     throw std::runtime_error("Error: No se puede abrir el archivo " +
                              nombre_archivo);
   }
-  
-  archivo << std::fixed << std::setprecision(10);
-  for (uint64_t i = 0; i < tamano_espacio_estados_; ++i) {
-    archivo << indexToBinary(i) << "," << probabilidades_[i] << std::endl;
+
+  uint64_t estados_bloque =
+      std::min(tamano_espacio_estados_, kEstadosBloqueExportacion);
+  uint64_t numero_bloques = tamano_espacio_estados_ / estados_bloque;
+  uint64_t bloques_ronda =
+      std::min<uint64_t>(std::max(numero_hilos, 1), numero_bloques);
+  // Línea: N bits, coma, "d.dddddddddd" (o más dígitos enteros) y salto
+  uint64_t bytes_linea = numero_variables_ + 2 + kMaximoCaracteresValor;
+  std::vector<std::string> buferes(bloques_ronda,
+                                   std::string(estados_bloque * bytes_linea,
+                                               '\0'));
+  std::vector<uint64_t> longitudes(bloques_ronda);
+
+  visitProbabilities([&](const auto* tabla) {
+    for (uint64_t ronda = 0; ronda < numero_bloques; ronda += bloques_ronda) {
+      uint64_t bloques = std::min(bloques_ronda, numero_bloques - ronda);
+      ParallelExecutor::run(bloques, numero_hilos, [&](uint64_t j) {
+        char* cursor = buferes[j].data();
+        uint64_t primero = (ronda + j) * estados_bloque;
+        for (uint64_t i = primero; i < primero + estados_bloque; ++i) {
+          writeBinaryDigits(i, numero_variables_, cursor);
+          cursor += numero_variables_;
+          *cursor++ = ',';
+          double probabilidad = tabla[toPhysicalState(i)];
+          auto [final_valor, error] =
+              std::to_chars(cursor, cursor + kMaximoCaracteresValor,
+                            probabilidad, std::chars_format::fixed, 10);
+          if (error != std::errc()) {
+            throw std::runtime_error(
+                "Error: Probabilidad demasiado grande para exportar");
+          }
+          cursor = final_valor;
+          *cursor++ = '\n';
+        }
+        longitudes[j] = cursor - buferes[j].data();
+      });
+      for (uint64_t j = 0; j < bloques; ++j) {
+        archivo.write(buferes[j].data(), longitudes[j]);
+      }
+    }
+  });
+
+  if (!archivo) {
+    throw std::runtime_error("Error: No se pudo escribir el archivo " +
+                             nombre_archivo);
+  }
+}
+
+/**
+ * @brief Función para obtener una normal estándar (Box-Muller)
+ * @param[in,out] aleatorio: Flujo aleatorio
+ * @return Valor de una N(0, 1)
+ */
+static double sampleNormal(CounterRng& aleatorio) {
+  double u = 1.0 - aleatorio.nextDouble();
+  double v = aleatorio.nextDouble();
+  return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * std::numbers::pi * v);
+}
+
+/**
+ * @brief Función para obtener una Gamma(α, 1) (Marsaglia-Tsang; con α < 1 se
+ *        usa Gamma(α + 1) · U^(1/α))
+ * @param[in] alfa: Parámetro de forma, positivo
+ * @param[in,out] aleatorio: Flujo aleatorio
+ * @return Valor de una Gamma(α, 1)
+ */
+static double sampleGamma(double alfa, CounterRng& aleatorio) {
+  if (alfa < 1.0) {
+    double u = 1.0 - aleatorio.nextDouble();
+    return sampleGamma(alfa + 1.0, aleatorio) * std::pow(u, 1.0 / alfa);
+  }
+  double d = alfa - 1.0 / 3.0;
+  double c = 1.0 / std::sqrt(9.0 * d);
+  while (true) {
+    double x = sampleNormal(aleatorio);
+    double v = 1.0 + c * x;
+    if (v <= 0.0) {
+      continue;
+    }
+    v = v * v * v;
+    double u = 1.0 - aleatorio.nextDouble();
+    if (std::log(u) < 0.5 * x * x + d - d * v + d * std::log(v)) {
+      return d * v;
+    }
   }
-  
-  archivo.close();
 }
 
 /**
- * @brief Método para generar una distribución aleatoria
+ * @brief Método para generar una distribución aleatoria con pesos uniformes
+ *        y una semilla no reproducible
  */
 void BinaryDistribution::generateRandom() {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_real_distribution<> dis(0.1, 10.0);
-  
-  for (uint64_t i = 0; i < tamano_espacio_estados_; i++) {
-    probabilidades_[i] = dis(gen);
+  generateRandom(std::random_device{}());
+}
+
+/**
+ * @brief Método para generar una distribución aleatoria reproducible. El
+ *        peso de cada estado sale de un flujo CounterRng propio (semilla,
+ *        estado lógico), de modo que la tabla depende solo de la semilla y
+ *        no del número de hilos ni del orden físico. Cada tarea genera un
+ *        bloque y acumula su suma en la misma pasada; una segunda pasada
+ *        paralela divide por el total.
+ * @param[in] semilla: Semilla del generador
+ * @param[in] numero_hilos: Número de hilos
+ * @param[in] tipo: Generador a utilizar
+ * @param[in] parametro: α de kDirichlet, σ de kLowEntropy o ε de
+ *                       kNearProduct (kUniform no lo usa)
+ * @throws std::invalid_argument si el parámetro no es válido para el
+ *         generador
+ */
+void BinaryDistribution::generateRandom(uint64_t semilla, int numero_hilos,
+                                        RandomGenerator tipo,
+                                        double parametro) {
+  if ((tipo == RandomGenerator::kDirichlet && !(parametro > 0.0)) ||
+      (tipo != RandomGenerator::kDirichlet && !(parametro >= 0.0))) {
+    throw std::invalid_argument(
+        "Error: Parámetro del generador fuera de rango");
+  }
+
+  // En forma producto, cada byte físico del estado aporta el producto de
+  // las marginales de sus 8 variables, precalculado para los 256 valores
+  std::vector<std::array<double, 256>> producto;
+  if (tipo == RandomGenerator::kNearProduct) {
+    CounterRng aleatorio(semilla, ~0ULL);
+    std::vector<double> marginal(numero_variables_);
+    for (double& probabilidad : marginal) {
+      probabilidad = 0.05 + 0.9 * aleatorio.nextDouble();
+    }
+    producto.resize((numero_variables_ + 7) / 8);
+    for (size_t byte = 0; byte < producto.size(); ++byte) {
+      for (int valor = 0; valor < 256; ++valor) {
+        double factor = 1.0;
+        for (int bit = 0; bit < 8; ++bit) {
+          int fisico = 8 * byte + bit;
+          if (fisico >= numero_variables_) {
+            break;
+          }
+          double p = marginal[variable_logica_[fisico]];
+          factor *= (valor >> bit) & 1 ? p : 1.0 - p;
+        }
+        producto[byte][valor] = factor;
+      }
+    }
   }
-  normalize();
+
+  auto peso = [&](uint64_t fisico) {
+    CounterRng aleatorio(semilla,
+                         orden_identidad_ ? fisico : toLogicalState(fisico));
+    switch (tipo) {
+      case RandomGenerator::kDirichlet:
+        return sampleGamma(parametro, aleatorio);
+      case RandomGenerator::kLowEntropy:
+        return std::exp(parametro * sampleNormal(aleatorio));
+      case RandomGenerator::kNearProduct: {
+        double valor = std::exp(parametro * sampleNormal(aleatorio));
+        for (size_t byte = 0; byte < producto.size(); ++byte) {
+          valor *= producto[byte][(fisico >> (8 * byte)) & 0xFF];
+        }
+        return valor;
+      }
+      default:
+        return 0.1 + 9.9 * aleatorio.nextDouble();
+    }
+  };
+
+  uint64_t bloques = (tamano_espacio_estados_ + kEstadosBloqueGeneracion - 1) /
+                     kEstadosBloqueGeneracion;
+  std::vector<double> sumas(bloques);
+  visitTable([&](auto& tabla) {
+    using Valor = typename std::remove_reference_t<decltype(tabla)>::value_type;
+    auto tramo = [&](uint64_t bloque) {
+      uint64_t inicio = bloque * kEstadosBloqueGeneracion;
+      return std::pair(inicio, std::min(inicio + kEstadosBloqueGeneracion,
+                                        tamano_espacio_estados_));
+    };
+    ParallelExecutor::run(bloques, numero_hilos, [&](uint64_t bloque) {
+      auto [inicio, fin] = tramo(bloque);
+      double suma = 0.0;
+      for (uint64_t i = inicio; i < fin; ++i) {
+        tabla[i] = Valor(peso(i));
+        suma += static_cast<double>(tabla[i]);
+      }
+      sumas[bloque] = suma;
+    });
+
+    double total = 0.0;
+    for (double suma : sumas) {
+      total += suma;
+    }
+    if (total < EPSILON) {
+      throw std::runtime_error(
+          "Error: No se puede normalizar, la suma de probabilidades es cero");
+    }
+    ParallelExecutor::run(bloques, numero_hilos, [&](uint64_t bloque) {
+      auto [inicio, fin] = tramo(bloque);
+      for (uint64_t i = inicio; i < fin; ++i) {
+        tabla[i] = Valor(static_cast<double>(tabla[i]) / total);
+      }
+    });
+  });
+  version_++;
 }
 
 /**
@@ -195,76 +598,481 @@ void BinaryDistribution::generateRandom() {
  *         a la izquierda
  */
 std::string BinaryDistribution::indexToBinary(uint64_t indice) const {
-  std::string binario;
-  binario.reserve(numero_variables_);
-  
-  for (int i = 0; i < numero_variables_; ++i) {
-    binario = std::string(1, (indice & 1 ? '1' : '0')) + binario;
-    indice >>= 1;
-  }
-  
+  std::string binario(numero_variables_, '0');
+  writeBinaryDigits(indice, numero_variables_, binario.data());
   return binario;
 }
 
 /**
- * @brief Método que carga la distribución desde un archivo CSV
+ * @brief Método que escribe los N bits bajos de un índice, el más
+ *        significativo primero, traduciendo cada byte con una tabla
+ * @param[in] indice: Índice a escribir
+ * @param[in] numero_bits: Número de bits (N)
+ * @param[out] destino: Primer carácter de salida (se escriben N)
+ */
+void BinaryDistribution::writeBinaryDigits(uint64_t indice, int numero_bits,
+                                           char* destino) {
+  static constexpr auto kDigitosByte = [] {
+    std::array<std::array<char, 8>, 256> tabla{};
+    for (int byte = 0; byte < 256; ++byte) {
+      for (int bit = 0; bit < 8; ++bit) {
+        tabla[byte][7 - bit] = (byte >> bit) & 1 ? '1' : '0';
+      }
+    }
+    return tabla;
+  }();
+  // Se escriben bytes completos alineados a la derecha y se copia la cola
+  char digitos[64];
+  int bytes = (numero_bits + 7) / 8;
+  for (int b = 0; b < bytes; ++b) {
+    std::memcpy(digitos + 64 - 8 * (b + 1),
+                kDigitosByte[(indice >> (8 * b)) & 0xFF].data(), 8);
+  }
+  std::memcpy(destino, digitos + 64 - numero_bits, numero_bits);
+}
+
+/**
+ * @brief Método que carga la distribución desde un archivo CSV. El archivo se
+ *        proyecta en memoria y se analiza en una sola pasada, escribiendo cada
+ *        fila directamente en la tabla. Los bloques de ~1 MB, ajustados a
+ *        inicios de línea, se reparten entre hilos. Cada estado lo escribe
+ *        solo el primer hilo que lo marca; si un estado aparece en varias
+ *        filas, el archivo se vuelve a aplicar en orden con un hilo, de modo
+ *        que gana la última fila, como en una lectura secuencial.
  * @param[in] nombre_archivo: Ruta del archivo CSV
+ * @param[in] numero_hilos: Número de hilos para analizar el archivo
  * @throws std::runtime_error si hay errores al leer el archivo o al parsear
  *         su contenido
  */
-void BinaryDistribution::loadFromCSV(const std::string& nombre_archivo) {
-  std::ifstream archivo(nombre_archivo);
-  if (!archivo.is_open()) {
+void BinaryDistribution::loadFromCSV(const std::string& nombre_archivo,
+                                     int numero_hilos) {
+  std::unique_ptr<MappedFile> archivo;
+  try {
+    archivo = std::make_unique<MappedFile>(nombre_archivo);
+  } catch (const std::runtime_error&) {
     throw std::runtime_error("No se puede abrir el archivo: " +
                              nombre_archivo);
   }
-  
-  std::string linea;
-  std::vector<std::pair<std::string, double>> datos;
-  
-  while (std::getline(archivo, linea)) {
-    if (linea.empty()) continue;
-    
-    size_t posicion_coma = linea.find(',');
-    if (posicion_coma == std::string::npos) {
-      throw std::runtime_error("Formato CSV inválido: " + linea);
+  const char* inicio = reinterpret_cast<const char*>(archivo->getData());
+  const char* fin = inicio + archivo->getSize();
+
+  // La primera línea no vacía fija el número de variables
+  numero_variables_ = csvNumberVariables(inicio, fin);
+  tamano_espacio_estados_ = 1ULL << numero_variables_;
+  allocateTable();
+
+  uint64_t tamano = fin - inicio;
+  uint64_t numero_bloques = std::max<uint64_t>(1, tamano / kBytesBloqueCSV);
+  visitTable([&](auto& tabla) {
+    using Valor = typename std::remove_reference_t<decltype(tabla)>::value_type;
+    // Cada bloque empieza en la primera línea que comienza dentro de su rango
+    auto inicioBloque = [&](uint64_t bloque) {
+      if (bloque == 0) {
+        return inicio;
+      }
+      if (bloque >= numero_bloques) {
+        return fin;
+      }
+      const char* posicion = inicio + bloque * (tamano / numero_bloques) - 1;
+      const char* salto = std::find(posicion, fin, '\n');
+      return salto == fin ? fin : salto + 1;
+    };
+
+    // vistos: un bit por estado; el hilo que lo pone a 1 es el único que
+    // escribe el estado, así que dos hilos nunca escriben la misma posición
+    std::vector<uint64_t> vistos((tamano_espacio_estados_ + 63) / 64, 0);
+    std::atomic<bool> repetidos(false);
+    ParallelExecutor::run(numero_bloques, numero_hilos, [&](uint64_t bloque) {
+      forEachCSVRow(inicioBloque(bloque), inicioBloque(bloque + 1), fin,
+                    numero_variables_,
+                    [&](uint64_t indice, double probabilidad) {
+                      uint64_t bit = 1ULL << (indice & 63);
+                      std::atomic_ref<uint64_t> palabra(vistos[indice >> 6]);
+                      if (palabra.fetch_or(bit, std::memory_order_relaxed) &
+                          bit) {
+                        repetidos.store(true, std::memory_order_relaxed);
+                        return;
+                      }
+                      tabla[indice] = Valor(probabilidad);
+                    });
+    });
+    if (repetidos.load()) {
+      forEachCSVRow(inicio, fin, fin, numero_variables_,
+                    [&](uint64_t indice, double probabilidad) {
+                      tabla[indice] = Valor(probabilidad);
+                    });
     }
-    
-    std::string binario = linea.substr(0, posicion_coma);
-    double probabilidad = std::stod(linea.substr(posicion_coma + 1));
-    
-    datos.push_back({binario, probabilidad});
+  });
+  resetVariableOrder();
+}
+
+/**
+ * @brief Método que restablece el orden físico identidad de las variables
+ */
+void BinaryDistribution::resetVariableOrder() {
+  posicion_fisica_.resize(numero_variables_);
+  std::iota(posicion_fisica_.begin(), posicion_fisica_.end(), 0);
+  variable_logica_ = posicion_fisica_;
+  orden_identidad_ = true;
+}
+
+/**
+ * @brief Método que traduce un estado (o máscara) lógico a su posición física
+ *        en la tabla
+ * @param[in] estado: Estado lógico (bit i = variable X_{i+1})
+ * @return Estado equivalente en el orden físico actual
+ */
+uint64_t BinaryDistribution::toPhysicalState(uint64_t estado) const {
+  if (orden_identidad_) {
+    return estado;
   }
-  
-  archivo.close();
-  
-  if (datos.empty()) {
-    throw std::runtime_error("Archivo CSV vacío");
+  uint64_t fisico = 0;
+  while (estado != 0) {
+    fisico |= 1ULL << posicion_fisica_[std::countr_zero(estado)];
+    estado &= estado - 1;
   }
-  
-  numero_variables_ = datos[0].first.length();
+  return fisico;
+}
+
+/**
+ * @brief Método que traduce un estado (o máscara) físico a su forma lógica
+ * @param[in] estado: Estado en el orden físico actual
+ * @return Estado lógico equivalente
+ */
+uint64_t BinaryDistribution::toLogicalState(uint64_t estado) const {
+  if (orden_identidad_) {
+    return estado;
+  }
+  uint64_t logico = 0;
+  while (estado != 0) {
+    logico |= 1ULL << variable_logica_[std::countr_zero(estado)];
+    estado &= estado - 1;
+  }
+  return logico;
+}
+
+/**
+ * @brief Método que reordena físicamente las variables de la tabla. Tras la
+ *        llamada, el bit físico i almacena la variable lógica orden[i]. La
+ *        interfaz lógica (getProbability, consultas, exportación) no cambia.
+ *
+ *        La copia se hace por teselas: cada tesela fija los bits exteriores y
+ *        recorre todas las combinaciones de los bits bajos de destino y de
+ *        origen, de modo que lecturas y escrituras quedan en tramos contiguos
+ *        que caben en caché. Las teselas se reparten entre hilos; necesita
+ *        memoria temporal del tamaño de la tabla.
+ * @param[in] orden: Permutación de 0..N-1 (variable lógica por bit físico)
+ * @param[in] numero_hilos: Número de hilos para la copia
+ * @throws std::invalid_argument si orden no es una permutación de 0..N-1
+ */
+void BinaryDistribution::permuteVariables(const std::vector<int>& orden,
+                                          int numero_hilos) {
+  if (orden.size() != static_cast<size_t>(numero_variables_)) {
+    throw std::invalid_argument(
+        "Error: El orden debe contener exactamente N variables");
+  }
+  std::vector<bool> vista(numero_variables_, false);
+  for (int variable : orden) {
+    if (variable < 0 || variable >= numero_variables_ || vista[variable]) {
+      throw std::invalid_argument(
+          "Error: El orden debe ser una permutación de las variables");
+    }
+    vista[variable] = true;
+  }
+
+  // origen[i]: bit de la tabla actual que pasa a ocupar el bit físico i
+  std::vector<int> origen(numero_variables_);
+  for (int i = 0; i < numero_variables_; ++i) {
+    origen[i] = posicion_fisica_[orden[i]];
+  }
+  auto permutar = [&origen](uint64_t destino) {
+    uint64_t fuente = 0;
+    while (destino != 0) {
+      fuente |= 1ULL << origen[std::countr_zero(destino)];
+      destino &= destino - 1;
+    }
+    return fuente;
+  };
+
+  // La tesela cubre los bits bajos de destino y los que proceden de los bits
+  // bajos de origen; como la permutación respeta el OR, basta con sumar la
+  // traducción del exterior y la de la tesela
+  int bits_bajos = std::min(numero_variables_, kBitsTeselaPermutacion);
+  uint64_t mascara_tesela = (1ULL << bits_bajos) - 1;
+  for (int i = 0; i < numero_variables_; ++i) {
+    if (origen[i] < bits_bajos) {
+      mascara_tesela |= 1ULL << i;
+    }
+  }
+  uint64_t mascara_todas = numero_variables_ == 64
+                               ? ~0ULL
+                               : (1ULL << numero_variables_) - 1;
+  BitExtractor tesela(mascara_tesela);
+  BitExtractor exterior(mascara_todas & ~mascara_tesela);
+
+  uint64_t estados_tesela = 1ULL << tesela.getNumberBits();
+  std::vector<uint64_t> destino_tesela(estados_tesela);
+  std::vector<uint64_t> origen_tesela(estados_tesela);
+  for (uint64_t t = 0; t < estados_tesela; ++t) {
+    destino_tesela[t] = tesela.deposit(t);
+    origen_tesela[t] = permutar(destino_tesela[t]);
+  }
+
+  uint64_t estados_exterior = 1ULL << exterior.getNumberBits();
+  uint64_t numero_tareas = std::min<uint64_t>(estados_exterior, 256);
+  uint64_t por_tarea = estados_exterior / numero_tareas;
+  visitTable([&](auto& tabla) {
+    std::remove_reference_t<decltype(tabla)> permutadas(tabla.size());
+    ParallelExecutor::run(numero_tareas, numero_hilos, [&](uint64_t tarea) {
+      for (uint64_t k = tarea * por_tarea; k < (tarea + 1) * por_tarea; ++k) {
+        uint64_t destino = exterior.deposit(k);
+        uint64_t fuente = permutar(destino);
+        for (uint64_t t = 0; t < estados_tesela; ++t) {
+          permutadas[destino | destino_tesela[t]] =
+              tabla[fuente | origen_tesela[t]];
+        }
+      }
+    });
+    tabla.swap(permutadas);
+  });
+
+  variable_logica_ = orden;
+  orden_identidad_ = true;
+  for (int i = 0; i < numero_variables_; ++i) {
+    posicion_fisica_[orden[i]] = i;
+    orden_identidad_ = orden_identidad_ && orden[i] == i;
+  }
+  version_++;
+}
+
+/**
+ * @brief Método para extraer la rebanada de la distribución consistente con
+ *        X_variable = valor, sin normalizar. La rebanada es una distribución
+ *        de N-1 variables (las restantes, en el mismo orden lógico) que
+ *        conserva el tipo de almacenamiento y el orden físico del resto de
+ *        variables, de modo que su tabla es la mitad de la original copiada
+ *        en tramos contiguos de 2^b estados (b = bit físico de la variable).
+ * @param[in] variable: Índice de la variable fijada (0..N-1)
+ * @param[in] valor: Valor de la variable (0 o 1)
+ * @param[in] numero_hilos: Número de hilos para la copia
+ * @return Distribución de N-1 variables con las probabilidades P(x, X_v = valor)
+ * @throws std::invalid_argument si la variable o el valor no son válidos o
+ *         la distribución tiene una sola variable
+ */
+BinaryDistribution BinaryDistribution::slice(int variable, int valor,
+                                             int numero_hilos) const {
+  if (variable < 0 || variable >= numero_variables_ ||
+      (valor != 0 && valor != 1)) {
+    throw std::invalid_argument("Error: Variable o valor fuera de rango");
+  }
+  if (numero_variables_ == 1) {
+    throw std::invalid_argument(
+        "Error: No se puede fijar la única variable de la distribución");
+  }
+
+  BinaryDistribution rebanada(numero_variables_ - 1, tipo_almacenamiento_);
+  int bit = posicion_fisica_[variable];
+  for (int fisico = 0, destino = 0; fisico < numero_variables_; ++fisico) {
+    if (fisico == bit) {
+      continue;
+    }
+    int logica = variable_logica_[fisico];
+    logica -= logica > variable ? 1 : 0;
+    rebanada.variable_logica_[destino] = logica;
+    rebanada.posicion_fisica_[logica] = destino;
+    rebanada.orden_identidad_ = rebanada.orden_identidad_ && logica == destino;
+    destino++;
+  }
+
+  // El estado j de la rebanada es el estado de origen con el bit fijado
+  // insertado en la posición física b
+  uint64_t bajos = (1ULL << bit) - 1;
+  uint64_t fijo = static_cast<uint64_t>(valor) << bit;
+  uint64_t estados = rebanada.tamano_espacio_estados_;
+  uint64_t bloques =
+      (estados + kEstadosBloqueRebanada - 1) / kEstadosBloqueRebanada;
+  visitProbabilities([&](const auto* origen) {
+    rebanada.visitTable([&](auto& destino) {
+      using Valor =
+          typename std::remove_reference_t<decltype(destino)>::value_type;
+      ParallelExecutor::run(bloques, numero_hilos, [&](uint64_t bloque) {
+        uint64_t inicio = bloque * kEstadosBloqueRebanada;
+        uint64_t fin = std::min(inicio + kEstadosBloqueRebanada, estados);
+        for (uint64_t j = inicio; j < fin; ++j) {
+          destino[j] = Valor(static_cast<double>(
+              origen[((j & ~bajos) << 1) | fijo | (j & bajos)]));
+        }
+      });
+    });
+  });
+  return rebanada;
+}
+
+/**
+ * @brief Método que propone un orden físico a partir de un registro de
+ *        consultas: las variables más consultadas (como interés o evidencia)
+ *        ocupan los bits altos y las que casi siempre se marginalizan quedan
+ *        en los bits bajos, donde forman tramos contiguos
+ * @param[in] consultas: Registro de consultas representativo
+ * @return Orden utilizable en permuteVariables
+ */
+std::vector<int> BinaryDistribution::suggestVariableOrder(
+    std::span<const ConditionalQuery> consultas) const {
+  std::vector<uint64_t> frecuencias(numero_variables_, 0);
+  for (const ConditionalQuery& consulta : consultas) {
+    uint64_t usadas = consulta.getMaskC() | consulta.getMaskI();
+    while (usadas != 0) {
+      int variable = std::countr_zero(usadas);
+      if (variable < numero_variables_) {
+        frecuencias[variable]++;
+      }
+      usadas &= usadas - 1;
+    }
+  }
+  std::vector<int> orden(numero_variables_);
+  std::iota(orden.begin(), orden.end(), 0);
+  std::stable_sort(orden.begin(), orden.end(), [&](int a, int b) {
+    return frecuencias[a] < frecuencias[b];
+  });
+  return orden;
+}
+
+/**
+ * @brief Método para exportar la distribución al formato binario: cabecera
+ *        versionada (N, tipo de almacenamiento, orden físico de las variables
+ *        y suma de verificación) seguida de la tabla en crudo a partir del
+ *        byte 4096. El archivo se puede cargar con mmap en O(1).
+ * @param[in] nombre_archivo: Ruta del archivo binario de salida
+ * @throws std::runtime_error si no se puede abrir o escribir el archivo
+ */
+void BinaryDistribution::exportToBinary(
+    const std::string& nombre_archivo) const {
+  std::ofstream archivo(nombre_archivo, std::ios::binary);
+  if (!archivo.is_open()) {
+    throw std::runtime_error("Error: No se puede abrir el archivo " +
+                             nombre_archivo);
+  }
+
+  const void* tabla = visitProbabilities(
+      [](const auto* datos) { return static_cast<const void*>(datos); });
+  BinaryFileHeader cabecera{};
+  std::memcpy(cabecera.magia, kMagiaBinaria, sizeof(kMagiaBinaria));
+  cabecera.version_formato = kVersionFormatoBinario;
+  cabecera.numero_variables = static_cast<uint32_t>(numero_variables_);
+  cabecera.tipo_almacenamiento =
+      static_cast<uint32_t>(tipo_almacenamiento_);
+  cabecera.desplazamiento_datos = kDesplazamientoDatos;
+  cabecera.bytes_datos = getMemoryUsage();
+  cabecera.suma_verificacion = computeChecksum(tabla, cabecera.bytes_datos);
+  for (int i = 0; i < numero_variables_; ++i) {
+    cabecera.orden[i] = static_cast<uint8_t>(variable_logica_[i]);
+  }
+
+  std::vector<char> bloque_cabecera(kDesplazamientoDatos, 0);
+  std::memcpy(bloque_cabecera.data(), &cabecera, sizeof(cabecera));
+  archivo.write(bloque_cabecera.data(), bloque_cabecera.size());
+  archivo.write(static_cast<const char*>(tabla), cabecera.bytes_datos);
+  if (!archivo) {
+    throw std::runtime_error("Error: No se pudo escribir el archivo " +
+                             nombre_archivo);
+  }
+}
+
+/**
+ * @brief Método para comprobar que la tabla coincide con la suma de
+ *        verificación del archivo binario del que se cargó (recorre la tabla)
+ * @return true si coincide o si la distribución no procede de un archivo
+ *         binario, false si el archivo está dañado
+ */
+bool BinaryDistribution::verifyChecksum() const {
+  if (!datos_mapeados_) {
+    return true;
+  }
+  return computeChecksum(datos_mapeados_, getMemoryUsage()) ==
+         suma_verificacion_;
+}
+
+/**
+ * @brief Método que proyecta en memoria un archivo binario de distribución y
+ *        valida su cabecera
+ * @param[in] nombre_archivo: Ruta del archivo binario
+ * @throws std::runtime_error si el archivo no existe o su cabecera no es
+ *         válida
+ */
+void BinaryDistribution::mapBinary(const std::string& nombre_archivo) {
+  auto archivo = std::make_shared<const MappedFile>(nombre_archivo);
+  BinaryFileHeader cabecera;
+  if (archivo->getSize() < sizeof(cabecera)) {
+    throw std::runtime_error("Error: Archivo binario demasiado corto: " +
+                             nombre_archivo);
+  }
+  std::memcpy(&cabecera, archivo->getData(), sizeof(cabecera));
+  validateBinaryFileHeader(cabecera, archivo->getSize(), nombre_archivo);
+
+  numero_variables_ = static_cast<int>(cabecera.numero_variables);
   tamano_espacio_estados_ = 1ULL << numero_variables_;
-  probabilidades_.resize(tamano_espacio_estados_, 0.0);
-  
-  for (const auto& [binario, probabilidad] : datos) {
-    if (binario.length() != static_cast<size_t>(numero_variables_)) {
-      throw std::runtime_error("Longitud de máscara inconsistente en CSV");
+  tipo_almacenamiento_ =
+      static_cast<StorageType>(cabecera.tipo_almacenamiento);
+  std::vector<int> orden = headerVariableOrder(cabecera);
+  variable_logica_ = orden;
+  posicion_fisica_.assign(numero_variables_, 0);
+  orden_identidad_ = true;
+  for (int i = 0; i < numero_variables_; ++i) {
+    posicion_fisica_[orden[i]] = i;
+    orden_identidad_ = orden_identidad_ && orden[i] == i;
+  }
+
+  suma_verificacion_ = cabecera.suma_verificacion;
+  datos_mapeados_ = archivo->getData() + cabecera.desplazamiento_datos;
+  archivo_mapeado_ = std::move(archivo);
+}
+
+/**
+ * @brief Método que copia la tabla proyectada a memoria propia para poder
+ *        modificarla, y libera la proyección
+ */
+void BinaryDistribution::detachMapping() {
+  switch (tipo_almacenamiento_) {
+    case StorageType::kFloat: {
+      const float* tabla = static_cast<const float*>(datos_mapeados_);
+      probabilidades_simples_.assign(tabla, tabla + tamano_espacio_estados_);
+      break;
+    }
+    case StorageType::kBfloat16: {
+      const Bfloat16* tabla = static_cast<const Bfloat16*>(datos_mapeados_);
+      probabilidades_bfloat16_.assign(tabla,
+                                      tabla + tamano_espacio_estados_);
+      break;
+    }
+    default: {
+      const double* tabla = static_cast<const double*>(datos_mapeados_);
+      probabilidades_.assign(tabla, tabla + tamano_espacio_estados_);
+      break;
     }
-    
-    uint64_t indice = binaryToIndex(binario);
-    probabilidades_[indice] = probabilidad;
   }
+  datos_mapeados_ = nullptr;
+  archivo_mapeado_.reset();
 }
 
 /**
- * @brief Método que convierte la máscara binaria a su índice numérico
- * @param[in] binario: Cadena de texto con la representación binaria
- * @return Índice numérico correspondiente a la máscara binaria
+ * @brief Método que calcula la suma de verificación de un bloque de bytes
+ *        (FNV-1a sobre palabras de 64 bits)
+ * @param[in] datos: Primer byte del bloque
+ * @param[in] bytes: Tamaño del bloque en bytes
+ * @return Suma de verificación
  */
-uint64_t BinaryDistribution::binaryToIndex(const std::string& binario) const {
-  uint64_t indice = 0;
-  for (char bit : binario) {
-    indice = (indice << 1) | (bit == '1' ? 1 : 0);
+uint64_t BinaryDistribution::computeChecksum(const void* datos,
+                                             uint64_t bytes) {
+  const unsigned char* octetos = static_cast<const unsigned char*>(datos);
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  uint64_t i = 0;
+  for (; i + 8 <= bytes; i += 8) {
+    uint64_t palabra;
+    std::memcpy(&palabra, octetos + i, sizeof(palabra));
+    hash = (hash ^ palabra) * 0x100000001B3ULL;
+  }
+  for (; i < bytes; ++i) {
+    hash = (hash ^ octetos[i]) * 0x100000001B3ULL;
   }
-  return indice;
+  return hash;
 }
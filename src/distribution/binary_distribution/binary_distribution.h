@@ -15,40 +15,227 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <span>
+
 #include "../i_distribution.h"
+#include "../../conditional_query/conditional_query.h"
+#include "../../storage_type/storage_type.h"
+#include "../../mapped_file/mapped_file.h"
+#include "../../simd_reducer/simd_reducer.h"
 
 // EPSILON: tolerancia para comparaciones de punto flotante
 static constexpr double EPSILON = 1e-9;
 
+/**
+ * @brief Formato de los archivos de distribución
+ */
+enum class FileFormat {
+  kCsv,    ///< Texto: una fila "binario,probabilidad" por estado
+  kBinary  ///< Cabecera versionada y tabla en crudo, proyectable con mmap
+};
+
+/**
+ * @brief Generadores de distribuciones aleatorias (ver generateRandom)
+ */
+enum class RandomGenerator {
+  kUniform,     ///< Pesos uniformes en [0.1, 10]
+  kDirichlet,   ///< Muestra de una Dirichlet simétrica de concentración α
+  kLowEntropy,  ///< Pesos log-normales exp(σ·Z): poca masa en muchos estados
+  kNearProduct  ///< Producto de marginales independientes con ruido exp(ε·Z)
+};
+
 /**
  * @brief Clase que representa una distribución conjunta de variables binarias discretas
  * Cada variable puede tomar valores 0 o 1, y la distribución asigna una probabilidad a cada combinación posible.
+ *
+ * Los estados y máscaras que recibe la interfaz pública son lógicos (bit i =
+ * variable X_{i+1}). Internamente la tabla puede almacenar las variables en
+ * otro orden físico (ver permuteVariables); getProbabilities() devuelve la
+ * tabla en orden físico, y toPhysicalState() traduce estados y máscaras.
+ *
+ * La tabla se almacena en double, float o bfloat16 (ver StorageType); los
+ * valores se devuelven y se acumulan siempre en double.
+ *
+ * Una distribución cargada de un archivo binario lee la tabla directamente de
+ * la proyección en memoria (solo lectura); la primera modificación la copia a
+ * memoria propia.
  */
 class BinaryDistribution : public IDistribution {
  public:
-  explicit BinaryDistribution(int);
-  explicit BinaryDistribution(const std::string&);
+  explicit BinaryDistribution(int, StorageType = StorageType::kDouble);
+  explicit BinaryDistribution(const std::string&,
+                              StorageType = StorageType::kDouble, int = 1);
+  BinaryDistribution(const std::string&, FileFormat);
   int getNumberVariables() const override { return numero_variables_; }
-  const std::vector<double>& getProbabilities() const {
-    return probabilidades_;
+  /// Tabla de probabilidades en orden físico (solo almacenamiento double)
+  std::span<const double> getProbabilities() const;
+  StorageType getStorageType() const { return tipo_almacenamiento_; }
+  /// Bytes ocupados por la tabla de probabilidades
+  uint64_t getMemoryUsage() const {
+    return tamano_espacio_estados_ * storageBytes(tipo_almacenamiento_);
   }
+  /**
+   * @brief Método para aplicar una función a la tabla en orden físico con su
+   *        tipo de almacenamiento real
+   * @param[in] funcion: Invocable con un puntero const double*, const float*
+   *                     o const Bfloat16* al primer estado
+   * @return Lo que devuelva la función
+   */
+  template <class Funcion>
+  decltype(auto) visitProbabilities(Funcion&& funcion) const {
+    switch (tipo_almacenamiento_) {
+      case StorageType::kFloat:
+        return funcion(datos_mapeados_
+                           ? static_cast<const float*>(datos_mapeados_)
+                           : probabilidades_simples_.data());
+      case StorageType::kBfloat16:
+        return funcion(datos_mapeados_
+                           ? static_cast<const Bfloat16*>(datos_mapeados_)
+                           : probabilidades_bfloat16_.data());
+      default:
+        return funcion(datos_mapeados_
+                           ? static_cast<const double*>(datos_mapeados_)
+                           : probabilidades_.data());
+    }
+  }
+  /// true si la tabla se lee de un archivo binario proyectado en memoria
+  bool isMapped() const { return datos_mapeados_ != nullptr; }
   uint64_t getStateSpaceSize() const override {
     return tamano_espacio_estados_;
   }
+  /// Método para obtener el contador de modificaciones de la distribución,
+  /// que cambia con cada setProbability, normalize o generateRandom
+  uint64_t getVersion() const { return version_; }
+  /// Método para obtener el identificador único de esta instancia (una
+  /// copia recibe uno nuevo). Junto con la versión identifica el contenido
+  /// del que se calculan índices y vistas.
+  uint64_t getIdentifier() const { return identificador_.valor; }
   double getProbability(uint64_t) const override;
   void setProbability(uint64_t, double) override;
+  void assignProbabilities(std::span<const double>);
   void normalize() override;
   bool isValid() const override;
+  void normalize(int);
+  bool isValid(int) const;
+  bool normalizeIfInvalid(int = 1);
   void generateRandom();
+  void generateRandom(uint64_t, int = 1,
+                      RandomGenerator = RandomGenerator::kUniform,
+                      double = 1.0);
   std::string indexToBinary(uint64_t) const;
+
+  /// Métodos para la disposición física de las variables en la tabla
+  void permuteVariables(const std::vector<int>&, int = 1);
+  std::vector<int> suggestVariableOrder(std::span<const ConditionalQuery>) const;
+  /// Variable lógica almacenada en cada bit físico
+  const std::vector<int>& getVariableOrder() const { return variable_logica_; }
+  /// Bit físico de cada variable lógica (inversa de getVariableOrder)
+  const std::vector<int>& getPhysicalPositions() const {
+    return posicion_fisica_;
+  }
+  bool hasIdentityOrder() const { return orden_identidad_; }
+  uint64_t toPhysicalState(uint64_t) const;
+  uint64_t toLogicalState(uint64_t) const;
+  /// Rebanada de N-1 variables consistente con X_variable = valor
+  BinaryDistribution slice(int, int, int = 1) const;
   void display() const override;
   void exportToCSV(const std::string&) const override;
+  void exportToCSV(const std::string&, int) const;
+  void exportToBinary(const std::string&) const;
+  bool verifyChecksum() const;
     
  private:
   int numero_variables_;
   std::vector<double> probabilidades_;
+  /// probabilidades_simples_: Tabla con almacenamiento float
+  std::vector<float> probabilidades_simples_;
+  /// probabilidades_bfloat16_: Tabla con almacenamiento bfloat16
+  std::vector<Bfloat16> probabilidades_bfloat16_;
+  /// tipo_almacenamiento_: Tipo de la tabla en uso (las otras están vacías)
+  StorageType tipo_almacenamiento_ = StorageType::kDouble;
   uint64_t tamano_espacio_estados_;
+  uint64_t version_ = 0;
+  /**
+   * @brief Identificador único por instancia: las copias y asignaciones
+   *        reciben uno nuevo, porque a partir de ahí pueden divergir con la
+   *        misma versión
+   */
+  struct InstanceId {
+    InstanceId() : valor(next()) {}
+    InstanceId(const InstanceId&) : valor(next()) {}
+    InstanceId& operator=(const InstanceId&) {
+      valor = next();
+      return *this;
+    }
+    static uint64_t next() {
+      static std::atomic<uint64_t> contador{0};
+      return ++contador;
+    }
+    uint64_t valor;
+  };
+  /// identificador_: Identificador único de la instancia
+  InstanceId identificador_;
+  /// posicion_fisica_: Bit físico de cada variable lógica
+  std::vector<int> posicion_fisica_;
+  /// variable_logica_: Variable lógica almacenada en cada bit físico
+  std::vector<int> variable_logica_;
+  /// orden_identidad_: true si el orden físico coincide con el lógico
+  bool orden_identidad_ = true;
+  /// archivo_mapeado_: Archivo binario proyectado (compartido entre copias)
+  std::shared_ptr<const MappedFile> archivo_mapeado_;
+  /// datos_mapeados_: Tabla dentro de la proyección (nullptr si no hay)
+  const void* datos_mapeados_ = nullptr;
+  /// suma_verificacion_: Suma de verificación leída de la cabecera binaria
+  uint64_t suma_verificacion_ = 0;
+
+  /// kBitsTeselaPermutacion: Las permutaciones se procesan en teselas que
+  ///                          fijan hasta 6 bits bajos de origen y destino
+  static constexpr int kBitsTeselaPermutacion = 6;
+  /// kBytesBloqueCSV: El CSV se analiza en bloques de ~1 MB que se reparten
+  ///                  entre hilos
+  static constexpr uint64_t kBytesBloqueCSV = 1ULL << 20;
+  /// kEstadosBloqueExportacion: Estados que se formatean en cada búfer de
+  ///                            exportación CSV
+  static constexpr uint64_t kEstadosBloqueExportacion = 1ULL << 16;
+  /// kMaximoCaracteresValor: Caracteres de una probabilidad con 10
+  ///                         decimales (admite valores hasta 10^15)
+  static constexpr uint64_t kMaximoCaracteresValor = 27;
+  /// kEstadosBloqueGeneracion: Estados que genera cada tarea paralela de
+  ///                           generateRandom
+  static constexpr uint64_t kEstadosBloqueGeneracion = 1ULL << 16;
+  /// kEstadosBloqueResumen: Estados de cada bloque de tamaño fijo que se
+  ///                        resume al validar o normalizar la tabla
+  static constexpr uint64_t kEstadosBloqueResumen = 1ULL << 16;
+  /// kEstadosBloqueRebanada: Estados de la rebanada que copia cada tarea
+  ///                         paralela de slice
+  static constexpr uint64_t kEstadosBloqueRebanada = 1ULL << 16;
+
+  /// Método para aplicar una función al vector de la tabla en uso
+  template <class Funcion>
+  decltype(auto) visitTable(Funcion&& funcion) {
+    if (datos_mapeados_) {
+      detachMapping();
+    }
+    switch (tipo_almacenamiento_) {
+      case StorageType::kFloat:
+        return funcion(probabilidades_simples_);
+      case StorageType::kBfloat16:
+        return funcion(probabilidades_bfloat16_);
+      default:
+        return funcion(probabilidades_);
+    }
+  }
 
-  void loadFromCSV(const std::string&);
-  uint64_t binaryToIndex(const std::string&) const;
+  void allocateTable();
+  BlockSummary summarizeTable(int) const;
+  bool isValidSummary(const BlockSummary&) const;
+  void rescaleTable(double, int);
+  void loadFromCSV(const std::string&, int);
+  void mapBinary(const std::string&);
+  void detachMapping();
+  static uint64_t computeChecksum(const void*, uint64_t);
+  void resetVariableOrder();
+  static void writeBinaryDigits(uint64_t, int, char*);
 };
\ No newline at end of file
@@ -0,0 +1,85 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   binary_file_format.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la validación de la cabecera del formato binario
+ *         de distribución.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "binary_file_format.h"
+#include "../../storage_type/storage_type.h"
+
+/**
+ * @brief Función para comprobar una cabecera frente al tamaño real del
+ *        archivo: magia, versión, N, tipo de almacenamiento, tamaño de la
+ *        tabla y orden de las variables
+ * @param[in] cabecera: Cabecera leída del archivo
+ * @param[in] tamano_archivo: Tamaño del archivo en bytes
+ * @param[in] nombre_archivo: Ruta del archivo (para los mensajes de error)
+ * @throws std::runtime_error si la cabecera no es válida
+ */
+void validateBinaryFileHeader(const BinaryFileHeader& cabecera,
+                              uint64_t tamano_archivo,
+                              const std::string& nombre_archivo) {
+  if (std::memcmp(cabecera.magia, kMagiaBinaria, sizeof(kMagiaBinaria)) != 0) {
+    throw std::runtime_error(
+        "Error: El archivo no tiene formato binario de distribución: " +
+        nombre_archivo);
+  }
+  if (cabecera.version_formato != kVersionFormatoBinario) {
+    throw std::runtime_error(
+        "Error: Versión de formato binario no soportada: " +
+        std::to_string(cabecera.version_formato));
+  }
+  if (cabecera.numero_variables < 1 || cabecera.numero_variables > 63) {
+    throw std::runtime_error(
+        "Error: Número de variables inválido en el archivo binario");
+  }
+  if (cabecera.tipo_almacenamiento >
+      static_cast<uint32_t>(StorageType::kBfloat16)) {
+    throw std::runtime_error(
+        "Error: Tipo de almacenamiento desconocido en el archivo binario");
+  }
+
+  StorageType tipo = static_cast<StorageType>(cabecera.tipo_almacenamiento);
+  uint64_t estados = 1ULL << cabecera.numero_variables;
+  if (estados > ~0ULL / storageBytes(tipo) ||
+      cabecera.bytes_datos != estados * storageBytes(tipo) ||
+      cabecera.desplazamiento_datos % alignof(double) != 0 ||
+      cabecera.desplazamiento_datos > tamano_archivo ||
+      tamano_archivo - cabecera.desplazamiento_datos < cabecera.bytes_datos) {
+    throw std::runtime_error(
+        "Error: Archivo binario truncado o inconsistente: " + nombre_archivo);
+  }
+
+  std::vector<int> ordenado = headerVariableOrder(cabecera);
+  std::sort(ordenado.begin(), ordenado.end());
+  for (size_t i = 0; i < ordenado.size(); ++i) {
+    if (ordenado[i] != static_cast<int>(i)) {
+      throw std::runtime_error(
+          "Error: Orden de variables inválido en el archivo binario");
+    }
+  }
+}
+
+/**
+ * @brief Función para obtener el orden físico de las variables de una
+ *        cabecera
+ * @param[in] cabecera: Cabecera del archivo
+ * @return Variable lógica almacenada en cada bit físico
+ */
+std::vector<int> headerVariableOrder(const BinaryFileHeader& cabecera) {
+  return std::vector<int>(cabecera.orden,
+                          cabecera.orden + cabecera.numero_variables);
+}
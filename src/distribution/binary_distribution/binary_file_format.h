@@ -0,0 +1,62 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   binary_file_format.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la cabecera del formato binario de distribución,
+ *         compartida por la carga con mmap y la inferencia en streaming.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Cabecera del formato binario de distribución (little-endian). La
+ *        tabla en orden físico empieza en desplazamiento_datos, alineada a
+ *        página, y ocupa bytes_datos bytes.
+ */
+struct BinaryFileHeader {
+  /// magia: Identificador del formato, "IACPDIST"
+  char magia[8];
+  /// version_formato: Versión del formato (kVersionFormatoBinario)
+  uint32_t version_formato;
+  /// numero_variables: Número de variables (N)
+  uint32_t numero_variables;
+  /// tipo_almacenamiento: Valor de StorageType de la tabla
+  uint32_t tipo_almacenamiento;
+  /// reservado: Relleno a cero
+  uint32_t reservado;
+  /// desplazamiento_datos: Byte del archivo en que empieza la tabla
+  uint64_t desplazamiento_datos;
+  /// bytes_datos: Tamaño de la tabla en bytes
+  uint64_t bytes_datos;
+  /// suma_verificacion: Suma de verificación de la tabla
+  uint64_t suma_verificacion;
+  /// orden: Variable lógica almacenada en cada bit físico
+  uint8_t orden[64];
+};
+
+// kMagiaBinaria: Identificador de los archivos binarios de distribución
+inline constexpr char kMagiaBinaria[8] = {'I', 'A', 'C', 'P',
+                                          'D', 'I', 'S', 'T'};
+// kVersionFormatoBinario: Versión del formato binario que se escribe y lee
+inline constexpr uint32_t kVersionFormatoBinario = 1;
+// kDesplazamientoDatos: La tabla empieza en el byte 4096 del archivo
+//                       binario, alineada a página
+inline constexpr uint64_t kDesplazamientoDatos = 4096;
+
+/// Función para comprobar una cabecera frente al tamaño real del archivo
+void validateBinaryFileHeader(const BinaryFileHeader&, uint64_t,
+                              const std::string&);
+/// Función para obtener el orden físico (variable lógica por bit) de una
+/// cabecera ya validada
+std::vector<int> headerVariableOrder(const BinaryFileHeader&);
@@ -0,0 +1,85 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   csv_file_format.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación del análisis de filas del formato CSV de
+ *         distribución.
+ */
+
+#include <charconv>
+#include <stdexcept>
+#include <string>
+
+#include "csv_file_format.h"
+
+/**
+ * @brief Función para obtener el número de variables de un CSV: la longitud
+ *        de la máscara de su primera fila no vacía
+ * @param[in] inicio: Primer carácter del archivo
+ * @param[in] fin: Fin del archivo
+ * @return Número de variables (N)
+ * @throws std::runtime_error si el archivo está vacío, la primera fila no
+ *         tiene coma o la máscara tiene más de 63 caracteres
+ */
+int csvNumberVariables(const char* inicio, const char* fin) {
+  const char* primera = inicio;
+  while (primera != fin && (*primera == '\n' || *primera == '\r')) {
+    ++primera;
+  }
+  if (primera == fin) {
+    throw std::runtime_error("Archivo CSV vacío");
+  }
+  const char* fin_primera = std::find(primera, fin, '\n');
+  const char* coma = std::find(primera, fin_primera, ',');
+  if (coma == fin_primera) {
+    throw std::runtime_error("Formato CSV inválido: " +
+                             std::string(primera, fin_primera));
+  }
+  if (coma == primera || coma - primera > 63) {
+    throw std::runtime_error("Longitud de máscara inconsistente en CSV");
+  }
+  return static_cast<int>(coma - primera);
+}
+
+/**
+ * @brief Función que analiza una fila "binario,probabilidad" del CSV
+ * @param[in] linea: Primer carácter de la fila
+ * @param[in] fin: Fin de la fila (sin salto de línea ni espacios finales)
+ * @param[in] numero_variables: Longitud esperada de la máscara
+ * @param[out] probabilidad: Probabilidad de la fila
+ * @return Índice del estado de la fila
+ * @throws std::runtime_error si la fila no tiene el formato esperado o la
+ *         máscara no tiene numero_variables caracteres
+ */
+uint64_t parseCSVRow(const char* linea, const char* fin, int numero_variables,
+                     double& probabilidad) {
+  const char* coma = std::find(linea, fin, ',');
+  if (coma == fin) {
+    throw std::runtime_error("Formato CSV inválido: " +
+                             std::string(linea, fin));
+  }
+  if (coma - linea != numero_variables) {
+    throw std::runtime_error("Longitud de máscara inconsistente en CSV");
+  }
+  const char* valor = coma + 1;
+  while (valor != fin && (*valor == ' ' || *valor == '+')) {
+    ++valor;
+  }
+  auto [final_numero, error] = std::from_chars(valor, fin, probabilidad);
+  if (error != std::errc() || final_numero != fin) {
+    throw std::runtime_error("Formato CSV inválido: " +
+                             std::string(linea, fin));
+  }
+  uint64_t indice = 0;
+  for (const char* bit = linea; bit != coma; ++bit) {
+    indice = (indice << 1) | (*bit == '1' ? 1 : 0);
+  }
+  return indice;
+}
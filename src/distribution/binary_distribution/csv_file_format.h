@@ -0,0 +1,55 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   csv_file_format.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración del análisis de filas "binario,probabilidad" del
+ *         formato CSV, compartido por la carga densa y la dispersa.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+/// Función para obtener el número de variables (longitud de la máscara de la
+/// primera fila no vacía) de un CSV proyectado en memoria
+int csvNumberVariables(const char*, const char*);
+/// Función para analizar una fila sin salto de línea ni espacios finales
+uint64_t parseCSVRow(const char*, const char*, int, double&);
+
+/**
+ * @brief Función para aplicar escribir(indice, probabilidad) a cada fila no
+ *        vacía que empieza en [linea, fin_rango), en orden
+ * @param[in] linea: Inicio de la primera fila del rango
+ * @param[in] fin_rango: Fin del rango de inicios de fila
+ * @param[in] fin: Fin del archivo (la última fila puede terminar después de
+ *                 fin_rango)
+ * @param[in] numero_variables: Longitud de la máscara de cada fila
+ * @param[in] escribir: Función que recibe el índice y la probabilidad
+ * @throws std::runtime_error si alguna fila no tiene el formato esperado
+ */
+template <typename Funcion>
+void forEachCSVRow(const char* linea, const char* fin_rango, const char* fin,
+                   int numero_variables, Funcion&& escribir) {
+  while (linea < fin_rango) {
+    const char* fin_linea = std::find(linea, fin, '\n');
+    const char* ultimo = fin_linea;
+    while (ultimo != linea && (ultimo[-1] == '\r' || ultimo[-1] == ' ')) {
+      --ultimo;
+    }
+    if (ultimo != linea) {
+      double probabilidad;
+      uint64_t indice =
+          parseCSVRow(linea, ultimo, numero_variables, probabilidad);
+      escribir(indice, probabilidad);
+    }
+    linea = fin_linea == fin ? fin : fin_linea + 1;
+  }
+}
@@ -0,0 +1,249 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   factor.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase Factor, una tabla no negativa sobre un
+ *         subconjunto de variables binarias.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "factor.h"
+#include "../../bit_extractor/bit_extractor.h"
+
+/**
+ * @brief Constructor de un factor escalar de valor 1
+ */
+Factor::Factor() : valores_(1, 1.0) {}
+
+/**
+ * @brief Constructor a partir de sus variables y su tabla
+ * @param[in] variables: Variables del factor (índices distintos, cualquier
+ *                       orden; la tabla se reordena si no están ordenadas)
+ * @param[in] valores: Tabla de 2^|S| valores no negativos; el bit j de cada
+ *                     posición es el valor de variables[j]
+ * @throws std::invalid_argument si hay variables repetidas o negativas, el
+ *         factor tiene más de 62 variables, la tabla no tiene 2^|S| valores o
+ *         contiene valores negativos
+ */
+Factor::Factor(std::vector<int> variables, std::vector<double> valores) {
+  if (variables.size() > 62) {
+    throw std::invalid_argument(
+        "Error: Un factor admite como máximo 62 variables");
+  }
+  if (valores.size() != (1ULL << variables.size())) {
+    throw std::invalid_argument(
+        "Error: La tabla del factor debe tener 2^|S| valores");
+  }
+  for (double valor : valores) {
+    if (!(valor >= 0.0)) {
+      throw std::invalid_argument(
+          "Error: Los valores de un factor deben ser no negativos");
+    }
+  }
+
+  std::vector<int> ordenadas(variables);
+  std::sort(ordenadas.begin(), ordenadas.end());
+  if (std::adjacent_find(ordenadas.begin(), ordenadas.end()) !=
+          ordenadas.end() ||
+      (!ordenadas.empty() && ordenadas.front() < 0)) {
+    throw std::invalid_argument(
+        "Error: Las variables del factor deben ser distintas y no negativas");
+  }
+  if (ordenadas == variables) {
+    variables_ = std::move(variables);
+    valores_ = std::move(valores);
+    return;
+  }
+
+  // destino[j]: bit de la tabla ordenada que ocupa variables[j]
+  std::vector<int> destino(variables.size());
+  for (size_t j = 0; j < variables.size(); ++j) {
+    destino[j] = std::lower_bound(ordenadas.begin(), ordenadas.end(),
+                                  variables[j]) - ordenadas.begin();
+  }
+  valores_.assign(valores.size(), 0.0);
+  for (uint64_t i = 0; i < valores.size(); ++i) {
+    uint64_t ordenado = 0;
+    for (size_t j = 0; j < variables.size(); ++j) {
+      ordenado |= ((i >> j) & 1ULL) << destino[j];
+    }
+    valores_[ordenado] = valores[i];
+  }
+  variables_ = std::move(ordenadas);
+}
+
+/**
+ * @brief Método para saber si una variable pertenece al factor
+ * @param[in] variable: Índice de la variable
+ * @return true si el factor depende de la variable
+ */
+bool Factor::contains(int variable) const {
+  return position(variable) >= 0;
+}
+
+/**
+ * @brief Método para obtener el valor del factor en un estado completo
+ * @param[in] estado: Estado de las variables (bit i = variable i, i < 64)
+ * @return Valor del factor en la configuración de sus variables
+ */
+double Factor::valueAt(uint64_t estado) const {
+  uint64_t indice = 0;
+  for (size_t j = 0; j < variables_.size(); ++j) {
+    indice |= ((estado >> variables_[j]) & 1ULL) << j;
+  }
+  return valores_[indice];
+}
+
+/**
+ * @brief Método para multiplicar dos factores. Como las variables de ambos
+ *        están ordenadas, el índice de cada operando se obtiene extrayendo
+ *        sus bits del índice del producto.
+ * @param[in] otro: Segundo factor
+ * @return Factor producto sobre la unión de las variables
+ * @throws std::length_error si el producto tendría más de 62 variables
+ */
+Factor Factor::multiply(const Factor& otro) const {
+  std::vector<int> variables;
+  std::set_union(variables_.begin(), variables_.end(),
+                 otro.variables_.begin(), otro.variables_.end(),
+                 std::back_inserter(variables));
+  if (variables.size() > 62) {
+    throw std::length_error(
+        "Error: El producto de factores tendría más de 62 variables");
+  }
+  uint64_t mascara_propia = 0;
+  uint64_t mascara_otro = 0;
+  for (size_t j = 0; j < variables.size(); ++j) {
+    if (contains(variables[j])) {
+      mascara_propia |= 1ULL << j;
+    }
+    if (otro.contains(variables[j])) {
+      mascara_otro |= 1ULL << j;
+    }
+  }
+  BitExtractor propio(mascara_propia);
+  BitExtractor ajeno(mascara_otro);
+
+  Factor producto;
+  producto.variables_ = std::move(variables);
+  producto.valores_.resize(1ULL << producto.variables_.size());
+  for (uint64_t i = 0; i < producto.valores_.size(); ++i) {
+    producto.valores_[i] =
+        valores_[propio.extract(i)] * otro.valores_[ajeno.extract(i)];
+  }
+  return producto;
+}
+
+/**
+ * @brief Método para sumar el factor sobre una variable
+ * @param[in] variable: Variable a eliminar
+ * @return Factor sobre el resto de variables (el mismo si no la contiene)
+ */
+Factor Factor::sumOut(int variable) const {
+  int p = position(variable);
+  if (p < 0) {
+    return *this;
+  }
+  Factor resultado;
+  resultado.variables_ = variables_;
+  resultado.variables_.erase(resultado.variables_.begin() + p);
+  resultado.valores_.resize(valores_.size() / 2);
+  uint64_t bajos = (1ULL << p) - 1;
+  for (uint64_t i = 0; i < resultado.valores_.size(); ++i) {
+    uint64_t cero = ((i & ~bajos) << 1) | (i & bajos);
+    resultado.valores_[i] = valores_[cero] + valores_[cero | (1ULL << p)];
+  }
+  return resultado;
+}
+
+/**
+ * @brief Método para fijar el valor de una variable (evidencia)
+ * @param[in] variable: Variable observada
+ * @param[in] valor: Valor observado (0 o 1)
+ * @return Factor sobre el resto de variables (el mismo si no la contiene)
+ */
+Factor Factor::reduce(int variable, int valor) const {
+  int p = position(variable);
+  if (p < 0) {
+    return *this;
+  }
+  Factor resultado;
+  resultado.variables_ = variables_;
+  resultado.variables_.erase(resultado.variables_.begin() + p);
+  resultado.valores_.resize(valores_.size() / 2);
+  uint64_t bajos = (1ULL << p) - 1;
+  uint64_t fijo = valor ? 1ULL << p : 0;
+  for (uint64_t i = 0; i < resultado.valores_.size(); ++i) {
+    resultado.valores_[i] = valores_[((i & ~bajos) << 1) | (i & bajos) | fijo];
+  }
+  return resultado;
+}
+
+/**
+ * @brief Método para anular las configuraciones en las que una variable no
+ *        toma el valor observado, sin eliminarla del factor
+ * @param[in] variable: Variable observada
+ * @param[in] valor: Valor observado (0 o 1)
+ * @return Factor sobre las mismas variables (el mismo si no la contiene)
+ */
+Factor Factor::observe(int variable, int valor) const {
+  int p = position(variable);
+  if (p < 0) {
+    return *this;
+  }
+  Factor resultado = *this;
+  uint64_t fijo = valor ? 1ULL << p : 0;
+  for (uint64_t i = 0; i < resultado.valores_.size(); ++i) {
+    if ((i & (1ULL << p)) != fijo) {
+      resultado.valores_[i] = 0.0;
+    }
+  }
+  return resultado;
+}
+
+/**
+ * @brief Método para dividir el factor por su valor máximo
+ * @return Divisor aplicado (1 si el factor es nulo)
+ */
+double Factor::rescale() {
+  double maximo = *std::max_element(valores_.begin(), valores_.end());
+  if (maximo <= 0.0) {
+    return 1.0;
+  }
+  scale(1.0 / maximo);
+  return maximo;
+}
+
+/**
+ * @brief Método para multiplicar todos los valores por una constante
+ * @param[in] factor_escala: Constante no negativa
+ */
+void Factor::scale(double factor_escala) {
+  for (double& valor : valores_) {
+    valor *= factor_escala;
+  }
+}
+
+/**
+ * @brief Método para obtener la posición de una variable en el factor
+ * @param[in] variable: Índice de la variable
+ * @return Posición (bit de la tabla) o -1 si no pertenece al factor
+ */
+int Factor::position(int variable) const {
+  auto posicion =
+      std::lower_bound(variables_.begin(), variables_.end(), variable);
+  if (posicion == variables_.end() || *posicion != variable) {
+    return -1;
+  }
+  return posicion - variables_.begin();
+}
@@ -0,0 +1,64 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   factor.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase Factor, una tabla no negativa sobre un
+ *         subconjunto de variables binarias.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Clase que representa un factor φ(X_S) sobre un conjunto S de
+ *        variables binarias. Las variables se guardan ordenadas de menor a
+ *        mayor índice y el bit j de cada posición de la tabla es el valor de
+ *        la j-ésima variable, como en los histogramas de interés del motor.
+ *        Un factor sin variables es un escalar.
+ */
+class Factor {
+ public:
+  //-------------------------CONSTRUCTOR-------------------------
+  Factor();
+  Factor(std::vector<int>, std::vector<double>);
+
+  //-------------------------MÉTODOS-------------------------
+  const std::vector<int>& getVariables() const { return variables_; }
+  const std::vector<double>& getValues() const { return valores_; }
+  int getNumberVariables() const { return variables_.size(); }
+  uint64_t getSize() const { return valores_.size(); }
+  bool contains(int) const;
+  /// Método para obtener el valor del factor en un estado de hasta 64
+  /// variables (bit i = variable i)
+  double valueAt(uint64_t) const;
+
+  /// Operaciones de la eliminación de variables
+  Factor multiply(const Factor&) const;
+  Factor sumOut(int) const;
+  Factor reduce(int, int) const;
+  /// Método para anular las configuraciones incompatibles con la evidencia
+  /// conservando la variable (árboles de unión)
+  Factor observe(int, int) const;
+  /// Método para dividir el factor por su máximo (evita el desbordamiento
+  /// inferior en productos largos); devuelve el divisor aplicado
+  double rescale();
+  void scale(double);
+
+ private:
+  //-----------------ATRIBUTOS-----------------
+  /// variables_: Variables del factor en orden creciente
+  std::vector<int> variables_;
+  /// valores_: Valor del factor en cada una de las 2^|S| configuraciones
+  std::vector<double> valores_;
+
+  int position(int) const;
+};
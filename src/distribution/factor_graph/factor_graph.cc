@@ -0,0 +1,430 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   factor_graph.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase FactorGraph, que representa una
+ *         distribución conjunta como producto de factores.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include "factor_graph.h"
+#include "../binary_distribution/binary_distribution.h"
+
+/**
+ * @brief Constructor de un modelo sin factores (distribución uniforme sin
+ *        normalizar)
+ * @param[in] numero_variables: Número de variables binarias (N)
+ * @throws std::invalid_argument si el número de variables es menor que 1
+ */
+FactorGraph::FactorGraph(int numero_variables)
+    : numero_variables_(numero_variables) {
+  if (numero_variables <= 0) {
+    throw std::invalid_argument(
+        "Error: El número de variables debe ser al menos 1");
+  }
+}
+
+/**
+ * @brief Constructor que carga el modelo desde un archivo CSV de factores
+ *        (ver exportToCSV)
+ * @param[in] nombre_archivo: Ruta del archivo CSV
+ * @throws std::runtime_error si hay errores al leer el archivo o al parsear
+ *         su contenido
+ */
+FactorGraph::FactorGraph(const std::string& nombre_archivo)
+    : numero_variables_(0) {
+  loadFromCSV(nombre_archivo);
+}
+
+/**
+ * @brief Método para añadir un factor al modelo
+ * @param[in] factor: Factor sobre variables del modelo
+ * @throws std::invalid_argument si alguna variable está fuera de rango
+ */
+void FactorGraph::addFactor(Factor factor) {
+  for (int variable : factor.getVariables()) {
+    if (variable >= numero_variables_) {
+      throw std::invalid_argument(
+          "Variable fuera de rango: " + std::to_string(variable) +
+          " (Debe ser 0-" + std::to_string(numero_variables_ - 1) + ")");
+    }
+  }
+  factores_.push_back(std::move(factor));
+  version_++;
+}
+
+/**
+ * @brief Método para obtener el producto de los factores en un estado
+ *        completo (la probabilidad del estado si el modelo está normalizado)
+ * @param[in] indice: Estado (bit i = variable X_{i+1})
+ * @return Producto de los factores en el estado
+ * @throws std::logic_error si el modelo tiene más de 64 variables
+ * @throws std::out_of_range si el índice está fuera del rango válido
+ */
+double FactorGraph::getProbability(uint64_t indice) const {
+  if (numero_variables_ > 64) {
+    throw std::logic_error(
+        "Error: Los estados completos solo se indexan con N <= 64");
+  }
+  if (numero_variables_ < 64 && indice >= (1ULL << numero_variables_)) {
+    throw std::out_of_range("Error: Índice fuera de rango");
+  }
+  double producto = 1.0;
+  for (const Factor& factor : factores_) {
+    producto *= factor.valueAt(indice);
+  }
+  return producto;
+}
+
+/**
+ * @brief Un modelo factorizado no admite fijar la probabilidad de un estado
+ *        suelto sin romper la factorización
+ * @throws std::logic_error siempre
+ */
+void FactorGraph::setProbability(uint64_t, double) {
+  throw std::logic_error(
+      "Error: Un modelo factorizado no admite asignar estados sueltos "
+      "(usar addFactor)");
+}
+
+/**
+ * @brief Método para normalizar el modelo: la constante 1/Z se reparte por
+ *        igual entre los factores (en escala logarítmica, para que ninguno
+ *        desborde)
+ * @throws std::runtime_error si Z es cero
+ */
+void FactorGraph::normalize() {
+  double log_z = computeLogPartitionFunction();
+  if (!std::isfinite(log_z)) {
+    throw std::runtime_error(
+        "Error: No se puede normalizar, la suma de probabilidades es cero");
+  }
+  if (factores_.empty()) {
+    factores_.emplace_back(std::vector<int>{},
+                           std::vector<double>{std::exp(-log_z)});
+  } else {
+    double escala = std::exp(-log_z / factores_.size());
+    for (Factor& factor : factores_) {
+      factor.scale(escala);
+    }
+  }
+  version_++;
+}
+
+/**
+ * @brief Método para validar que el modelo esté normalizado
+ * @return true si Z = 1 dentro de la tolerancia
+ */
+bool FactorGraph::isValid() const {
+  return std::abs(std::expm1(computeLogPartitionFunction())) < EPSILON;
+}
+
+/**
+ * @brief Método para mostrar los factores del modelo en consola
+ */
+void FactorGraph::display() const {
+  std::cout << "=== Modelo Factorizado (N=" << numero_variables_
+            << ", factores=" << factores_.size() << ") ===" << std::endl;
+  std::cout << std::fixed << std::setprecision(6);
+  for (size_t k = 0; k < factores_.size(); ++k) {
+    const auto& variables = factores_[k].getVariables();
+    std::cout << "φ" << k + 1 << "(";
+    for (int j = variables.size() - 1; j >= 0; --j) {
+      std::cout << "X" << variables[j] + 1 << (j > 0 ? ", " : "");
+    }
+    std::cout << ")" << std::endl;
+    for (uint64_t i = 0; i < factores_[k].getSize(); ++i) {
+      std::cout << "  ";
+      for (int j = variables.size() - 1; j >= 0; --j) {
+        std::cout << ((i >> j) & 1);
+      }
+      std::cout << " | " << std::setw(10) << factores_[k].getValues()[i]
+                << std::endl;
+    }
+  }
+  std::cout << std::endl;
+}
+
+/**
+ * @brief Método para exportar el modelo a un archivo CSV: una línea
+ *        "variables,N" y, por cada factor, una línea "factor,<variables>"
+ *        seguida de sus filas "binario,valor" (el bit más a la izquierda es
+ *        la variable de mayor índice)
+ * @param[in] nombre_archivo: Ruta del archivo CSV de salida
+ * @throws std::runtime_error si no se puede abrir el archivo
+ */
+void FactorGraph::exportToCSV(const std::string& nombre_archivo) const {
+  std::ofstream archivo(nombre_archivo);
+  if (!archivo.is_open()) {
+    throw std::runtime_error("Error: No se puede abrir el archivo " +
+                             nombre_archivo);
+  }
+
+  archivo << "variables," << numero_variables_ << '\n';
+  archivo << std::setprecision(17);
+  for (const Factor& factor : factores_) {
+    const auto& variables = factor.getVariables();
+    archivo << "factor,";
+    for (size_t j = 0; j < variables.size(); ++j) {
+      archivo << (j > 0 ? " " : "") << variables[j];
+    }
+    archivo << '\n';
+    for (uint64_t i = 0; i < factor.getSize(); ++i) {
+      for (int j = variables.size() - 1; j >= 0; --j) {
+        archivo << ((i >> j) & 1);
+      }
+      archivo << ',' << factor.getValues()[i] << '\n';
+    }
+  }
+}
+
+/**
+ * @brief Método para calcular log Z, la constante de normalización del
+ *        producto de factores, eliminando todas las variables
+ * @param[in] heuristica: Heurística del orden de eliminación
+ * @return log Z (-infinito si Z = 0)
+ */
+double FactorGraph::computeLogPartitionFunction(
+    EliminationHeuristic heuristica) const {
+  std::vector<int> presentes;
+  for (const Factor& factor : factores_) {
+    presentes.insert(presentes.end(), factor.getVariables().begin(),
+                     factor.getVariables().end());
+  }
+  std::sort(presentes.begin(), presentes.end());
+  presentes.erase(std::unique(presentes.begin(), presentes.end()),
+                  presentes.end());
+
+  EliminationResult resultado = eliminate(
+      factores_, eliminationOrder(factores_, presentes, heuristica));
+  // Cada variable que no aparece en ningún factor suma sus dos valores
+  return std::log(resultado.factor.getValues()[0]) + resultado.log_escala +
+         (numero_variables_ - static_cast<int>(presentes.size())) *
+             std::log(2.0);
+}
+
+/**
+ * @brief Método para elegir un orden de eliminación con una heurística
+ *        voraz sobre el grafo de interacción de los factores (dos variables
+ *        son vecinas si comparten factor). Al eliminar una variable sus
+ *        vecinos quedan conectados entre sí.
+ * @param[in] factores: Factores del producto
+ * @param[in] variables: Variables a eliminar
+ * @param[in] heuristica: Criterio para elegir la siguiente variable
+ * @return Variables en el orden en que se deben eliminar
+ */
+std::vector<int> FactorGraph::eliminationOrder(
+    std::span<const Factor> factores, const std::vector<int>& variables,
+    EliminationHeuristic heuristica) {
+  int maximo = -1;
+  for (const Factor& factor : factores) {
+    if (factor.getNumberVariables() > 0) {
+      maximo = std::max(maximo, factor.getVariables().back());
+    }
+  }
+  for (int variable : variables) {
+    maximo = std::max(maximo, variable);
+  }
+  std::vector<std::set<int>> vecinos(maximo + 1);
+  for (const Factor& factor : factores) {
+    for (int a : factor.getVariables()) {
+      for (int b : factor.getVariables()) {
+        if (a != b) {
+          vecinos[a].insert(b);
+        }
+      }
+    }
+  }
+
+  // Aristas que añadiría eliminar la variable
+  auto relleno = [&](int variable) {
+    uint64_t aristas = 0;
+    for (auto a = vecinos[variable].begin(); a != vecinos[variable].end();
+         ++a) {
+      for (auto b = std::next(a); b != vecinos[variable].end(); ++b) {
+        aristas += vecinos[*a].count(*b) == 0;
+      }
+    }
+    return aristas;
+  };
+
+  std::vector<int> pendientes(variables);
+  std::vector<int> orden;
+  orden.reserve(pendientes.size());
+  while (!pendientes.empty()) {
+    size_t mejor = 0;
+    uint64_t mejor_coste = ~0ULL;
+    for (size_t i = 0; i < pendientes.size(); ++i) {
+      uint64_t grado = vecinos[pendientes[i]].size();
+      uint64_t coste = heuristica == EliminationHeuristic::kMinFill
+                           ? (relleno(pendientes[i]) << 16) | grado
+                           : grado;
+      if (coste < mejor_coste) {
+        mejor_coste = coste;
+        mejor = i;
+      }
+    }
+    int variable = pendientes[mejor];
+    pendientes.erase(pendientes.begin() + mejor);
+    orden.push_back(variable);
+
+    for (int a : vecinos[variable]) {
+      vecinos[a].erase(variable);
+      for (int b : vecinos[variable]) {
+        if (a != b) {
+          vecinos[a].insert(b);
+        }
+      }
+    }
+    vecinos[variable].clear();
+  }
+  return orden;
+}
+
+/**
+ * @brief Método para eliminar variables de un producto de factores: para
+ *        cada variable del orden se multiplican los factores que la
+ *        contienen y se suma sobre ella. Cada factor intermedio se divide por
+ *        su máximo para que los productos largos no desborden.
+ * @param[in] factores: Factores del producto (se consumen)
+ * @param[in] orden: Variables a eliminar, en orden
+ * @return Producto de los factores restantes sobre las variables no
+ *         eliminadas, escala extraída y coste
+ * @throws std::runtime_error si un factor intermedio supera
+ *         kMaximoVariablesIntermedio variables
+ */
+EliminationResult FactorGraph::eliminate(std::vector<Factor> factores,
+                                         const std::vector<int>& orden) {
+  EliminationResult resultado;
+  auto multiplicar = [&](auto primero, auto ultimo) {
+    std::set<int> variables;
+    for (auto factor = primero; factor != ultimo; ++factor) {
+      variables.insert(factor->getVariables().begin(),
+                       factor->getVariables().end());
+    }
+    if (static_cast<int>(variables.size()) > kMaximoVariablesIntermedio) {
+      throw std::runtime_error(
+          "Error: La eliminación genera un factor de " +
+          std::to_string(variables.size()) + " variables (máximo " +
+          std::to_string(kMaximoVariablesIntermedio) + ")");
+    }
+    Factor producto;
+    for (auto factor = primero; factor != ultimo; ++factor) {
+      producto = producto.multiply(*factor);
+    }
+    resultado.estados_evaluados += producto.getSize();
+    resultado.anchura =
+        std::max(resultado.anchura, producto.getNumberVariables());
+    return producto;
+  };
+
+  for (int variable : orden) {
+    auto con_variable = std::partition(
+        factores.begin(), factores.end(),
+        [variable](const Factor& factor) {
+          return !factor.contains(variable);
+        });
+    if (con_variable == factores.end()) {
+      continue;
+    }
+    Factor mensaje =
+        multiplicar(con_variable, factores.end()).sumOut(variable);
+    resultado.log_escala += std::log(mensaje.rescale());
+    factores.erase(con_variable, factores.end());
+    factores.push_back(std::move(mensaje));
+  }
+  resultado.factor = multiplicar(factores.begin(), factores.end());
+  return resultado;
+}
+
+/**
+ * @brief Método que carga el modelo desde un archivo CSV de factores
+ * @param[in] nombre_archivo: Ruta del archivo CSV
+ * @throws std::runtime_error si hay errores al leer el archivo o al parsear
+ *         su contenido
+ */
+void FactorGraph::loadFromCSV(const std::string& nombre_archivo) {
+  std::ifstream archivo(nombre_archivo);
+  if (!archivo.is_open()) {
+    throw std::runtime_error("No se puede abrir el archivo: " +
+                             nombre_archivo);
+  }
+
+  std::string linea;
+  std::vector<int> variables;
+  std::vector<double> valores;
+  bool abierto = false;
+  auto cerrarFactor = [&]() {
+    if (abierto) {
+      if (valores.size() != (1ULL << variables.size())) {
+        throw std::runtime_error(
+            "Número de filas inconsistente en el factor");
+      }
+      addFactor(Factor(variables, valores));
+    }
+  };
+
+  while (std::getline(archivo, linea)) {
+    if (linea.empty()) continue;
+
+    size_t posicion_coma = linea.find(',');
+    if (posicion_coma == std::string::npos) {
+      throw std::runtime_error("Formato CSV inválido: " + linea);
+    }
+    std::string clave = linea.substr(0, posicion_coma);
+    std::string resto = linea.substr(posicion_coma + 1);
+    if (clave == "variables") {
+      numero_variables_ = std::stoi(resto);
+      if (numero_variables_ <= 0) {
+        throw std::runtime_error("Número de variables inválido en CSV");
+      }
+    } else if (clave == "factor") {
+      if (numero_variables_ <= 0) {
+        throw std::runtime_error("Falta la línea 'variables,N' en CSV");
+      }
+      cerrarFactor();
+      variables.clear();
+      valores.clear();
+      std::istringstream lista(resto);
+      for (int variable; lista >> variable;) {
+        variables.push_back(variable);
+      }
+      abierto = true;
+    } else {
+      if (!abierto ||
+          clave.length() != variables.size() ||
+          clave.find_first_not_of("01") != std::string::npos) {
+        throw std::runtime_error("Formato CSV inválido: " + linea);
+      }
+      uint64_t indice = 0;
+      for (char bit : clave) {
+        indice = (indice << 1) | (bit == '1' ? 1 : 0);
+      }
+      if (indice != valores.size()) {
+        throw std::runtime_error(
+            "Las filas de cada factor deben ir en orden: " + linea);
+      }
+      valores.push_back(std::stod(resto));
+    }
+  }
+  cerrarFactor();
+
+  if (numero_variables_ <= 0) {
+    throw std::runtime_error("Archivo CSV vacío");
+  }
+}
@@ -0,0 +1,100 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   factor_graph.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase FactorGraph, que representa una
+ *         distribución conjunta como producto de factores.
+ */
+
+#pragma once
+
+#include <span>
+
+#include "../i_distribution.h"
+#include "factor.h"
+
+/**
+ * @brief Heurísticas para elegir el orden de eliminación de variables
+ */
+enum class EliminationHeuristic {
+  kMinDegree,  ///< Variable con menos vecinos en el grafo de interacción
+  kMinFill     ///< Variable cuya eliminación añade menos aristas
+};
+
+/**
+ * @brief Resultado de eliminar un conjunto de variables de un producto de
+ *        factores
+ */
+struct EliminationResult {
+  /// factor: Producto de los factores restantes, dividido por la escala
+  Factor factor;
+  /// log_escala: Logaritmo de la constante extraída al reescalar los
+  ///             factores intermedios (factor real = factor · e^log_escala)
+  double log_escala = 0.0;
+  /// estados_evaluados: Posiciones de todos los factores intermedios
+  uint64_t estados_evaluados = 0;
+  /// anchura: Máximo número de variables de un factor intermedio
+  int anchura = 0;
+};
+
+/**
+ * @brief Clase que representa una distribución conjunta sobre N variables
+ *        binarias como producto de factores, P(x) = (1/Z) Π_k φ_k(x_{S_k}).
+ *        La memoria crece con el tamaño de los factores y no con 2^N, de
+ *        modo que admite cientos de variables; las consultas se resuelven
+ *        por eliminación de variables (ver VariableEliminationEngine).
+ *
+ *        getProbability devuelve el producto de los factores, que es una
+ *        probabilidad después de normalize(). Los métodos que indexan
+ *        estados completos con uint64_t requieren N <= 64.
+ */
+class FactorGraph : public IDistribution {
+ public:
+  explicit FactorGraph(int);
+  explicit FactorGraph(const std::string&);
+  int getNumberVariables() const override { return numero_variables_; }
+  /// Número de estados 2^N (satura a 2^64 - 1 con N >= 64)
+  uint64_t getStateSpaceSize() const override {
+    return numero_variables_ >= 64 ? ~0ULL : 1ULL << numero_variables_;
+  }
+  const std::vector<Factor>& getFactors() const { return factores_; }
+  /// Método para obtener el contador de modificaciones del modelo
+  uint64_t getVersion() const { return version_; }
+  void addFactor(Factor);
+  double getProbability(uint64_t) const override;
+  void setProbability(uint64_t, double) override;
+  void normalize() override;
+  bool isValid() const override;
+  void display() const override;
+  void exportToCSV(const std::string&) const override;
+  /// Método para calcular el logaritmo de la constante de normalización Z
+  double computeLogPartitionFunction(
+      EliminationHeuristic = EliminationHeuristic::kMinFill) const;
+
+  /// Métodos de la eliminación de variables
+  static std::vector<int> eliminationOrder(std::span<const Factor>,
+                                           const std::vector<int>&,
+                                           EliminationHeuristic);
+  static EliminationResult eliminate(std::vector<Factor>,
+                                     const std::vector<int>&);
+
+ private:
+  //-----------------CONSTANTES-----------------
+  /// kMaximoVariablesIntermedio: Los factores intermedios tienen a lo sumo
+  ///                             2^30 posiciones (8 GB de doubles)
+  static constexpr int kMaximoVariablesIntermedio = 30;
+
+  int numero_variables_;
+  /// factores_: Factores cuyo producto es la distribución sin normalizar
+  std::vector<Factor> factores_;
+  uint64_t version_ = 0;
+
+  void loadFromCSV(const std::string&);
+};
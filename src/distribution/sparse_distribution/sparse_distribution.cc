@@ -0,0 +1,323 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   sparse_distribution.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase SparseDistribution, que representa una
+ *         distribución conjunta dispersa de variables binarias.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+
+#include "sparse_distribution.h"
+#include "../../bit_extractor/bit_extractor.h"
+#include "../../mapped_file/mapped_file.h"
+#include "../binary_distribution/csv_file_format.h"
+
+/**
+ * @brief Constructor que inicializa una distribución dispersa sin estados no
+ *        nulos
+ * @param[in] numero_variables: Número de variables binarias (N)
+ * @throws std::invalid_argument si el número de variables no está entre 1 y
+ *         63
+ */
+SparseDistribution::SparseDistribution(int numero_variables)
+    : numero_variables_(numero_variables) {
+  if (numero_variables <= 0 || numero_variables > 63) {
+    throw std::invalid_argument(
+        "Error: El número de variables debe estar entre 1 y 63");
+  }
+}
+
+/**
+ * @brief Constructor que carga la distribución desde un archivo CSV con el
+ *        mismo formato que BinaryDistribution. Las filas ausentes o con
+ *        probabilidad cero no ocupan memoria.
+ * @param[in] nombre_archivo: Ruta del archivo CSV
+ * @throws std::runtime_error si hay errores al leer el archivo o al parsear
+ *         su contenido
+ */
+SparseDistribution::SparseDistribution(const std::string& nombre_archivo) {
+  loadFromCSV(nombre_archivo);
+}
+
+/**
+ * @brief Constructor que extrae el soporte de una distribución densa
+ * @param[in] densa: Distribución densa de origen
+ */
+SparseDistribution::SparseDistribution(const BinaryDistribution& densa)
+    : SparseDistribution(densa.getNumberVariables()) {
+  for (uint64_t i = 0; i < densa.getStateSpaceSize(); ++i) {
+    double probabilidad = densa.getProbability(i);
+    if (probabilidad != 0.0) {
+      indices_.push_back(i);
+      valores_.push_back(probabilidad);
+    }
+  }
+}
+
+/**
+ * @brief Método para obtener la probabilidad de una configuración específica
+ * @param[in] indice: Índice de la configuración (codificación binaria)
+ * @return Probabilidad asociada (0 si el estado no está en el soporte)
+ * @throws std::out_of_range si el índice está fuera del rango válido
+ */
+double SparseDistribution::getProbability(uint64_t indice) const {
+  validateIndex(indice);
+  auto posicion = std::lower_bound(indices_.begin(), indices_.end(), indice);
+  if (posicion == indices_.end() || *posicion != indice) {
+    return 0.0;
+  }
+  return valores_[posicion - indices_.begin()];
+}
+
+/**
+ * @brief Método para establecer la probabilidad de una configuración
+ *        específica. Asignar 0 elimina el estado del soporte. Añadir o
+ *        eliminar un estado desplaza los posteriores (O(nnz)); las cargas
+ *        masivas deben pasar por los constructores, que ordenan una vez.
+ * @param[in] indice: Índice de la configuración (codificación binaria)
+ * @param[in] probabilidad: Probabilidad a asignar
+ * @throws std::out_of_range si el índice está fuera del rango válido
+ * @throws std::invalid_argument si la probabilidad no está en el rango [0, 1]
+ */
+void SparseDistribution::setProbability(uint64_t indice, double probabilidad) {
+  validateIndex(indice);
+  if (probabilidad < 0.0 || probabilidad > 1.0) {
+    throw std::invalid_argument(
+        "Error: La probabilidad debe estar entre 0 y 1");
+  }
+  auto posicion = std::lower_bound(indices_.begin(), indices_.end(), indice);
+  auto desplazamiento = posicion - indices_.begin();
+  bool presente = posicion != indices_.end() && *posicion == indice;
+  if (probabilidad == 0.0) {
+    if (presente) {
+      indices_.erase(posicion);
+      valores_.erase(valores_.begin() + desplazamiento);
+    }
+  } else if (presente) {
+    valores_[desplazamiento] = probabilidad;
+  } else {
+    indices_.insert(posicion, indice);
+    valores_.insert(valores_.begin() + desplazamiento, probabilidad);
+  }
+  version_++;
+}
+
+/**
+ * @brief Método para validar que la distribución esté correctamente normalizada
+ * @return true si la suma de las probabilidades es 1 (dentro de una tolerancia),
+ *         false en caso contrario
+ */
+bool SparseDistribution::isValid() const {
+  double suma = 0.0;
+  for (double probabilidad : valores_) {
+    if (probabilidad < -EPSILON || probabilidad > 1.0 + EPSILON) {
+      return false;
+    }
+    suma += probabilidad;
+  }
+  return std::abs(suma - 1.0) < EPSILON;
+}
+
+/**
+ * @brief Método para normalizar la distribución
+ * @throws std::runtime_error si la suma de las probabilidades es cero
+ *         (no se puede normalizar)
+ */
+void SparseDistribution::normalize() {
+  double suma = std::accumulate(valores_.begin(), valores_.end(), 0.0);
+  if (suma < EPSILON) {
+    throw std::runtime_error(
+        "Error: No se puede normalizar, la suma de probabilidades es cero");
+  }
+  for (double& probabilidad : valores_) {
+    probabilidad /= suma;
+  }
+  version_++;
+}
+
+/**
+ * @brief Método para mostrar en consola los estados no nulos
+ */
+void SparseDistribution::display() const {
+  std::cout << "=== Distribución Binaria Dispersa (N=" << numero_variables_
+            << ", no nulos=" << indices_.size() << ") ===" << std::endl;
+  std::cout << std::fixed << std::setprecision(6);
+
+  std::cout << "Config   |";
+  for (int i = numero_variables_ - 1; i >= 0; i--) {
+    std::cout << " X" << (i + 1);
+  }
+  std::cout << " | Probabilidad" << std::endl;
+  std::cout << std::string(10 + numero_variables_ * 3 + 15, '-')
+            << std::endl;
+
+  for (size_t i = 0; i < indices_.size(); ++i) {
+    if (valores_[i] > EPSILON) {
+      std::string binario = indexToBinary(indices_[i]);
+      std::cout << std::setw(8) << binario << " |";
+      for (char bit : binario) {
+        std::cout << "  " << bit;
+      }
+      std::cout << " | " << std::setw(10) << valores_[i] << std::endl;
+    }
+  }
+  std::cout << std::endl;
+
+  std::cout << "Suma total de probabilidades: "
+            << std::accumulate(valores_.begin(), valores_.end(), 0.0)
+            << std::endl;
+}
+
+/**
+ * @brief Método para exportar los estados no nulos a un archivo CSV (los
+ *        estados ausentes se leen como probabilidad cero)
+ * @param[in] nombre_archivo: Ruta del archivo CSV de salida
+ * @throws std::runtime_error si no se puede abrir el archivo
+ */
+void SparseDistribution::exportToCSV(const std::string& nombre_archivo) const {
+  std::ofstream archivo(nombre_archivo);
+  if (!archivo.is_open()) {
+    throw std::runtime_error("Error: No se puede abrir el archivo " +
+                             nombre_archivo);
+  }
+
+  archivo << std::fixed << std::setprecision(10);
+  for (size_t i = 0; i < indices_.size(); ++i) {
+    archivo << indexToBinary(indices_[i]) << "," << valores_[i] << '\n';
+  }
+}
+
+/**
+ * @brief Método para acumular en salida la masa (sin normalizar) de cada
+ *        estado de interés consistente con la evidencia. Los bits más altos
+ *        fijados por la evidencia delimitan por búsqueda binaria el tramo de
+ *        índices a recorrer; el resto de la evidencia se comprueba por estado.
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] maskI: Máscara de variables de interés
+ * @param[out] salida: Histograma de 2^|I| posiciones inicializado a cero
+ * @return Número de estados no nulos recorridos
+ */
+uint64_t SparseDistribution::marginalize(uint64_t maskC, uint64_t valC,
+                                         uint64_t maskI,
+                                         double* salida) const {
+  int bits_fijos_altos = std::countl_one(maskC << (64 - numero_variables_));
+  bits_fijos_altos = std::min(bits_fijos_altos, numero_variables_);
+  auto primero = indices_.begin();
+  auto ultimo = indices_.end();
+  if (bits_fijos_altos > 0) {
+    int bits_bajos = numero_variables_ - bits_fijos_altos;
+    uint64_t inicio = (valC >> bits_bajos) << bits_bajos;
+    primero = std::lower_bound(indices_.begin(), indices_.end(), inicio);
+    ultimo = std::lower_bound(primero, indices_.end(),
+                              inicio + (1ULL << bits_bajos));
+  }
+
+  BitExtractor extractor(maskI);
+  for (auto posicion = primero; posicion != ultimo; ++posicion) {
+    uint64_t estado = *posicion;
+    if ((estado & maskC) == valC) {
+      salida[extractor.extract(estado)] +=
+          valores_[posicion - indices_.begin()];
+    }
+  }
+  return ultimo - primero;
+}
+
+/**
+ * @brief Método que carga la distribución desde un archivo CSV. El archivo se
+ *        proyecta en memoria y sus filas no nulas se recogen como pares
+ *        (índice, probabilidad) que se ordenan una sola vez (nada si el
+ *        archivo ya está ordenado, como los que escribe exportToCSV).
+ * @param[in] nombre_archivo: Ruta del archivo CSV
+ * @throws std::runtime_error si hay errores al leer el archivo o al parsear
+ *         su contenido
+ */
+void SparseDistribution::loadFromCSV(const std::string& nombre_archivo) {
+  std::unique_ptr<MappedFile> archivo;
+  try {
+    archivo = std::make_unique<MappedFile>(nombre_archivo);
+  } catch (const std::runtime_error&) {
+    throw std::runtime_error("No se puede abrir el archivo: " +
+                             nombre_archivo);
+  }
+  const char* inicio = reinterpret_cast<const char*>(archivo->getData());
+  const char* fin = inicio + archivo->getSize();
+  numero_variables_ = csvNumberVariables(inicio, fin);
+
+  std::vector<std::pair<uint64_t, double>> datos;
+  forEachCSVRow(inicio, fin, fin, numero_variables_,
+                [&](uint64_t indice, double probabilidad) {
+                  datos.emplace_back(indice, probabilidad);
+                });
+
+  // Si un estado aparece repetido prevalece su última fila
+  auto porIndice = [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  };
+  if (!std::is_sorted(datos.begin(), datos.end(), porIndice)) {
+    std::stable_sort(datos.begin(), datos.end(), porIndice);
+  }
+  indices_.reserve(datos.size());
+  valores_.reserve(datos.size());
+  for (const auto& [indice, probabilidad] : datos) {
+    if (!indices_.empty() && indices_.back() == indice) {
+      valores_.back() = probabilidad;
+    } else {
+      indices_.push_back(indice);
+      valores_.push_back(probabilidad);
+    }
+  }
+  // Las filas con probabilidad cero no ocupan memoria
+  size_t escritos = 0;
+  for (size_t i = 0; i < indices_.size(); ++i) {
+    if (valores_[i] != 0.0) {
+      indices_[escritos] = indices_[i];
+      valores_[escritos] = valores_[i];
+      ++escritos;
+    }
+  }
+  indices_.resize(escritos);
+  valores_.resize(escritos);
+}
+
+/**
+ * @brief Método que comprueba que un índice pertenece al espacio de estados
+ * @param[in] indice: Índice de la configuración
+ * @throws std::out_of_range si el índice está fuera del rango válido
+ */
+void SparseDistribution::validateIndex(uint64_t indice) const {
+  if (indice >= getStateSpaceSize()) {
+    throw std::out_of_range("Error: Índice fuera de rango");
+  }
+}
+
+/**
+ * @brief Método para convertir un índice numérico a su representación binaria
+ * @param[in] indice: Índice numérico a convertir
+ * @return Cadena de N caracteres con la representación binaria del índice
+ */
+std::string SparseDistribution::indexToBinary(uint64_t indice) const {
+  std::string binario(numero_variables_, '0');
+  for (int i = numero_variables_ - 1; i >= 0; --i) {
+    binario[i] = (indice & 1) ? '1' : '0';
+    indice >>= 1;
+  }
+  return binario;
+}
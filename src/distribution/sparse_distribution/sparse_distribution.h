@@ -0,0 +1,69 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   sparse_distribution.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase SparseDistribution, que representa una
+ *         distribución conjunta de variables binarias con pocos estados de
+ *         probabilidad no nula.
+ */
+
+#pragma once
+
+#include "../i_distribution.h"
+#include "../binary_distribution/binary_distribution.h"
+
+/**
+ * @brief Clase que representa una distribución conjunta dispersa: solo se
+ *        almacenan los estados con probabilidad no nula, como un vector de
+ *        índices ordenado y sus valores. La memoria crece con el soporte y no
+ *        con 2^N. Una consulta cuesta O(log nnz + k), donde k son los estados
+ *        cuyos bits altos coinciden con la evidencia: si la evidencia fija
+ *        las variables más altas, k se reduce a su tramo del soporte; si no
+ *        fija X_N, se recorre el soporte entero (O(nnz)).
+ */
+class SparseDistribution : public IDistribution {
+ public:
+  explicit SparseDistribution(int);
+  explicit SparseDistribution(const std::string&);
+  explicit SparseDistribution(const BinaryDistribution&);
+  int getNumberVariables() const override { return numero_variables_; }
+  uint64_t getStateSpaceSize() const override {
+    return 1ULL << numero_variables_;
+  }
+  /// Número de estados con probabilidad no nula
+  uint64_t getNumberNonZero() const { return indices_.size(); }
+  /// Índices (ordenados) y probabilidades de los estados no nulos
+  const std::vector<uint64_t>& getIndices() const { return indices_; }
+  const std::vector<double>& getValues() const { return valores_; }
+  /// Método para obtener el contador de modificaciones de la distribución
+  uint64_t getVersion() const { return version_; }
+  double getProbability(uint64_t) const override;
+  void setProbability(uint64_t, double) override;
+  void normalize() override;
+  bool isValid() const override;
+  void display() const override;
+  void exportToCSV(const std::string&) const override;
+
+  /// Método para acumular la masa de cada estado de interés consistente con
+  /// la evidencia (histograma sin normalizar)
+  uint64_t marginalize(uint64_t, uint64_t, uint64_t, double*) const;
+
+ private:
+  int numero_variables_;
+  /// indices_: Estados con probabilidad no nula, en orden creciente
+  std::vector<uint64_t> indices_;
+  /// valores_: Probabilidad de cada estado de indices_
+  std::vector<double> valores_;
+  uint64_t version_ = 0;
+
+  void loadFromCSV(const std::string&);
+  void validateIndex(uint64_t) const;
+  std::string indexToBinary(uint64_t) const;
+};
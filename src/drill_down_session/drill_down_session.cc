@@ -0,0 +1,209 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   drill_down_session.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase DrillDownSession, que resuelve
+ *         consultas sobre la rebanada de la evidencia acumulada paso a paso.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#include "drill_down_session.h"
+
+/**
+ * @brief Constructor que abre una sesión sin evidencia sobre una distribución
+ * @param[in] distribucion: Distribución conjunta original
+ * @param[in] numero_hilos: Número de hilos de las copias y de las consultas
+ */
+DrillDownSession::DrillDownSession(const BinaryDistribution& distribucion,
+                                   int numero_hilos)
+    : distribucion_(distribucion),
+      numero_hilos_(std::max(1, numero_hilos)),
+      version_(distribucion.getVersion()),
+      motor_base_(std::make_unique<ConditionalInferenceEngine>(
+          distribucion, numero_hilos_)),
+      maskC_(0),
+      valC_(0) {}
+
+/**
+ * @brief Método para añadir una variable a la evidencia. La nueva rebanada se
+ *        obtiene de la actual, por lo que cuesta la mitad que el paso
+ *        anterior.
+ * @param[in] variable: Índice de la variable original (0..N-1)
+ * @param[in] valor: Valor observado (0 o 1)
+ * @throws std::invalid_argument si la variable no existe, ya forma parte de
+ *         la evidencia o es la última variable libre
+ */
+void DrillDownSession::addEvidence(int variable, int valor) {
+  if (variable < 0 || variable >= distribucion_.getNumberVariables()) {
+    throw std::invalid_argument("Error: Variable fuera de rango");
+  }
+  if (maskC_ & (1ULL << variable)) {
+    throw std::invalid_argument(
+        "Error: La variable ya forma parte de la evidencia");
+  }
+  rebuildIfStale();
+  pasos_.push_back(makeStep(variable, valor));
+  maskC_ |= 1ULL << variable;
+  valC_ |= static_cast<uint64_t>(valor) << variable;
+}
+
+/**
+ * @brief Método para deshacer el último paso de la sesión
+ * @throws std::logic_error si la sesión no tiene evidencia
+ */
+void DrillDownSession::backtrack() {
+  if (pasos_.empty()) {
+    throw std::logic_error("Error: La sesión no tiene evidencia");
+  }
+  backtrackTo(getDepth() - 1);
+}
+
+/**
+ * @brief Método para volver a un paso anterior descartando las rebanadas
+ *        posteriores (no se recalcula nada)
+ * @param[in] profundidad: Número de pasos que se conservan
+ * @throws std::out_of_range si la profundidad no es la de un paso existente
+ */
+void DrillDownSession::backtrackTo(int profundidad) {
+  if (profundidad < 0 || profundidad > getDepth()) {
+    throw std::out_of_range("Error: Paso inexistente");
+  }
+  while (getDepth() > profundidad) {
+    uint64_t bit = 1ULL << pasos_.back().variable;
+    maskC_ &= ~bit;
+    valC_ &= ~bit;
+    pasos_.pop_back();
+  }
+}
+
+/**
+ * @brief Método para obtener el tamaño de la rebanada actual
+ * @return Número de estados (2^(N - profundidad))
+ */
+uint64_t DrillDownSession::getWorkingSetSize() const {
+  return currentSlice().getStateSpaceSize();
+}
+
+/**
+ * @brief Método para calcular una distribución condicional con la evidencia
+ *        de la sesión. Las condiciones de la consulta sobre variables de la
+ *        sesión deben coincidir con ella; el resto se añade a la evidencia
+ *        solo para esta consulta.
+ * @param[in] consulta: Consulta sobre las variables originales (con las
+ *                      máscaras calculadas)
+ * @return Distribución P(X_I | X_C = c, evidencia) sobre las variables de
+ *         interés, en el mismo orden que el motor de inferencia
+ * @throws std::invalid_argument si la consulta no corresponde a la
+ *         distribución, pregunta por una variable de la evidencia o
+ *         contradice la evidencia de la sesión
+ */
+InferenceResult DrillDownSession::computeConditional(
+    const ConditionalQuery& consulta) {
+  int numero_variables = distribucion_.getNumberVariables();
+  uint64_t variables = consulta.getMaskC() | consulta.getMaskI();
+  if (numero_variables < 64 && (variables >> numero_variables) != 0) {
+    throw std::invalid_argument(
+        "Error: La consulta no corresponde a la distribución");
+  }
+  if (consulta.getMaskI() & maskC_) {
+    throw std::invalid_argument(
+        "Error: Variable de interés incluida en la evidencia de la sesión");
+  }
+  uint64_t comunes = consulta.getMaskC() & maskC_;
+  if ((consulta.getValC() & comunes) != (valC_ & comunes)) {
+    throw std::invalid_argument(
+        "Error: La consulta contradice la evidencia de la sesión");
+  }
+  rebuildIfStale();
+
+  const BinaryDistribution& rebanada = currentSlice();
+  ConditionalQuery traducida(rebanada.getNumberVariables());
+  for (int variable : consulta.getInterestVariables()) {
+    traducida.addInterestVariable(sliceIndex(variable));
+  }
+  const auto& condicionadas = consulta.getConditionedVariables();
+  const auto& valores = consulta.getConditionedValues();
+  for (size_t i = 0; i < condicionadas.size(); ++i) {
+    if (!(maskC_ & (1ULL << condicionadas[i]))) {
+      traducida.addConditionedVariable(sliceIndex(condicionadas[i]),
+                                       valores[i]);
+    }
+  }
+  traducida.computeMasks();
+  return currentEngine().computeConditional(traducida);
+}
+
+/**
+ * @brief Método para obtener la distribución del paso actual
+ * @return Rebanada del último paso o la distribución original
+ */
+const BinaryDistribution& DrillDownSession::currentSlice() const {
+  return pasos_.empty() ? distribucion_ : *pasos_.back().rebanada;
+}
+
+/**
+ * @brief Método para obtener el motor de inferencia del paso actual
+ * @return Motor sobre la rebanada actual
+ */
+ConditionalInferenceEngine& DrillDownSession::currentEngine() {
+  return pasos_.empty() ? *motor_base_ : *pasos_.back().motor;
+}
+
+/**
+ * @brief Método para traducir una variable original a su índice en la
+ *        rebanada actual (las variables restantes conservan su orden)
+ * @param[in] variable: Variable original que no forma parte de la evidencia
+ * @return Índice de la variable en la rebanada
+ */
+int DrillDownSession::sliceIndex(int variable) const {
+  return variable - std::popcount(maskC_ & ((1ULL << variable) - 1));
+}
+
+/**
+ * @brief Método para construir el paso que fija una variable a partir de la
+ *        rebanada actual
+ * @param[in] variable: Variable original que se fija
+ * @param[in] valor: Valor observado
+ * @return Paso con la nueva rebanada y su motor
+ * @throws std::invalid_argument si el valor no es 0 o 1 o no quedan
+ *         variables libres
+ */
+DrillDownSession::Step DrillDownSession::makeStep(int variable,
+                                                  int valor) const {
+  auto rebanada = std::make_unique<BinaryDistribution>(
+      currentSlice().slice(sliceIndex(variable), valor, numero_hilos_));
+  auto motor =
+      std::make_unique<ConditionalInferenceEngine>(*rebanada, numero_hilos_);
+  return Step{variable, valor, std::move(rebanada), std::move(motor)};
+}
+
+/**
+ * @brief Método para reconstruir las rebanadas si la distribución original
+ *        ha cambiado desde que se calcularon, repitiendo la evidencia
+ */
+void DrillDownSession::rebuildIfStale() {
+  if (distribucion_.getVersion() == version_) {
+    return;
+  }
+  std::vector<std::pair<int, int>> evidencia;
+  for (const Step& paso : pasos_) {
+    evidencia.emplace_back(paso.variable, paso.valor);
+  }
+  backtrackTo(0);
+  motor_base_ = std::make_unique<ConditionalInferenceEngine>(distribucion_,
+                                                             numero_hilos_);
+  version_ = distribucion_.getVersion();
+  for (auto [variable, valor] : evidencia) {
+    addEvidence(variable, valor);
+  }
+}
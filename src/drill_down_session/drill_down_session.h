@@ -0,0 +1,97 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   drill_down_session.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase DrillDownSession, que resuelve consultas
+ *         sobre la rebanada de la evidencia acumulada paso a paso.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../conditional_inference_engine/conditional_inference_engine.h"
+#include "../conditional_query/conditional_query.h"
+#include "../distribution/binary_distribution/binary_distribution.h"
+
+/**
+ * @brief Clase que acompaña un análisis en el que la evidencia se añade de
+ *        variable en variable (X3 = 1, después X7 = 0, ...). Cada paso guarda
+ *        la rebanada de la distribución consistente con toda la evidencia
+ *        acumulada, compactada a partir de la rebanada del paso anterior
+ *        (BinaryDistribution::slice), así que cada nueva variable reduce a
+ *        la mitad el trabajo en lugar de volver a partir de 2^N estados. El
+ *        paso 0 consulta la distribución original sin copiarla.
+ *
+ *        Volver a un paso anterior solo descarta las rebanadas posteriores.
+ *        Todas las rebanadas juntas ocupan menos que la tabla original. Si la
+ *        distribución original cambia (otra versión), las rebanadas se
+ *        reconstruyen en la siguiente consulta.
+ */
+class DrillDownSession {
+ public:
+  //-------------------------CONSTRUCTOR-------------------------
+  explicit DrillDownSession(const BinaryDistribution&, int = 1);
+
+  //-------------------------MÉTODOS-------------------------
+  /// Método para añadir X_variable = valor a la evidencia de la sesión
+  void addEvidence(int, int);
+  /// Métodos para deshacer el último paso o volver a una profundidad dada
+  /// (0 = sin evidencia)
+  void backtrack();
+  void backtrackTo(int);
+  int getDepth() const { return static_cast<int>(pasos_.size()); }
+  /// Máscara y valores de la evidencia acumulada (variables originales)
+  uint64_t getEvidenceMask() const { return maskC_; }
+  uint64_t getEvidenceValues() const { return valC_; }
+  /// Número de estados de la rebanada del paso actual
+  uint64_t getWorkingSetSize() const;
+  /// Método para calcular P(X_I | X_C = c, evidencia de la sesión) sobre la
+  /// rebanada actual; la consulta usa las variables originales
+  InferenceResult computeConditional(const ConditionalQuery&);
+
+ private:
+  /**
+   * @brief Paso del análisis: evidencia añadida y rebanada resultante
+   */
+  struct Step {
+    /// variable, valor: Evidencia añadida en este paso
+    int variable;
+    int valor;
+    /// rebanada: Distribución consistente con la evidencia hasta este paso
+    std::unique_ptr<BinaryDistribution> rebanada;
+    /// motor: Motor de inferencia sobre la rebanada
+    std::unique_ptr<ConditionalInferenceEngine> motor;
+  };
+
+  //-----------------MÉTODOS PRIVADOS-----------------
+  const BinaryDistribution& currentSlice() const;
+  ConditionalInferenceEngine& currentEngine();
+  int sliceIndex(int) const;
+  Step makeStep(int, int) const;
+  void rebuildIfStale();
+
+  //-----------------ATRIBUTOS-----------------
+  /// distribucion_: Distribución original (paso 0)
+  const BinaryDistribution& distribucion_;
+  /// numero_hilos_: Número de hilos de las copias y de las consultas
+  int numero_hilos_;
+  /// version_: Versión de la distribución original de las rebanadas
+  uint64_t version_;
+  /// motor_base_: Motor de inferencia sobre la distribución original
+  std::unique_ptr<ConditionalInferenceEngine> motor_base_;
+  /// pasos_: Pasos del análisis, del primero al actual
+  std::vector<Step> pasos_;
+  /// maskC_, valC_: Evidencia acumulada sobre las variables originales
+  uint64_t maskC_;
+  uint64_t valC_;
+};
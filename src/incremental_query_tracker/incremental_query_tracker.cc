@@ -0,0 +1,324 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   incremental_query_tracker.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase IncrementalQueryTracker, que mantiene
+ *         las respuestas de consultas suscritas mientras se modifican
+ *         probabilidades de la distribución conjunta.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+#include "incremental_query_tracker.h"
+#include "../parallel_executor/parallel_executor.h"
+
+/**
+ * @brief Constructor que asocia el seguidor a una distribución
+ * @param[in] distribucion: Distribución conjunta que se va a modificar a
+ *                          través del seguidor
+ * @param[in] numero_hilos: Número de hilos de los recorridos completos
+ *                          (suscripción y resincronización)
+ */
+IncrementalQueryTracker::IncrementalQueryTracker(
+    BinaryDistribution& distribucion, int numero_hilos)
+    : distribucion_(distribucion),
+      numero_hilos_(std::max(1, numero_hilos)),
+      version_(distribucion.getVersion()) {}
+
+/**
+ * @brief Método para suscribir una consulta. Sus numeradores y su
+ *        normalizador se inicializan con un recorrido del subcubo de la
+ *        evidencia; a partir de ahí se mantienen con cada cambio.
+ * @param[in] consulta: Consulta con las máscaras calculadas
+ * @return Identificador de la suscripción
+ * @throws std::invalid_argument si la consulta no es válida, no corresponde
+ *         a la distribución o tiene demasiadas variables de interés
+ */
+int IncrementalQueryTracker::subscribe(const ConditionalQuery& consulta) {
+  int numero_variables = distribucion_.getNumberVariables();
+  uint64_t variables = consulta.getMaskC() | consulta.getMaskI();
+  if (!consulta.isValid() || consulta.getMaskI() == 0 ||
+      (numero_variables < 64 && (variables >> numero_variables) != 0)) {
+    throw std::invalid_argument(
+        "Error: La consulta no corresponde a la distribución");
+  }
+  if (consulta.getNumberInterestVariables() > kMaximoVariablesInteres) {
+    throw std::invalid_argument(
+        "Error: Demasiadas variables de interés para una suscripción");
+  }
+  synchronizeIfStale();
+
+  uint64_t estados_interes = 1ULL << consulta.getNumberInterestVariables();
+  suscripciones_.push_back(Subscription{
+      consulta.getMaskC(), consulta.getValC(), consulta.getMaskI(),
+      BitExtractor(consulta.getMaskI()),
+      std::vector<CompensatedSum>(estados_interes), CompensatedSum{},
+      std::vector<double>(estados_interes)});
+  scan(suscripciones_.back());
+  return static_cast<int>(suscripciones_.size()) - 1;
+}
+
+/**
+ * @brief Método para cancelar una suscripción y liberar su memoria
+ * @param[in] identificador: Identificador devuelto por subscribe
+ * @throws std::out_of_range si la suscripción no existe
+ */
+void IncrementalQueryTracker::unsubscribe(int identificador) {
+  Subscription& suscripcion = findSubscription(identificador);
+  suscripcion.activa = false;
+  suscripcion.numeradores = {};
+  suscripcion.resultado = {};
+}
+
+/**
+ * @brief Método para contar las suscripciones activas
+ * @return Número de suscripciones no canceladas
+ */
+int IncrementalQueryTracker::getNumberSubscriptions() const {
+  return std::count_if(
+      suscripciones_.begin(), suscripciones_.end(),
+      [](const Subscription& suscripcion) { return suscripcion.activa; });
+}
+
+/**
+ * @brief Método para establecer la probabilidad de un estado y actualizar
+ *        las suscripciones cuya evidencia contiene el estado
+ * @param[in] estado: Configuración lógica
+ * @param[in] probabilidad: Nueva probabilidad
+ * @throws std::out_of_range o std::invalid_argument en los mismos casos que
+ *         BinaryDistribution::setProbability
+ */
+void IncrementalQueryTracker::setProbability(uint64_t estado,
+                                             double probabilidad) {
+  synchronizeIfStale();
+  double anterior = distribucion_.getProbability(estado);
+  distribucion_.setProbability(estado, probabilidad);
+  // Con almacenamiento reducido el cambio real es el del valor redondeado
+  recordChange(estado, distribucion_.getProbability(estado) - anterior);
+  version_ = distribucion_.getVersion();
+}
+
+/**
+ * @brief Método para aplicar un lote de cambios aditivos. Los cambios de un
+ *        mismo estado se acumulan y se comprueban todos antes de escribir
+ *        ninguno, de modo que un lote inválido no modifica la distribución.
+ *        Solo se leen y escriben los estados del lote.
+ * @param[in] cambios: Cambios a aplicar
+ * @throws std::out_of_range si algún estado está fuera de rango
+ * @throws std::invalid_argument si alguna probabilidad resultante queda
+ *         fuera de [0, 1]
+ */
+void IncrementalQueryTracker::applyDeltas(
+    std::span<const ProbabilityDelta> cambios) {
+  synchronizeIfStale();
+  std::vector<ProbabilityDelta> ordenados(cambios.begin(), cambios.end());
+  std::stable_sort(ordenados.begin(), ordenados.end(),
+                   [](const ProbabilityDelta& a, const ProbabilityDelta& b) {
+                     return a.estado < b.estado;
+                   });
+
+  // nuevos[k] = {estado, probabilidad anterior, probabilidad nueva}
+  struct Change {
+    uint64_t estado;
+    double anterior;
+    double nueva;
+  };
+  std::vector<Change> nuevos;
+  for (size_t i = 0; i < ordenados.size();) {
+    uint64_t estado = ordenados[i].estado;
+    double delta = 0.0;
+    for (; i < ordenados.size() && ordenados[i].estado == estado; ++i) {
+      delta += ordenados[i].delta;
+    }
+    double anterior = distribucion_.getProbability(estado);
+    double nueva = anterior + delta;
+    if (nueva < -EPSILON || nueva > 1.0 + EPSILON || std::isnan(nueva)) {
+      throw std::invalid_argument(
+          "Error: El cambio deja una probabilidad fuera de [0, 1]");
+    }
+    nuevos.push_back({estado, anterior, std::clamp(nueva, 0.0, 1.0)});
+  }
+
+  for (const Change& cambio : nuevos) {
+    distribucion_.setProbability(cambio.estado, cambio.nueva);
+    recordChange(cambio.estado,
+                 distribucion_.getProbability(cambio.estado) - cambio.anterior);
+  }
+  version_ = distribucion_.getVersion();
+}
+
+/**
+ * @brief Método para obtener la distribución condicional de una suscripción.
+ *        Si la evidencia no tiene masa se devuelven los numeradores sin
+ *        normalizar, igual que el motor de inferencia.
+ * @param[in] identificador: Identificador devuelto por subscribe
+ * @return Vista de P(X_I | X_C = c), indexada por los bits de interés
+ *         compactados
+ * @throws std::out_of_range si la suscripción no existe
+ */
+std::span<const double> IncrementalQueryTracker::getResult(int identificador) {
+  synchronizeIfStale();
+  Subscription& suscripcion = findSubscription(identificador);
+  if (!suscripcion.resultado_actualizado) {
+    double normalizador = suscripcion.normalizador.value();
+    for (size_t i = 0; i < suscripcion.numeradores.size(); ++i) {
+      double numerador = suscripcion.numeradores[i].value();
+      suscripcion.resultado[i] =
+          normalizador > 1e-10 ? numerador / normalizador : numerador;
+    }
+    suscripcion.resultado_actualizado = true;
+  }
+  return suscripcion.resultado;
+}
+
+/**
+ * @brief Método para obtener la masa de la evidencia de una suscripción
+ * @param[in] identificador: Identificador devuelto por subscribe
+ * @return Suma de las probabilidades de los estados con X_C = c
+ * @throws std::out_of_range si la suscripción no existe
+ */
+double IncrementalQueryTracker::getEvidenceMass(int identificador) {
+  synchronizeIfStale();
+  return findSubscription(identificador).normalizador.value();
+}
+
+/**
+ * @brief Método para recalcular todas las suscripciones activas con un
+ *        recorrido de su subcubo, descartando el estado acumulado
+ */
+void IncrementalQueryTracker::resynchronize() {
+  for (Subscription& suscripcion : suscripciones_) {
+    if (suscripcion.activa) {
+      scan(suscripcion);
+    }
+  }
+  version_ = distribucion_.getVersion();
+}
+
+/**
+ * @brief Método para acumular un valor con compensación de Neumaier: el error
+ *        de redondeo de cada suma se guarda aparte y se añade al final
+ * @param[in] valor: Valor a acumular
+ */
+void IncrementalQueryTracker::CompensatedSum::add(double valor) {
+  double total = suma + valor;
+  if (std::abs(suma) >= std::abs(valor)) {
+    compensacion += (suma - total) + valor;
+  } else {
+    compensacion += (valor - total) + suma;
+  }
+  suma = total;
+}
+
+/**
+ * @brief Método para buscar una suscripción activa
+ * @param[in] identificador: Identificador devuelto por subscribe
+ * @return Referencia a la suscripción
+ * @throws std::out_of_range si no existe o se canceló
+ */
+IncrementalQueryTracker::Subscription&
+IncrementalQueryTracker::findSubscription(int identificador) {
+  if (identificador < 0 ||
+      identificador >= static_cast<int>(suscripciones_.size()) ||
+      !suscripciones_[identificador].activa) {
+    throw std::out_of_range("Error: Suscripción inexistente");
+  }
+  return suscripciones_[identificador];
+}
+
+/**
+ * @brief Método para recalcular las suscripciones si la distribución se ha
+ *        modificado sin pasar por el seguidor
+ */
+void IncrementalQueryTracker::synchronizeIfStale() {
+  if (distribucion_.getVersion() != version_) {
+    resynchronize();
+  }
+}
+
+/**
+ * @brief Método para propagar el cambio de un estado a las suscripciones
+ *        cuya evidencia lo contiene
+ * @param[in] estado: Configuración lógica modificada
+ * @param[in] delta: Cambio de su probabilidad
+ */
+void IncrementalQueryTracker::recordChange(uint64_t estado, double delta) {
+  if (delta == 0.0) {
+    return;
+  }
+  for (Subscription& suscripcion : suscripciones_) {
+    if (suscripcion.activa &&
+        (estado & suscripcion.maskC) == suscripcion.valC) {
+      suscripcion.numeradores[suscripcion.extractor.extract(estado)].add(delta);
+      suscripcion.normalizador.add(delta);
+      suscripcion.resultado_actualizado = false;
+    }
+  }
+}
+
+/**
+ * @brief Método para inicializar una suscripción recorriendo el subcubo de
+ *        su evidencia en el orden físico de la tabla. El subcubo se divide en
+ *        un número de tramos que no depende de los hilos, cada tramo acumula
+ *        su propio histograma y los histogramas se suman en orden, así que
+ *        el resultado es el mismo con cualquier número de hilos.
+ * @param[in,out] suscripcion: Suscripción a recalcular
+ */
+void IncrementalQueryTracker::scan(Subscription& suscripcion) const {
+  uint64_t todas = distribucion_.getNumberVariables() == 64
+                       ? ~0ULL
+                       : (1ULL << distribucion_.getNumberVariables()) - 1;
+  BitExtractor libres(distribucion_.toPhysicalState(todas & ~suscripcion.maskC));
+  BitExtractor interes(distribucion_.toPhysicalState(suscripcion.maskI));
+  uint64_t base = distribucion_.toPhysicalState(suscripcion.valC);
+
+  // Con un orden físico permutado los bits de interés aparecen en otro
+  // orden: se traduce cada índice compacto físico a su índice lógico
+  uint64_t estados_interes = suscripcion.numeradores.size();
+  std::vector<uint64_t> indice_logico(estados_interes);
+  for (uint64_t j = 0; j < estados_interes; ++j) {
+    uint64_t fisico =
+        distribucion_.toPhysicalState(suscripcion.extractor.deposit(j));
+    indice_logico[interes.extract(fisico)] = j;
+  }
+
+  uint64_t estados = 1ULL << libres.getNumberBits();
+  uint64_t tramos = std::clamp<uint64_t>(
+      std::min(estados / kEstadosMinimosTramo,
+               kMaximoEstadosParciales / estados_interes),
+      1, kMaximoTramosRecorrido);
+  uint64_t longitud_tramo = (estados + tramos - 1) / tramos;
+  std::vector<double> parciales(tramos * estados_interes, 0.0);
+  distribucion_.visitProbabilities([&](const auto* tabla) {
+    ParallelExecutor::run(tramos, numero_hilos_, [&](uint64_t tramo) {
+      double* parcial = parciales.data() + tramo * estados_interes;
+      uint64_t inicio = tramo * longitud_tramo;
+      uint64_t fin = std::min(inicio + longitud_tramo, estados);
+      for (uint64_t k = inicio; k < fin; ++k) {
+        uint64_t fisico = base | libres.deposit(k);
+        parcial[indice_logico[interes.extract(fisico)]] += tabla[fisico];
+      }
+    });
+  });
+
+  suscripcion.normalizador = {};
+  for (uint64_t i = 0; i < estados_interes; ++i) {
+    CompensatedSum numerador;
+    for (uint64_t tramo = 0; tramo < tramos; ++tramo) {
+      numerador.add(parciales[tramo * estados_interes + i]);
+    }
+    suscripcion.numeradores[i] = numerador;
+    suscripcion.normalizador.add(numerador.value());
+  }
+  suscripcion.resultado_actualizado = false;
+}
@@ -0,0 +1,136 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   incremental_query_tracker.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase IncrementalQueryTracker, que mantiene las
+ *         respuestas de consultas suscritas mientras se modifican
+ *         probabilidades de la distribución conjunta.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../bit_extractor/bit_extractor.h"
+#include "../conditional_query/conditional_query.h"
+#include "../distribution/binary_distribution/binary_distribution.h"
+
+/**
+ * @brief Estructura con un cambio aditivo sobre la probabilidad de un estado
+ */
+struct ProbabilityDelta {
+  /// estado: Configuración lógica (bit i = variable X_{i+1})
+  uint64_t estado;
+  /// delta: Cantidad que se suma a su probabilidad
+  double delta;
+};
+
+/**
+ * @brief Clase que canaliza las modificaciones de una distribución conjunta y
+ *        mantiene, para cada consulta suscrita P(X_I | X_C = c), la masa sin
+ *        normalizar de cada valor de X_I y la masa de la evidencia. Cada
+ *        cambio de un estado se aplica en O(1) por suscripción (una
+ *        comparación con la evidencia y una extracción de bits), sin volver
+ *        a recorrer la tabla; la respuesta normalizada se calcula al
+ *        pedirla, en O(2^|I|).
+ *
+ *        Las sumas se acumulan con compensación (Neumaier), así que una
+ *        larga serie de cambios no degrada la precisión. Si la distribución
+ *        se modifica sin pasar por el seguidor (otra versión), las
+ *        suscripciones se recalculan con un recorrido al siguiente acceso.
+ */
+class IncrementalQueryTracker {
+ public:
+  //-------------------------CONSTRUCTOR-------------------------
+  explicit IncrementalQueryTracker(BinaryDistribution&, int = 1);
+
+  //-------------------------MÉTODOS-------------------------
+  /// Método para suscribir una consulta (con las máscaras calculadas);
+  /// devuelve su identificador
+  int subscribe(const ConditionalQuery&);
+  void unsubscribe(int);
+  int getNumberSubscriptions() const;
+  /// Métodos para modificar la distribución actualizando las suscripciones
+  void setProbability(uint64_t, double);
+  void applyDeltas(std::span<const ProbabilityDelta>);
+  /// Método para obtener P(X_I | X_C = c) de una suscripción (la vista es
+  /// válida hasta la siguiente modificación)
+  std::span<const double> getResult(int);
+  /// Método para obtener la masa de la evidencia X_C = c de una suscripción
+  double getEvidenceMass(int);
+  /// Método para recalcular todas las suscripciones con un recorrido
+  void resynchronize();
+  /// Versión de la distribución a la que corresponden las suscripciones
+  uint64_t getVersion() const { return version_; }
+
+ private:
+  /**
+   * @brief Suma con compensación del error de redondeo (Neumaier)
+   */
+  struct CompensatedSum {
+    double suma = 0.0;
+    double compensacion = 0.0;
+    void add(double);
+    double value() const { return suma + compensacion; }
+  };
+
+  /**
+   * @brief Estado mantenido de una consulta suscrita
+   */
+  struct Subscription {
+    /// maskC, valC, maskI: Máscaras lógicas de la consulta
+    uint64_t maskC;
+    uint64_t valC;
+    uint64_t maskI;
+    /// extractor: Compacta los bits de interés de un estado lógico
+    BitExtractor extractor;
+    /// numeradores: Masa sin normalizar de cada valor de X_I
+    std::vector<CompensatedSum> numeradores;
+    /// normalizador: Masa de la evidencia X_C = c
+    CompensatedSum normalizador;
+    /// resultado: Última respuesta normalizada calculada
+    std::vector<double> resultado;
+    /// resultado_actualizado: false si ha habido cambios desde entonces
+    bool resultado_actualizado = false;
+    /// activa: false tras cancelar la suscripción
+    bool activa = true;
+  };
+
+  //-----------------MÉTODOS PRIVADOS-----------------
+  Subscription& findSubscription(int);
+  void synchronizeIfStale();
+  void recordChange(uint64_t, double);
+  void scan(Subscription&) const;
+
+  //-----------------CONSTANTES-----------------
+  /// kMaximoVariablesInteres: Cada suscripción guarda a lo sumo 2^20
+  ///                          numeradores
+  static constexpr int kMaximoVariablesInteres = 20;
+  /// kMaximoTramosRecorrido: Número máximo de tramos paralelos del recorrido
+  ///                         que inicializa una suscripción
+  static constexpr uint64_t kMaximoTramosRecorrido = 64;
+  /// kEstadosMinimosTramo: Cada tramo recorre al menos 2^16 estados
+  static constexpr uint64_t kEstadosMinimosTramo = 1ULL << 16;
+  /// kMaximoEstadosParciales: Límite de posiciones entre todos los
+  ///                          histogramas parciales del recorrido
+  static constexpr uint64_t kMaximoEstadosParciales = 1ULL << 22;
+
+  //-----------------ATRIBUTOS-----------------
+  /// distribucion_: Distribución conjunta que se modifica
+  BinaryDistribution& distribucion_;
+  /// numero_hilos_: Número de hilos de los recorridos completos
+  int numero_hilos_;
+  /// version_: Versión de la distribución tras el último cambio aplicado
+  uint64_t version_;
+  /// suscripciones_: Suscripciones indexadas por su identificador
+  std::vector<Subscription> suscripciones_;
+};
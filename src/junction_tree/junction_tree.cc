@@ -0,0 +1,428 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   junction_tree.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase JunctionTree, árbol de cliques de un
+ *         modelo factorizado que se calibra una vez por conjunto de evidencia.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "junction_tree.h"
+#include "../bit_extractor/bit_extractor.h"
+#include "../parallel_executor/parallel_executor.h"
+
+/**
+ * @brief Constructor del árbol de unión. Cada variable del orden de
+ *        eliminación genera el clique formado por ella y sus vecinas en ese
+ *        momento; su padre es el clique de la primera de esas vecinas en
+ *        eliminarse. Los cliques contenidos en un hijo se funden con él.
+ * @param[in] modelo: Modelo factorizado
+ * @param[in] heuristica: Heurística del orden de eliminación
+ * @throws std::runtime_error si algún clique supera kMaximoVariablesClique
+ *         variables
+ */
+JunctionTree::JunctionTree(const FactorGraph& modelo,
+                           EliminationHeuristic heuristica)
+    : numero_variables_(modelo.getNumberVariables()),
+      version_(modelo.getVersion()), anchura_(0), log_constante_(0.0),
+      calibrado_(false), log_evidencia_(0.0), estados_calibracion_(0) {
+  int n = numero_variables_;
+  std::vector<int> todas(n);
+  std::iota(todas.begin(), todas.end(), 0);
+  std::vector<int> orden =
+      FactorGraph::eliminationOrder(modelo.getFactors(), todas, heuristica);
+  std::vector<int> posicion(n);
+  for (int i = 0; i < n; ++i) {
+    posicion[orden[i]] = i;
+  }
+
+  // Eliminación simbólica sobre los ámbitos de los factores
+  std::vector<std::vector<int>> ambitos;
+  for (const Factor& factor : modelo.getFactors()) {
+    if (factor.getNumberVariables() > 0) {
+      ambitos.push_back(factor.getVariables());
+    }
+  }
+  std::vector<std::vector<int>> cliques(n);
+  std::vector<int> padre(n, -1);
+  for (int i = 0; i < n; ++i) {
+    int variable = orden[i];
+    std::vector<int> clique{variable};
+    auto con_variable = std::partition(
+        ambitos.begin(), ambitos.end(), [variable](const auto& ambito) {
+          return !std::binary_search(ambito.begin(), ambito.end(), variable);
+        });
+    for (auto ambito = con_variable; ambito != ambitos.end(); ++ambito) {
+      clique.insert(clique.end(), ambito->begin(), ambito->end());
+    }
+    ambitos.erase(con_variable, ambitos.end());
+    std::sort(clique.begin(), clique.end());
+    clique.erase(std::unique(clique.begin(), clique.end()), clique.end());
+    if (static_cast<int>(clique.size()) > kMaximoVariablesClique) {
+      throw std::runtime_error(
+          "Error: El árbol de unión tendría un clique de " +
+          std::to_string(clique.size()) + " variables (máximo " +
+          std::to_string(kMaximoVariablesClique) + ")");
+    }
+
+    std::vector<int> resto;
+    int primera = n;
+    for (int vecina : clique) {
+      if (vecina != variable) {
+        resto.push_back(vecina);
+        primera = std::min(primera, posicion[vecina]);
+      }
+    }
+    if (!resto.empty()) {
+      padre[i] = primera;
+      ambitos.push_back(std::move(resto));
+    }
+    cliques[i] = std::move(clique);
+  }
+
+  // Un clique contenido en uno de sus hijos se funde con él: el hijo ocupa
+  // su lugar en el árbol
+  std::vector<std::vector<int>> hijos(n);
+  for (int i = 0; i < n; ++i) {
+    if (padre[i] >= 0) {
+      hijos[padre[i]].push_back(i);
+    }
+  }
+  std::vector<int> sustituto(n);
+  std::iota(sustituto.begin(), sustituto.end(), 0);
+  for (int i = 0; i < n; ++i) {
+    auto absorbente = std::find_if(
+        hijos[i].begin(), hijos[i].end(), [&](int hijo) {
+          return std::includes(cliques[hijo].begin(), cliques[hijo].end(),
+                               cliques[i].begin(), cliques[i].end());
+        });
+    if (absorbente == hijos[i].end()) {
+      continue;
+    }
+    int j = *absorbente;
+    sustituto[i] = j;
+    padre[j] = padre[i];
+    for (int hijo : hijos[i]) {
+      if (hijo != j) {
+        padre[hijo] = j;
+        hijos[j].push_back(hijo);
+      }
+    }
+    hijos[i].clear();
+    if (padre[i] >= 0) {
+      std::replace(hijos[padre[i]].begin(), hijos[padre[i]].end(), i, j);
+    }
+    padre[i] = -2;
+  }
+
+  // Numeración compacta de los cliques que quedan
+  std::vector<int> indice(n, -1);
+  for (int i = 0; i < n; ++i) {
+    if (padre[i] != -2) {
+      indice[i] = potenciales_.size();
+      potenciales_.emplace_back(
+          cliques[i], std::vector<double>(1ULL << cliques[i].size(), 1.0));
+      anchura_ = std::max<int>(anchura_, cliques[i].size());
+    }
+  }
+  int numero_cliques = potenciales_.size();
+  padre_.assign(numero_cliques, -1);
+  hijos_.assign(numero_cliques, {});
+  separadores_.assign(numero_cliques, {});
+  for (int i = 0; i < n; ++i) {
+    if (indice[i] < 0 || padre[i] < 0) {
+      continue;
+    }
+    int c = indice[i];
+    int p = indice[padre[i]];
+    padre_[c] = p;
+    hijos_[p].push_back(c);
+    std::set_intersection(
+        cliques[i].begin(), cliques[i].end(), cliques[padre[i]].begin(),
+        cliques[padre[i]].end(), std::back_inserter(separadores_[c]));
+  }
+
+  // Cada factor va al clique de su primera variable eliminada, que contiene
+  // todo su ámbito
+  for (const Factor& factor : modelo.getFactors()) {
+    if (factor.getNumberVariables() == 0) {
+      log_constante_ += std::log(factor.getValues()[0]);
+      continue;
+    }
+    int primera = n;
+    for (int variable : factor.getVariables()) {
+      primera = std::min(primera, posicion[variable]);
+    }
+    while (sustituto[primera] != primera) {
+      primera = sustituto[primera];
+    }
+    Factor& potencial = potenciales_[indice[primera]];
+    potencial = potencial.multiply(factor);
+  }
+
+  for (int c = 0; c < numero_cliques; ++c) {
+    if (padre_[c] < 0) {
+      std::vector<int> nivel{c};
+      for (size_t profundidad = 0; !nivel.empty(); ++profundidad) {
+        if (niveles_.size() <= profundidad) {
+          niveles_.emplace_back();
+        }
+        niveles_[profundidad].insert(niveles_[profundidad].end(),
+                                     nivel.begin(), nivel.end());
+        std::vector<int> siguiente;
+        for (int clique : nivel) {
+          siguiente.insert(siguiente.end(), hijos_[clique].begin(),
+                           hijos_[clique].end());
+        }
+        nivel = std::move(siguiente);
+      }
+    }
+  }
+
+  cliques_de_variable_.assign(n, {});
+  for (int c = 0; c < numero_cliques; ++c) {
+    for (int variable : potenciales_[c].getVariables()) {
+      cliques_de_variable_[variable].push_back(c);
+    }
+  }
+  for (auto& lista : cliques_de_variable_) {
+    std::stable_sort(lista.begin(), lista.end(), [&](int a, int b) {
+      return potenciales_[a].getSize() < potenciales_[b].getSize();
+    });
+  }
+}
+
+/**
+ * @brief Método para calibrar el árbol con una evidencia: los mensajes
+ *        suben nivel a nivel desde las hojas y después bajan desde las
+ *        raíces. Cada mensaje se divide por su máximo para que los productos
+ *        no desborden.
+ * @param[in] condicionadas: Variables observadas
+ * @param[in] valores: Valor (0 o 1) de cada variable observada
+ * @param[in] numero_hilos: Número de hilos con que se procesa cada nivel
+ * @throws std::invalid_argument si la evidencia está fuera del modelo o las
+ *         listas no tienen la misma longitud
+ */
+void JunctionTree::calibrate(const std::vector<int>& condicionadas,
+                             const std::vector<int>& valores,
+                             int numero_hilos) {
+  evidencia_ = sortEvidence(condicionadas, valores);
+  for (const auto& [variable, valor] : evidencia_) {
+    if (variable < 0 || variable >= numero_variables_) {
+      throw std::invalid_argument(
+          "Variable fuera de rango: " + std::to_string(variable) +
+          " (Debe ser 0-" + std::to_string(numero_variables_ - 1) + ")");
+    }
+  }
+  calibrado_ = false;
+
+  int numero_cliques = potenciales_.size();
+  std::vector<Factor> reducidos(numero_cliques);
+  std::vector<double> log_escalas(numero_cliques, 0.0);
+  std::vector<uint64_t> estados(numero_cliques, 0);
+  subida_.assign(numero_cliques, Factor());
+  bajada_.assign(numero_cliques, Factor());
+  creencias_.assign(numero_cliques, Factor());
+
+  // Subida: cada clique multiplica su potencial (con la evidencia) por los
+  // mensajes de sus hijos y proyecta sobre el separador con su padre
+  for (auto nivel = niveles_.rbegin(); nivel != niveles_.rend(); ++nivel) {
+    ParallelExecutor::run(nivel->size(), numero_hilos, [&](uint64_t k) {
+      int c = (*nivel)[k];
+      Factor acumulado = potenciales_[c];
+      for (const auto& [variable, valor] : evidencia_) {
+        if (acumulado.contains(variable)) {
+          acumulado = acumulado.observe(variable, valor);
+        }
+      }
+      reducidos[c] = acumulado;
+      for (int hijo : hijos_[c]) {
+        acumulado = acumulado.multiply(subida_[hijo]);
+      }
+      estados[c] += acumulado.getSize() * (1 + hijos_[c].size());
+      if (padre_[c] >= 0) {
+        subida_[c] = project(acumulado, separadores_[c]);
+        log_escalas[c] = std::log(subida_[c].rescale());
+      } else {
+        double masa = 0.0;
+        for (double valor : acumulado.getValues()) {
+          masa += valor;
+        }
+        log_escalas[c] = std::log(masa);
+      }
+      creencias_[c] = std::move(acumulado);
+    });
+  }
+
+  // Bajada: el mensaje a cada hijo combina el potencial, el mensaje del
+  // padre y los mensajes de los demás hijos
+  for (const auto& nivel : niveles_) {
+    ParallelExecutor::run(nivel.size(), numero_hilos, [&](uint64_t k) {
+      int c = nivel[k];
+      Factor entrante = reducidos[c];
+      if (padre_[c] >= 0) {
+        entrante = entrante.multiply(bajada_[c]);
+        creencias_[c] = creencias_[c].multiply(bajada_[c]);
+      }
+      for (int hijo : hijos_[c]) {
+        Factor mensaje = entrante;
+        for (int otro : hijos_[c]) {
+          if (otro != hijo) {
+            mensaje = mensaje.multiply(subida_[otro]);
+          }
+        }
+        bajada_[hijo] = project(mensaje, separadores_[hijo]);
+        bajada_[hijo].rescale();
+        estados[c] += mensaje.getSize() * hijos_[c].size();
+      }
+
+      double masa = 0.0;
+      for (double valor : creencias_[c].getValues()) {
+        masa += valor;
+      }
+      if (masa > 0.0) {
+        creencias_[c].scale(1.0 / masa);
+      }
+    });
+  }
+
+  log_evidencia_ = log_constante_;
+  estados_calibracion_ = 0;
+  for (int c = 0; c < numero_cliques; ++c) {
+    log_evidencia_ += log_escalas[c];
+    estados_calibracion_ += estados[c];
+  }
+  if (std::isnan(log_evidencia_)) {
+    log_evidencia_ = -std::numeric_limits<double>::infinity();
+  }
+  calibrado_ = true;
+}
+
+/**
+ * @brief Método para saber si la última calibración usó una evidencia
+ * @param[in] condicionadas: Variables observadas
+ * @param[in] valores: Valor de cada variable observada
+ * @return true si el árbol está calibrado con esa misma evidencia
+ */
+bool JunctionTree::isCalibratedFor(const std::vector<int>& condicionadas,
+                                   const std::vector<int>& valores) const {
+  return calibrado_ && sortEvidence(condicionadas, valores) == evidencia_;
+}
+
+/**
+ * @brief Método para obtener la marginal calibrada de un conjunto de
+ *        variables, sumando la creencia del menor clique que las contiene
+ * @param[in] interes: Variables de interés
+ * @param[out] salida: Histograma de 2^|I| posiciones; el bit k del índice es
+ *                     la k-ésima variable de interés en orden creciente
+ * @return false si ningún clique contiene todas las variables de interés
+ *         (salida queda sin modificar)
+ * @throws std::logic_error si el árbol no está calibrado
+ * @throws std::invalid_argument si alguna variable está fuera del modelo
+ */
+bool JunctionTree::computeMarginal(const std::vector<int>& interes,
+                                   double* salida) const {
+  if (!calibrado_) {
+    throw std::logic_error("Error: El árbol de unión no está calibrado");
+  }
+  std::vector<int> ordenadas(interes);
+  std::sort(ordenadas.begin(), ordenadas.end());
+  for (int variable : ordenadas) {
+    if (variable < 0 || variable >= numero_variables_) {
+      throw std::invalid_argument(
+          "Variable fuera de rango: " + std::to_string(variable) +
+          " (Debe ser 0-" + std::to_string(numero_variables_ - 1) + ")");
+    }
+  }
+
+  int clique = ordenadas.empty() && !creencias_.empty() ? 0 : -1;
+  if (!ordenadas.empty()) {
+    for (int candidato : cliques_de_variable_[ordenadas.front()]) {
+      const auto& variables = creencias_[candidato].getVariables();
+      if (std::includes(variables.begin(), variables.end(),
+                        ordenadas.begin(), ordenadas.end())) {
+        clique = candidato;
+        break;
+      }
+    }
+  }
+  if (clique < 0) {
+    return false;
+  }
+
+  const Factor& creencia = creencias_[clique];
+  uint64_t mascara = 0;
+  for (int j = 0; j < creencia.getNumberVariables(); ++j) {
+    if (std::binary_search(ordenadas.begin(), ordenadas.end(),
+                           creencia.getVariables()[j])) {
+      mascara |= 1ULL << j;
+    }
+  }
+  BitExtractor extractor(mascara);
+  std::fill_n(salida, 1ULL << ordenadas.size(), 0.0);
+  const std::vector<double>& valores = creencia.getValues();
+  for (uint64_t i = 0; i < valores.size(); ++i) {
+    salida[extractor.extract(i)] += valores[i];
+  }
+  return true;
+}
+
+/**
+ * @brief Método para construir la lista ordenada de pares de evidencia
+ * @param[in] condicionadas: Variables observadas
+ * @param[in] valores: Valor de cada variable observada
+ * @return Pares (variable, valor) ordenados por variable
+ * @throws std::invalid_argument si las listas no tienen la misma longitud
+ */
+std::vector<std::pair<int, int>> JunctionTree::sortEvidence(
+    const std::vector<int>& condicionadas, const std::vector<int>& valores) {
+  if (condicionadas.size() != valores.size()) {
+    throw std::invalid_argument(
+        "Error: Cada variable condicionada necesita un valor");
+  }
+  std::vector<std::pair<int, int>> evidencia;
+  evidencia.reserve(condicionadas.size());
+  for (size_t i = 0; i < condicionadas.size(); ++i) {
+    evidencia.emplace_back(condicionadas[i], valores[i] ? 1 : 0);
+  }
+  std::sort(evidencia.begin(), evidencia.end());
+  return evidencia;
+}
+
+/**
+ * @brief Método para sumar un factor sobre las variables que no están en un
+ *        separador
+ * @param[in] factor: Factor de un clique
+ * @param[in] separador: Variables conservadas (ordenadas, contenidas en el
+ *                       factor)
+ * @return Factor sobre el separador
+ */
+Factor JunctionTree::project(const Factor& factor,
+                             const std::vector<int>& separador) {
+  uint64_t mascara = 0;
+  for (int j = 0; j < factor.getNumberVariables(); ++j) {
+    if (std::binary_search(separador.begin(), separador.end(),
+                           factor.getVariables()[j])) {
+      mascara |= 1ULL << j;
+    }
+  }
+  BitExtractor extractor(mascara);
+  std::vector<double> proyeccion(1ULL << separador.size(), 0.0);
+  const std::vector<double>& valores = factor.getValues();
+  for (uint64_t i = 0; i < valores.size(); ++i) {
+    proyeccion[extractor.extract(i)] += valores[i];
+  }
+  return Factor(separador, std::move(proyeccion));
+}
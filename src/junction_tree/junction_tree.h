@@ -0,0 +1,115 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   junction_tree.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase JunctionTree, árbol de cliques de un
+ *         modelo factorizado que se calibra una vez por conjunto de evidencia.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "../distribution/factor_graph/factor_graph.h"
+
+/**
+ * @brief Clase que representa el árbol de unión (árbol de cliques) de un
+ *        FactorGraph. Los cliques salen de un orden de eliminación de todas
+ *        las variables y cada factor del modelo se asigna a un clique que lo
+ *        contiene.
+ *
+ *        calibrate() propaga mensajes hacia la raíz y de vuelta (Shafer-
+ *        Shenoy) con la evidencia dada. Los cliques de una misma profundidad
+ *        pertenecen a subárboles disjuntos y se procesan en paralelo; el
+ *        resultado no depende del número de hilos. Tras calibrar, la
+ *        marginal de cualquier conjunto de variables contenido en un clique
+ *        se obtiene sumando su creencia, con coste 2^|clique|
+ *        independiente del tamaño del modelo.
+ *
+ *        El árbol es una instantánea del modelo: si el modelo cambia (ver
+ *        FactorGraph::getVersion) hay que construirlo de nuevo.
+ */
+class JunctionTree {
+ public:
+  //-------------------------CONSTRUCTOR-------------------------
+  explicit JunctionTree(const FactorGraph&,
+                        EliminationHeuristic = EliminationHeuristic::kMinFill);
+
+  //-------------------------MÉTODOS-------------------------
+  int getNumberVariables() const { return numero_variables_; }
+  /// Versión del modelo a partir de la que se construyó el árbol
+  uint64_t getVersion() const { return version_; }
+  int getNumberCliques() const { return potenciales_.size(); }
+  const std::vector<int>& getCliqueVariables(int clique) const {
+    return potenciales_[clique].getVariables();
+  }
+  /// Número de variables del mayor clique
+  int getWidth() const { return anchura_; }
+  /// Método para calibrar el árbol con una evidencia
+  void calibrate(const std::vector<int>&, const std::vector<int>&, int = 1);
+  /// Método para saber si el árbol está calibrado con una evidencia
+  bool isCalibratedFor(const std::vector<int>&,
+                       const std::vector<int>&) const;
+  /// Método para obtener la marginal de un conjunto de variables contenido
+  /// en algún clique (false si no hay ninguno que lo contenga)
+  bool computeMarginal(const std::vector<int>&, double*) const;
+  /// Logaritmo de la masa sin normalizar consistente con la evidencia (log
+  /// P(e) si el modelo está normalizado)
+  double getLogEvidence() const { return log_evidencia_; }
+  /// Posiciones de clique recorridas en la última calibración
+  uint64_t getCalibrationStates() const { return estados_calibracion_; }
+
+ private:
+  //-----------------CONSTANTES-----------------
+  /// kMaximoVariablesClique: Los cliques tienen a lo sumo 2^30 posiciones
+  ///                         (8 GB de doubles)
+  static constexpr int kMaximoVariablesClique = 30;
+
+  //-----------------ATRIBUTOS-----------------
+  int numero_variables_;
+  uint64_t version_;
+  int anchura_;
+  /// potenciales_: Producto de los factores asignados a cada clique (sus
+  ///               variables son las del clique)
+  std::vector<Factor> potenciales_;
+  /// padre_: Clique padre de cada clique (-1 en las raíces)
+  std::vector<int> padre_;
+  std::vector<std::vector<int>> hijos_;
+  /// separadores_: Variables que cada clique comparte con su padre
+  std::vector<std::vector<int>> separadores_;
+  /// niveles_: Cliques de cada profundidad, de la raíz a las hojas
+  std::vector<std::vector<int>> niveles_;
+  /// cliques_de_variable_: Cliques que contienen cada variable, de menor a
+  ///                       mayor tamaño
+  std::vector<std::vector<int>> cliques_de_variable_;
+  /// log_constante_: Logaritmo del producto de los factores sin variables
+  double log_constante_;
+
+  /// Estado de la calibración
+  bool calibrado_;
+  /// evidencia_: Pares (variable, valor) de la calibración, ordenados
+  std::vector<std::pair<int, int>> evidencia_;
+  /// subida_: Mensaje de cada clique a su padre, sobre el separador
+  std::vector<Factor> subida_;
+  /// bajada_: Mensaje del padre a cada clique, sobre el separador
+  std::vector<Factor> bajada_;
+  /// creencias_: Marginal calibrada de cada clique (suma 1, o 0 si la
+  ///             evidencia es imposible)
+  std::vector<Factor> creencias_;
+  double log_evidencia_;
+  uint64_t estados_calibracion_;
+
+  //-----------------MÉTODOS PRIVADOS-----------------
+  static std::vector<std::pair<int, int>> sortEvidence(
+      const std::vector<int>&, const std::vector<int>&);
+  static Factor project(const Factor&, const std::vector<int>&);
+};
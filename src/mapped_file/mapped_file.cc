@@ -0,0 +1,90 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   mapped_file.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase MappedFile, que proyecta un archivo en
+ *         memoria en modo de solo lectura.
+ */
+
+#include <fstream>
+#include <stdexcept>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mapped_file.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ * @brief Constructor que proyecta el archivo en memoria
+ * @param[in] nombre_archivo: Ruta del archivo
+ * @throws std::runtime_error si no se puede abrir o proyectar el archivo
+ */
+MappedFile::MappedFile(const std::string& nombre_archivo)
+    : datos_(nullptr), tamano_(0) {
+  int descriptor = ::open(nombre_archivo.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    throw std::runtime_error("Error: No se puede abrir el archivo " +
+                             nombre_archivo);
+  }
+  struct stat informacion;
+  if (::fstat(descriptor, &informacion) != 0) {
+    ::close(descriptor);
+    throw std::runtime_error("Error: No se puede leer el archivo " +
+                             nombre_archivo);
+  }
+  tamano_ = static_cast<uint64_t>(informacion.st_size);
+  if (tamano_ > 0) {
+    void* proyeccion =
+        ::mmap(nullptr, tamano_, PROT_READ, MAP_SHARED, descriptor, 0);
+    if (proyeccion == MAP_FAILED) {
+      ::close(descriptor);
+      throw std::runtime_error("Error: No se puede proyectar el archivo " +
+                               nombre_archivo);
+    }
+    datos_ = static_cast<const std::byte*>(proyeccion);
+  }
+  // La proyección sigue siendo válida tras cerrar el descriptor
+  ::close(descriptor);
+}
+
+/**
+ * @brief Destructor que libera la proyección
+ */
+MappedFile::~MappedFile() {
+  if (datos_ != nullptr) {
+    ::munmap(const_cast<std::byte*>(datos_), tamano_);
+  }
+}
+#else
+/**
+ * @brief Constructor que lee el archivo completo a memoria (sin mmap)
+ * @param[in] nombre_archivo: Ruta del archivo
+ * @throws std::runtime_error si no se puede abrir el archivo
+ */
+MappedFile::MappedFile(const std::string& nombre_archivo)
+    : datos_(nullptr), tamano_(0) {
+  std::ifstream archivo(nombre_archivo, std::ios::binary | std::ios::ate);
+  if (!archivo.is_open()) {
+    throw std::runtime_error("Error: No se puede abrir el archivo " +
+                             nombre_archivo);
+  }
+  tamano_ = static_cast<uint64_t>(archivo.tellg());
+  copia_.resize(tamano_);
+  archivo.seekg(0);
+  archivo.read(reinterpret_cast<char*>(copia_.data()), tamano_);
+  datos_ = copia_.data();
+}
+
+MappedFile::~MappedFile() = default;
+#endif
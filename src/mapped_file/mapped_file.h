@@ -0,0 +1,49 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   mapped_file.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase MappedFile, que proyecta un archivo en
+ *         memoria en modo de solo lectura.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Clase que proyecta un archivo completo en memoria (mmap) en modo de
+ *        solo lectura. Las páginas se cargan bajo demanda y se comparten entre
+ *        procesos a través de la caché de páginas del sistema. En sistemas
+ *        sin mmap el archivo se lee completo a memoria.
+ */
+class MappedFile {
+ public:
+  //-------------------------CONSTRUCTOR-------------------------
+  explicit MappedFile(const std::string&);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  //-------------------------MÉTODOS-------------------------
+  const std::byte* getData() const { return datos_; }
+  uint64_t getSize() const { return tamano_; }
+
+ private:
+  //-----------------ATRIBUTOS-----------------
+  /// datos_: Primer byte del archivo proyectado
+  const std::byte* datos_;
+  /// tamano_: Tamaño del archivo en bytes
+  uint64_t tamano_;
+  /// copia_: Contenido del archivo si no se dispone de mmap
+  std::vector<std::byte> copia_;
+};
@@ -0,0 +1,206 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   materialized_views.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase MaterializedViews, que preagrega
+ *         marginales de baja dimensión de una distribución conjunta a partir
+ *         de una carga de consultas registrada.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <map>
+
+#include "materialized_views.h"
+#include "../conditional_inference_engine/conditional_inference_engine.h"
+
+/**
+ * @brief Constructor que elige las vistas para una carga de consultas y las
+ *        calcula con una pasada sobre la distribución
+ * @param[in] distribucion: Distribución conjunta
+ * @param[in] carga: Consultas registradas (con las máscaras calculadas)
+ * @param[in] presupuesto: Número máximo de probabilidades entre todas las
+ *                         vistas
+ * @param[in] numero_hilos: Número de hilos para calcular las vistas
+ */
+MaterializedViews::MaterializedViews(const BinaryDistribution& distribucion,
+                                     std::span<const ConditionalQuery> carga,
+                                     uint64_t presupuesto, int numero_hilos)
+    : numero_variables_(distribucion.getNumberVariables()),
+      version_(distribucion.getVersion()),
+      identificador_(distribucion.getIdentifier()) {
+  selectViews(carga, presupuesto);
+  refresh(distribucion, numero_hilos);
+}
+
+/**
+ * @brief Método para recalcular las vistas elegidas sobre el contenido
+ *        actual de la distribución. Cada vista es una marginal sin evidencia,
+ *        de modo que todas se obtienen con un único lote del motor de
+ *        inferencia, es decir, con una sola pasada paralela sobre la tabla.
+ * @param[in] distribucion: Distribución conjunta (la misma de la
+ *                          construcción)
+ * @param[in] numero_hilos: Número de hilos para calcular las vistas
+ * @throws std::invalid_argument si la distribución tiene otro número de
+ *         variables
+ */
+void MaterializedViews::refresh(const BinaryDistribution& distribucion,
+                                int numero_hilos) {
+  if (distribucion.getNumberVariables() != numero_variables_) {
+    throw std::invalid_argument(
+        "Error: Las vistas no corresponden a esta distribución");
+  }
+
+  std::vector<ConditionalQuery> consultas;
+  consultas.reserve(vistas_.size());
+  for (const auto& vista : vistas_) {
+    ConditionalQuery consulta(numero_variables_);
+    for (int variable = 0; variable < numero_variables_; ++variable) {
+      if (vista.variables & (1ULL << variable)) {
+        consulta.addInterestVariable(variable);
+      }
+    }
+    consulta.computeMasks();
+    consultas.push_back(std::move(consulta));
+  }
+
+  ConditionalInferenceEngine motor(distribucion, numero_hilos);
+  auto resultados = motor.computeConditionalBatch(consultas);
+  for (size_t i = 0; i < vistas_.size(); ++i) {
+    const auto& probabilidades = resultados[i].distribucion->getProbabilities();
+    vistas_[i].probabilidades.assign(probabilidades.begin(),
+                                     probabilidades.end());
+  }
+  version_ = distribucion.getVersion();
+  identificador_ = distribucion.getIdentifier();
+}
+
+/**
+ * @brief Método para obtener la memoria ocupada por las vistas
+ * @return Número total de probabilidades almacenadas
+ */
+uint64_t MaterializedViews::getMemoryUsage() const {
+  uint64_t total = 0;
+  for (const auto& vista : vistas_) {
+    total += vista.probabilidades.size();
+  }
+  return total;
+}
+
+/**
+ * @brief Método para buscar la vista más pequeña que contiene unas variables
+ * @param[in] variables: Máscara de las variables que debe contener la vista
+ * @return Puntero a la vista, o nullptr si ninguna las contiene
+ */
+const MarginalView* MaterializedViews::findView(uint64_t variables) const {
+  const MarginalView* mejor = nullptr;
+  for (const auto& vista : vistas_) {
+    if ((variables & ~vista.variables) == 0 &&
+        (!mejor ||
+         std::popcount(vista.variables) < std::popcount(mejor->variables))) {
+      mejor = &vista;
+    }
+  }
+  return mejor;
+}
+
+/**
+ * @brief Método para elegir las vistas con un algoritmo voraz: en cada paso
+ *        se materializa la candidata con mayor beneficio por unidad de
+ *        memoria, donde el beneficio es el número de estados que dejan de
+ *        recorrerse en la carga registrada (sin contar las consultas que ya
+ *        son baratas). Las candidatas son los conjuntos
+ *        de variables de cada consulta y las uniones por parejas de los más
+ *        frecuentes.
+ * @param[in] carga: Consultas registradas
+ * @param[in] presupuesto: Número máximo de probabilidades entre todas las
+ *                         vistas
+ */
+void MaterializedViews::selectViews(std::span<const ConditionalQuery> carga,
+                                    uint64_t presupuesto) {
+  // Agrupamos la carga por (variables usadas, número de condicionadas), que
+  // determina el coste actual de cada consulta: recorrer 2^(N-|C|) estados
+  std::map<std::pair<uint64_t, int>, double> frecuencias;
+  for (const auto& consulta : carga) {
+    uint64_t variables = consulta.getMaskI() | consulta.getMaskC();
+    frecuencias[{variables, std::popcount(consulta.getMaskC())}] += 1.0;
+  }
+  struct Workload {
+    uint64_t variables;
+    double frecuencia;
+    double coste;
+  };
+  std::vector<Workload> consultas;
+  std::map<uint64_t, double> frecuencia_conjunto;
+  for (const auto& [clave, frecuencia] : frecuencias) {
+    consultas.push_back({clave.first, frecuencia,
+                         std::ldexp(1.0, numero_variables_ - clave.second)});
+    frecuencia_conjunto[clave.first] += frecuencia;
+  }
+
+  std::vector<std::pair<double, uint64_t>> frecuentes;
+  for (const auto& [variables, frecuencia] : frecuencia_conjunto) {
+    frecuentes.push_back({frecuencia, variables});
+  }
+  std::sort(frecuentes.rbegin(), frecuentes.rend());
+  if (frecuentes.size() > kMaximoCandidatos) {
+    frecuentes.resize(kMaximoCandidatos);
+  }
+  std::vector<uint64_t> candidatas;
+  for (const auto& [variables, frecuencia] : frecuencia_conjunto) {
+    candidatas.push_back(variables);
+  }
+  for (size_t i = 0; i < frecuentes.size(); ++i) {
+    for (size_t j = i + 1; j < frecuentes.size(); ++j) {
+      candidatas.push_back(frecuentes[i].second | frecuentes[j].second);
+    }
+  }
+  std::sort(candidatas.begin(), candidatas.end());
+  candidatas.erase(std::unique(candidatas.begin(), candidatas.end()),
+                   candidatas.end());
+
+  uint64_t restante = presupuesto;
+  vistas_.clear();
+  while (true) {
+    double mejor_ratio = 0.0;
+    uint64_t mejor = 0;
+    for (uint64_t candidata : candidatas) {
+      int bits = std::popcount(candidata);
+      if (bits >= 63 || (1ULL << bits) > restante) {
+        continue;
+      }
+      double tamano = std::ldexp(1.0, bits);
+      double beneficio = 0.0;
+      for (const auto& consulta : consultas) {
+        if ((consulta.variables & ~candidata) == 0 &&
+            consulta.coste > kCosteMinimoMejorable && consulta.coste > tamano) {
+          beneficio += consulta.frecuencia * (consulta.coste - tamano);
+        }
+      }
+      if (beneficio / tamano > mejor_ratio) {
+        mejor_ratio = beneficio / tamano;
+        mejor = candidata;
+      }
+    }
+    if (mejor_ratio <= 0.0) {
+      break;
+    }
+
+    double tamano = std::ldexp(1.0, std::popcount(mejor));
+    for (auto& consulta : consultas) {
+      if ((consulta.variables & ~mejor) == 0) {
+        consulta.coste = std::min(consulta.coste, tamano);
+      }
+    }
+    restante -= 1ULL << std::popcount(mejor);
+    vistas_.push_back({mejor, {}});
+  }
+}
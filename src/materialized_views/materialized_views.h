@@ -0,0 +1,86 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   materialized_views.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase MaterializedViews, que preagrega
+ *         marginales de baja dimensión de una distribución conjunta a partir
+ *         de una carga de consultas registrada.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../distribution/binary_distribution/binary_distribution.h"
+#include "../conditional_query/conditional_query.h"
+
+/**
+ * @brief Estructura que representa una marginal materializada P(X_V)
+ */
+struct MarginalView {
+  /// variables: Máscara de las variables V de la vista
+  uint64_t variables;
+  /// probabilidades: P(X_V = v) indexada por los bits de V compactados
+  std::vector<double> probabilidades;
+};
+
+/**
+ * @brief Clase que elige, dentro de un presupuesto de memoria, qué marginales
+ *        de la distribución conjunta conviene preagregar (al estilo de los
+ *        cubos OLAP) y las mantiene. Una consulta cuyas variables de interés
+ *        y condicionadas están contenidas en una vista se resuelve sobre la
+ *        vista en lugar de sobre la tabla completa.
+ */
+class MaterializedViews {
+ public:
+  //-------------------------CONSTRUCTOR-------------------------
+  MaterializedViews(const BinaryDistribution&,
+                    std::span<const ConditionalQuery>, uint64_t, int = 1);
+
+  //-------------------------MÉTODOS-------------------------
+  /// Método para recalcular las vistas elegidas sobre el contenido actual
+  /// de la distribución (una sola pasada)
+  void refresh(const BinaryDistribution&, int = 1);
+  /// Versión de la distribución a partir de la que se calcularon las vistas
+  uint64_t getVersion() const { return version_; }
+  /// Identificador de la distribución a partir de la que se calcularon
+  uint64_t getDistributionIdentifier() const { return identificador_; }
+  int getNumberVariables() const { return numero_variables_; }
+  const std::vector<MarginalView>& getViews() const { return vistas_; }
+  /// Método para obtener el número total de probabilidades almacenadas
+  uint64_t getMemoryUsage() const;
+  /// Método para buscar la vista más pequeña que contiene unas variables
+  const MarginalView* findView(uint64_t) const;
+
+ private:
+  //-----------------MÉTODOS PRIVADOS-----------------
+  /// Método para elegir las vistas según la carga y el presupuesto
+  void selectViews(std::span<const ConditionalQuery>, uint64_t);
+
+  //-----------------CONSTANTES-----------------
+  /// kMaximoCandidatos: Número de conjuntos más frecuentes de la carga que se
+  ///                    combinan por parejas para generar candidatos
+  static constexpr size_t kMaximoCandidatos = 32;
+  /// kCosteMinimoMejorable: Las consultas que ya recorren como mucho 2^12
+  ///                        estados no justifican nuevas vistas
+  static constexpr double kCosteMinimoMejorable = 4096.0;
+
+  //-----------------ATRIBUTOS-----------------
+  /// numero_variables_: Número de variables de la distribución
+  int numero_variables_;
+  /// version_: Versión de la distribución al calcular las vistas
+  uint64_t version_;
+  /// identificador_: Identificador de la distribución de las vistas
+  uint64_t identificador_;
+  /// vistas_: Marginales materializadas
+  std::vector<MarginalView> vistas_;
+};
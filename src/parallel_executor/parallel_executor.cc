@@ -0,0 +1,172 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   parallel_executor.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación del grupo persistente de hilos de la clase
+ *         ParallelExecutor.
+ */
+
+#include <condition_variable>
+#include <vector>
+
+#include "parallel_executor.h"
+
+namespace {
+
+/**
+ * @brief Grupo de hilos auxiliares que esperan el siguiente trabajo. Solo
+ *        admite un trabajo a la vez; quien no consigue el grupo ejecuta sus
+ *        tareas en su propio hilo.
+ */
+class WorkerPool {
+ public:
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> bloqueo(cerrojo_);
+      parar_ = true;
+    }
+    aviso_.notify_all();
+    for (auto& hilo : hilos_) {
+      hilo.join();
+    }
+  }
+
+  /// Método para reservar el grupo; false si ya está ocupado
+  bool acquire() { return !ocupado_.exchange(true, std::memory_order_acquire); }
+  void release() { ocupado_.store(false, std::memory_order_release); }
+
+  /**
+   * @brief Método para ejecutar un trabajo con el hilo llamador y hasta
+   *        numero_auxiliares hilos del grupo (el grupo debe estar reservado).
+   *        Al terminar el llamador su parte el trabajo se cierra a los hilos
+   *        que aún no se habían unido y se espera a los que sí.
+   * @param[in] ejecutar: Función que ejecuta el trabajo
+   * @param[in] trabajo: Trabajo que se pasa a la función
+   * @param[in] numero_auxiliares: Número máximo de hilos auxiliares
+   */
+  void execute(void (*ejecutar)(void*), void* trabajo, int numero_auxiliares) {
+    try {
+      while (static_cast<int>(hilos_.size()) < numero_auxiliares) {
+        hilos_.emplace_back([this] { workerLoop(); });
+      }
+    } catch (...) {
+      // Sin recursos para más hilos (std::system_error) o para el vector
+      // (std::bad_alloc) se trabaja con los que ya existan
+    }
+    {
+      std::lock_guard<std::mutex> bloqueo(cerrojo_);
+      ejecutar_ = ejecutar;
+      trabajo_ = trabajo;
+      plazas_ = numero_auxiliares;
+      ++generacion_;
+    }
+    aviso_.notify_all();
+    ejecutar(trabajo);
+
+    std::unique_lock<std::mutex> bloqueo(cerrojo_);
+    trabajo_ = nullptr;
+    terminado_.wait(bloqueo, [this] { return activos_ == 0; });
+  }
+
+ private:
+  /// Bucle de cada hilo auxiliar: se une a cada trabajo nuevo mientras
+  /// queden plazas
+  void workerLoop() {
+    std::unique_lock<std::mutex> bloqueo(cerrojo_);
+    uint64_t visto = generacion_;
+    while (true) {
+      aviso_.wait(bloqueo, [&] { return parar_ || generacion_ != visto; });
+      if (parar_) {
+        return;
+      }
+      visto = generacion_;
+      if (!trabajo_ || plazas_ == 0) {
+        continue;
+      }
+      --plazas_;
+      ++activos_;
+      void* trabajo = trabajo_;
+      void (*ejecutar)(void*) = ejecutar_;
+      bloqueo.unlock();
+      ejecutar(trabajo);
+      bloqueo.lock();
+      if (--activos_ == 0) {
+        terminado_.notify_one();
+      }
+    }
+  }
+
+  /// ocupado_: true mientras un llamador usa el grupo
+  std::atomic<bool> ocupado_{false};
+  /// hilos_: Hilos auxiliares creados hasta ahora
+  std::vector<std::thread> hilos_;
+  /// cerrojo_, aviso_, terminado_: Sincronización de trabajos y hilos
+  std::mutex cerrojo_;
+  std::condition_variable aviso_;
+  std::condition_variable terminado_;
+  /// trabajo_, ejecutar_: Trabajo abierto y función que lo ejecuta
+  void* trabajo_ = nullptr;
+  void (*ejecutar_)(void*) = nullptr;
+  /// plazas_: Hilos que aún pueden unirse al trabajo abierto
+  int plazas_ = 0;
+  /// activos_: Hilos auxiliares ejecutando el trabajo
+  int activos_ = 0;
+  /// generacion_: Se incrementa con cada trabajo nuevo
+  uint64_t generacion_ = 0;
+  /// parar_: true al destruir el grupo
+  bool parar_ = false;
+};
+
+WorkerPool& pool() {
+  static WorkerPool grupo;
+  return grupo;
+}
+
+}  // namespace
+
+/**
+ * @brief Método para tomar y ejecutar tareas del contador compartido hasta
+ *        agotarlas. La primera excepción se guarda y detiene el reparto.
+ */
+void ParallelExecutor::Job::work() {
+  try {
+    for (uint64_t i = siguiente++; i < numero_tareas; i = siguiente++) {
+      ejecutar(tarea, i);
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> bloqueo(cerrojo_error);
+    if (!error) {
+      error = std::current_exception();
+    }
+    siguiente = numero_tareas;
+  }
+}
+
+/**
+ * @brief Método para ejecutar un trabajo sobre el grupo persistente de hilos,
+ *        o solo en el hilo llamador si el grupo está ocupado
+ * @param[in] trabajo: Trabajo con las tareas a ejecutar
+ * @param[in] numero_auxiliares: Número máximo de hilos auxiliares
+ */
+void ParallelExecutor::dispatch(Job& trabajo, int numero_auxiliares) {
+  WorkerPool& grupo = pool();
+  if (!grupo.acquire()) {
+    trabajo.work();
+    return;
+  }
+  // El grupo se libera aunque execute lance, o quedaría ocupado para siempre
+  struct Liberar {
+    WorkerPool& grupo;
+    ~Liberar() { grupo.release(); }
+  } liberar{grupo};
+  grupo.execute(
+      [](void* contexto) { static_cast<Job*>(contexto)->work(); }, &trabajo,
+      numero_auxiliares);
+}
@@ -0,0 +1,102 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   parallel_executor.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase ParallelExecutor, que reparte un conjunto
+ *         de tareas independientes entre varios hilos.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @brief Clase que ejecuta tareas indexadas [0, n) sobre un número dado de
+ *        hilos. Los hilos toman las tareas de un contador compartido, por lo
+ *        que el reparto no influye en qué cálculo realiza cada tarea.
+ *
+ *        Los hilos auxiliares forman un grupo persistente que se crea bajo
+ *        demanda y se reutiliza en cada llamada, así que una ejecución en
+ *        régimen estacionario no crea hilos ni reserva memoria.
+ *
+ *        El grupo atiende una sola llamada a la vez. Si ya está ocupado (una
+ *        llamada anidada dentro de una tarea, o dos motores que consultan a
+ *        la vez desde hilos distintos), la segunda llamada ejecuta todas sus
+ *        tareas en el hilo llamador: numero_hilos es un máximo, no una
+ *        garantía. El resultado no cambia, porque cada tarea calcula lo
+ *        mismo con cualquier reparto; solo el tiempo.
+ */
+class ParallelExecutor {
+ public:
+  /**
+   * @brief Método para ejecutar tarea(i) para cada i en [0, numero_tareas)
+   * @param[in] numero_tareas: Número de tareas a ejecutar
+   * @param[in] numero_hilos: Número máximo de hilos (incluido el llamador);
+   *                          con el grupo ocupado se usa solo el llamador
+   * @param[in] tarea: Función invocable con el índice de la tarea
+   * @throws Relanza la primera excepción lanzada por alguna tarea
+   */
+  template <class Tarea>
+  static void run(uint64_t numero_tareas, int numero_hilos, Tarea&& tarea) {
+    uint64_t hilos = std::min<uint64_t>(std::max(numero_hilos, 1),
+                                        numero_tareas);
+    if (hilos <= 1) {
+      for (uint64_t i = 0; i < numero_tareas; ++i) {
+        tarea(i);
+      }
+      return;
+    }
+
+    using TipoTarea = std::remove_reference_t<Tarea>;
+    Job trabajo(numero_tareas,
+                [](void* contexto, uint64_t i) {
+                  (*static_cast<TipoTarea*>(contexto))(i);
+                },
+                const_cast<void*>(static_cast<const void*>(&tarea)));
+    dispatch(trabajo, static_cast<int>(hilos - 1));
+    if (trabajo.error) {
+      std::rethrow_exception(trabajo.error);
+    }
+  }
+
+  /// Método para obtener el número de hilos hardware disponibles
+  static int hardwareThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+ private:
+  /**
+   * @brief Ejecución en curso: tareas pendientes y primera excepción
+   */
+  struct Job {
+    Job(uint64_t numero_tareas, void (*ejecutar)(void*, uint64_t),
+        void* tarea)
+        : numero_tareas(numero_tareas), ejecutar(ejecutar), tarea(tarea) {}
+    /// Método para tomar y ejecutar tareas hasta que no quede ninguna
+    void work();
+
+    uint64_t numero_tareas;
+    void (*ejecutar)(void*, uint64_t);
+    void* tarea;
+    std::atomic<uint64_t> siguiente{0};
+    std::exception_ptr error;
+    std::mutex cerrojo_error;
+  };
+
+  /// Método para ejecutar un trabajo con el hilo llamador y hasta
+  /// numero_auxiliares hilos del grupo persistente
+  static void dispatch(Job&, int);
+};
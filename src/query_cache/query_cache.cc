@@ -0,0 +1,103 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   query_cache.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase QueryCache, una caché LRU acotada por
+ *         tamaño de los resultados de consultas condicionales.
+ */
+
+#include "query_cache.h"
+
+/**
+ * @brief Constructor de la caché
+ * @param[in] capacidad: Número máximo de probabilidades almacenadas entre
+ *                       todas las entradas (0 desactiva la caché)
+ */
+QueryCache::QueryCache(uint64_t capacidad)
+    : capacidad_(capacidad), ocupacion_(0) {}
+
+/**
+ * @brief Método para buscar el resultado de una consulta
+ * @param[in] clave: Clave canónica de la consulta
+ * @return Puntero al resultado almacenado, o nullptr si no está en la caché.
+ *         El puntero es válido hasta la siguiente modificación de la caché.
+ */
+const std::vector<double>* QueryCache::find(const QueryKey& clave) {
+  auto it = indice_.find(clave);
+  if (it == indice_.end()) {
+    estadisticas_.fallos++;
+    return nullptr;
+  }
+  estadisticas_.aciertos++;
+  entradas_.splice(entradas_.begin(), entradas_, it->second);
+  return &it->second->valores;
+}
+
+/**
+ * @brief Método para guardar el resultado de una consulta como el más
+ *        reciente
+ * @param[in] clave: Clave canónica de la consulta
+ * @param[in] valores: Probabilidades del resultado
+ * @param[in] longitud: Número de probabilidades del resultado
+ */
+void QueryCache::insert(const QueryKey& clave, const double* valores,
+                        uint64_t longitud) {
+  if (longitud > capacidad_) {
+    return;
+  }
+  auto it = indice_.find(clave);
+  if (it != indice_.end()) {
+    ocupacion_ -= it->second->valores.size();
+    entradas_.erase(it->second);
+    indice_.erase(it);
+  }
+  evict(longitud);
+  entradas_.push_front({clave, std::vector<double>(valores, valores + longitud)});
+  indice_[clave] = entradas_.begin();
+  ocupacion_ += longitud;
+}
+
+/**
+ * @brief Método para vaciar la caché cuando la distribución subyacente ha
+ *        cambiado
+ */
+void QueryCache::invalidate() {
+  if (!entradas_.empty()) {
+    estadisticas_.invalidaciones++;
+  }
+  entradas_.clear();
+  indice_.clear();
+  ocupacion_ = 0;
+}
+
+/**
+ * @brief Método para cambiar la capacidad, expulsando las entradas que ya no
+ *        quepan
+ * @param[in] capacidad: Nuevo número máximo de probabilidades almacenadas
+ */
+void QueryCache::setCapacity(uint64_t capacidad) {
+  capacidad_ = capacidad;
+  evict(0);
+}
+
+/**
+ * @brief Método para expulsar las entradas menos recientes hasta que quepan
+ *        los estados indicados
+ * @param[in] necesarios: Número de probabilidades que se van a añadir
+ */
+void QueryCache::evict(uint64_t necesarios) {
+  while (!entradas_.empty() && ocupacion_ + necesarios > capacidad_) {
+    const Entry& ultima = entradas_.back();
+    ocupacion_ -= ultima.valores.size();
+    indice_.erase(ultima.clave);
+    entradas_.pop_back();
+    estadisticas_.expulsiones++;
+  }
+}
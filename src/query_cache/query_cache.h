@@ -0,0 +1,110 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   query_cache.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase QueryCache, una caché LRU acotada por
+ *         tamaño de los resultados de consultas condicionales.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Clave canónica de una consulta condicional
+ */
+struct QueryKey {
+  uint64_t maskC;
+  uint64_t valC;
+  uint64_t maskI;
+
+  bool operator==(const QueryKey&) const = default;
+};
+
+/**
+ * @brief Función hash para QueryKey
+ */
+struct QueryKeyHash {
+  std::size_t operator()(const QueryKey& clave) const {
+    uint64_t hash = clave.maskC * 0x9E3779B97F4A7C15ULL;
+    hash ^= clave.valC + 0xC2B2AE3D27D4EB4FULL + (hash << 6) + (hash >> 2);
+    hash ^= clave.maskI + 0x165667B19E3779F9ULL + (hash << 6) + (hash >> 2);
+    return static_cast<std::size_t>(hash);
+  }
+};
+
+/**
+ * @brief Estructura con los contadores de uso de la caché
+ */
+struct CacheStatistics {
+  /// aciertos: Consultas servidas desde la caché
+  uint64_t aciertos = 0;
+  /// fallos: Consultas que no estaban en la caché
+  uint64_t fallos = 0;
+  /// expulsiones: Entradas expulsadas por falta de capacidad
+  uint64_t expulsiones = 0;
+  /// invalidaciones: Vaciados completos por cambios en la distribución
+  uint64_t invalidaciones = 0;
+};
+
+/**
+ * @brief Clase que guarda los resultados normalizados de las consultas más
+ *        recientes. La capacidad se mide en número total de probabilidades
+ *        almacenadas, de modo que un resultado de 2^|I| estados ocupa 2^|I|.
+ */
+class QueryCache {
+ public:
+  //-------------------------CONSTRUCTOR-------------------------
+  explicit QueryCache(uint64_t = 0);
+
+  //-------------------------MÉTODOS-------------------------
+  /// Método para buscar un resultado (lo marca como el más reciente)
+  const std::vector<double>* find(const QueryKey&);
+  /// Método para guardar un resultado, expulsando los menos recientes
+  void insert(const QueryKey&, const double*, uint64_t);
+  /// Método para vaciar la caché porque la distribución ha cambiado
+  void invalidate();
+
+  uint64_t getCapacity() const { return capacidad_; }
+  void setCapacity(uint64_t);
+  uint64_t getSize() const { return ocupacion_; }
+  const CacheStatistics& getStatistics() const { return estadisticas_; }
+
+ private:
+  /**
+   * @brief Entrada de la lista LRU
+   */
+  struct Entry {
+    QueryKey clave;
+    std::vector<double> valores;
+  };
+
+  //-----------------MÉTODOS PRIVADOS-----------------
+  /// Método para expulsar entradas hasta que quepan los estados indicados
+  void evict(uint64_t);
+
+  //-----------------ATRIBUTOS-----------------
+  /// capacidad_: Número máximo de probabilidades almacenadas (0 = desactivada)
+  uint64_t capacidad_;
+  /// ocupacion_: Número de probabilidades almacenadas actualmente
+  uint64_t ocupacion_;
+  /// entradas_: Lista de entradas, de la más reciente a la menos reciente
+  std::list<Entry> entradas_;
+  /// indice_: Posición en la lista de cada clave almacenada
+  std::unordered_map<QueryKey, std::list<Entry>::iterator, QueryKeyHash>
+      indice_;
+  /// estadisticas_: Contadores de aciertos, fallos, expulsiones e
+  ///                invalidaciones
+  CacheStatistics estadisticas_;
+};
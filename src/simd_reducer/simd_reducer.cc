@@ -0,0 +1,887 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   simd_reducer.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase SimdReducer, que suma bloques contiguos
+ *         de probabilidades con instrucciones vectoriales (AVX2 / AVX-512).
+ */
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+
+#include "simd_reducer.h"
+
+/**
+ * @brief Método para detectar el núcleo de reducción más ancho soportado por
+ *        la CPU (y habilitado por el sistema operativo)
+ * @return Núcleo de reducción a utilizar
+ */
+SimdKernel SimdReducer::detectKernel() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return SimdKernel::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdKernel::kAvx2;
+  }
+#endif
+  return SimdKernel::kScalar;
+}
+
+/**
+ * @brief Método para obtener la función de suma asociada a un núcleo
+ * @param[in] nucleo: Núcleo de reducción
+ * @return Puntero a la función de suma
+ */
+SimdReducer::SumFunction SimdReducer::sumFunction(SimdKernel nucleo) {
+  switch (nucleo) {
+    case SimdKernel::kAvx512:
+      return &SimdReducer::sumAvx512;
+    case SimdKernel::kAvx2:
+      return &SimdReducer::sumAvx2;
+    default:
+      return &SimdReducer::sumScalar;
+  }
+}
+
+/**
+ * @brief Método para obtener la función de suma de bloques float de un núcleo
+ * @param[in] nucleo: Núcleo de reducción
+ * @return Puntero a la función de suma
+ */
+SimdReducer::SumFunctionFloat SimdReducer::sumFunctionFloat(SimdKernel nucleo) {
+  switch (nucleo) {
+    case SimdKernel::kAvx512:
+      return &SimdReducer::sumAvx512;
+    case SimdKernel::kAvx2:
+      return &SimdReducer::sumAvx2;
+    default:
+      return &SimdReducer::sumScalar;
+  }
+}
+
+/**
+ * @brief Método para obtener la función de suma de bloques bfloat16 de un
+ *        núcleo
+ * @param[in] nucleo: Núcleo de reducción
+ * @return Puntero a la función de suma
+ */
+SimdReducer::SumFunctionBfloat16 SimdReducer::sumFunctionBfloat16(
+    SimdKernel nucleo) {
+  switch (nucleo) {
+    case SimdKernel::kAvx512:
+      return &SimdReducer::sumAvx512;
+    case SimdKernel::kAvx2:
+      return &SimdReducer::sumAvx2;
+    default:
+      return &SimdReducer::sumScalar;
+  }
+}
+
+/**
+ * @brief Método para obtener la función de resumen asociada a un núcleo
+ * @param[in] nucleo: Núcleo de reducción
+ * @return Puntero a la función de resumen
+ */
+SimdReducer::SummaryFunction SimdReducer::summaryFunction(SimdKernel nucleo) {
+  switch (nucleo) {
+    case SimdKernel::kAvx512:
+      return &SimdReducer::summarizeAvx512;
+    case SimdKernel::kAvx2:
+      return &SimdReducer::summarizeAvx2;
+    default:
+      return &SimdReducer::summarizeScalar;
+  }
+}
+
+/**
+ * @brief Método para obtener la función de resumen de bloques float de un
+ *        núcleo
+ * @param[in] nucleo: Núcleo de reducción
+ * @return Puntero a la función de resumen
+ */
+SimdReducer::SummaryFunctionFloat SimdReducer::summaryFunctionFloat(
+    SimdKernel nucleo) {
+  switch (nucleo) {
+    case SimdKernel::kAvx512:
+      return &SimdReducer::summarizeAvx512;
+    case SimdKernel::kAvx2:
+      return &SimdReducer::summarizeAvx2;
+    default:
+      return &SimdReducer::summarizeScalar;
+  }
+}
+
+/**
+ * @brief Método para obtener la función de resumen de bloques bfloat16 de un
+ *        núcleo
+ * @param[in] nucleo: Núcleo de reducción
+ * @return Puntero a la función de resumen
+ */
+SimdReducer::SummaryFunctionBfloat16 SimdReducer::summaryFunctionBfloat16(
+    SimdKernel nucleo) {
+  switch (nucleo) {
+    case SimdKernel::kAvx512:
+      return &SimdReducer::summarizeAvx512;
+    case SimdKernel::kAvx2:
+      return &SimdReducer::summarizeAvx2;
+    default:
+      return &SimdReducer::summarizeScalar;
+  }
+}
+
+/**
+ * @brief Método para obtener la función de plegado asociada a un núcleo
+ * @param[in] nucleo: Núcleo de reducción
+ * @return Puntero a la función de plegado
+ */
+SimdReducer::FoldFunction SimdReducer::foldFunction(SimdKernel nucleo) {
+  switch (nucleo) {
+    case SimdKernel::kAvx512:
+      return &SimdReducer::foldAvx512;
+    case SimdKernel::kAvx2:
+      return &SimdReducer::foldAvx2;
+    default:
+      return &SimdReducer::foldScalar;
+  }
+}
+
+/**
+ * @brief Función para sumar en double un bloque de cualquier tipo de
+ *        almacenamiento con cuatro acumuladores escalares independientes
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma de los elementos del bloque
+ */
+template <class Valor>
+static double sumWidened(const Valor* bloque, uint64_t longitud) {
+  double acumuladores[4] = {0.0, 0.0, 0.0, 0.0};
+  uint64_t i = 0;
+  for (; i + 4 <= longitud; i += 4) {
+    acumuladores[0] += static_cast<double>(bloque[i]);
+    acumuladores[1] += static_cast<double>(bloque[i + 1]);
+    acumuladores[2] += static_cast<double>(bloque[i + 2]);
+    acumuladores[3] += static_cast<double>(bloque[i + 3]);
+  }
+  for (; i < longitud; ++i) {
+    acumuladores[0] += static_cast<double>(bloque[i]);
+  }
+  return (acumuladores[0] + acumuladores[1]) +
+         (acumuladores[2] + acumuladores[3]);
+}
+
+double SimdReducer::sumScalar(const float* bloque, uint64_t longitud) {
+  return sumWidened(bloque, longitud);
+}
+
+double SimdReducer::sumScalar(const Bfloat16* bloque, uint64_t longitud) {
+  return sumWidened(bloque, longitud);
+}
+
+/**
+ * @brief Método para sumar un bloque contiguo con cuatro acumuladores
+ *        escalares independientes
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma de los elementos del bloque
+ */
+double SimdReducer::sumScalar(const double* bloque, uint64_t longitud) {
+  double acumuladores[4] = {0.0, 0.0, 0.0, 0.0};
+  uint64_t i = 0;
+  for (; i + 4 <= longitud; i += 4) {
+    acumuladores[0] += bloque[i];
+    acumuladores[1] += bloque[i + 1];
+    acumuladores[2] += bloque[i + 2];
+    acumuladores[3] += bloque[i + 3];
+  }
+  for (; i < longitud; ++i) {
+    acumuladores[0] += bloque[i];
+  }
+  return (acumuladores[0] + acumuladores[1]) +
+         (acumuladores[2] + acumuladores[3]);
+}
+
+/**
+ * @brief Función para resumir en double un bloque de cualquier tipo de
+ *        almacenamiento con cuatro acumuladores escalares independientes
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma, mínimo y máximo de los elementos del bloque
+ */
+template <class Valor>
+static BlockSummary summarizeWidened(const Valor* bloque, uint64_t longitud) {
+  double acumuladores[4] = {0.0, 0.0, 0.0, 0.0};
+  double minimo = std::numeric_limits<double>::infinity();
+  double maximo = -minimo;
+  uint64_t i = 0;
+  for (; i + 4 <= longitud; i += 4) {
+    for (int carril = 0; carril < 4; ++carril) {
+      double valor = static_cast<double>(bloque[i + carril]);
+      acumuladores[carril] += valor;
+      minimo = std::min(minimo, valor);
+      maximo = std::max(maximo, valor);
+    }
+  }
+  for (; i < longitud; ++i) {
+    double valor = static_cast<double>(bloque[i]);
+    acumuladores[0] += valor;
+    minimo = std::min(minimo, valor);
+    maximo = std::max(maximo, valor);
+  }
+  return {(acumuladores[0] + acumuladores[1]) +
+              (acumuladores[2] + acumuladores[3]),
+          minimo, maximo};
+}
+
+BlockSummary SimdReducer::summarizeScalar(const double* bloque,
+                                          uint64_t longitud) {
+  return summarizeWidened(bloque, longitud);
+}
+
+BlockSummary SimdReducer::summarizeScalar(const float* bloque,
+                                          uint64_t longitud) {
+  return summarizeWidened(bloque, longitud);
+}
+
+BlockSummary SimdReducer::summarizeScalar(const Bfloat16* bloque,
+                                          uint64_t longitud) {
+  return summarizeWidened(bloque, longitud);
+}
+
+/**
+ * @brief Método para plegar la mitad superior de un bloque sobre la inferior
+ *        (bloque[i] += bloque[mitad + i]) con cuatro acumuladores escalares
+ *        para la suma de la mitad superior
+ * @param[in,out] bloque: Puntero al primer elemento del bloque de 2·mitad
+ *                        elementos (la mitad superior no se modifica)
+ * @param[in] mitad: Número de elementos de cada mitad
+ * @return Suma de la mitad superior
+ */
+double SimdReducer::foldScalar(double* bloque, uint64_t mitad) {
+  const double* alto = bloque + mitad;
+  double acumuladores[4] = {0.0, 0.0, 0.0, 0.0};
+  uint64_t i = 0;
+  for (; i + 4 <= mitad; i += 4) {
+    for (int carril = 0; carril < 4; ++carril) {
+      acumuladores[carril] += alto[i + carril];
+      bloque[i + carril] += alto[i + carril];
+    }
+  }
+  for (; i < mitad; ++i) {
+    acumuladores[0] += alto[i];
+    bloque[i] += alto[i];
+  }
+  return (acumuladores[0] + acumuladores[1]) +
+         (acumuladores[2] + acumuladores[3]);
+}
+
+#if defined(__x86_64__)
+/**
+ * @brief Método para sumar un bloque contiguo con cuatro acumuladores AVX2
+ *        (16 doubles por iteración)
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma de los elementos del bloque
+ */
+__attribute__((target("avx2")))
+double SimdReducer::sumAvx2(const double* bloque, uint64_t longitud) {
+  __m256d acumulador0 = _mm256_setzero_pd();
+  __m256d acumulador1 = _mm256_setzero_pd();
+  __m256d acumulador2 = _mm256_setzero_pd();
+  __m256d acumulador3 = _mm256_setzero_pd();
+  uint64_t i = 0;
+  for (; i + 16 <= longitud; i += 16) {
+    acumulador0 = _mm256_add_pd(acumulador0, _mm256_loadu_pd(bloque + i));
+    acumulador1 = _mm256_add_pd(acumulador1, _mm256_loadu_pd(bloque + i + 4));
+    acumulador2 = _mm256_add_pd(acumulador2, _mm256_loadu_pd(bloque + i + 8));
+    acumulador3 = _mm256_add_pd(acumulador3, _mm256_loadu_pd(bloque + i + 12));
+  }
+  for (; i + 4 <= longitud; i += 4) {
+    acumulador0 = _mm256_add_pd(acumulador0, _mm256_loadu_pd(bloque + i));
+  }
+  __m256d total = _mm256_add_pd(_mm256_add_pd(acumulador0, acumulador1),
+                                _mm256_add_pd(acumulador2, acumulador3));
+  // Reducción horizontal: 4 -> 2 -> 1
+  __m128d mitad = _mm_add_pd(_mm256_castpd256_pd128(total),
+                             _mm256_extractf128_pd(total, 1));
+  double suma = _mm_cvtsd_f64(_mm_add_sd(mitad, _mm_unpackhi_pd(mitad, mitad)));
+  for (; i < longitud; ++i) {
+    suma += bloque[i];
+  }
+  return suma;
+}
+
+/**
+ * @brief Método para sumar un bloque contiguo con cuatro acumuladores
+ *        AVX-512 (32 doubles por iteración)
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma de los elementos del bloque
+ */
+__attribute__((target("avx512f")))
+double SimdReducer::sumAvx512(const double* bloque, uint64_t longitud) {
+  __m512d acumulador0 = _mm512_setzero_pd();
+  __m512d acumulador1 = _mm512_setzero_pd();
+  __m512d acumulador2 = _mm512_setzero_pd();
+  __m512d acumulador3 = _mm512_setzero_pd();
+  uint64_t i = 0;
+  for (; i + 32 <= longitud; i += 32) {
+    acumulador0 = _mm512_add_pd(acumulador0, _mm512_loadu_pd(bloque + i));
+    acumulador1 = _mm512_add_pd(acumulador1, _mm512_loadu_pd(bloque + i + 8));
+    acumulador2 = _mm512_add_pd(acumulador2, _mm512_loadu_pd(bloque + i + 16));
+    acumulador3 = _mm512_add_pd(acumulador3, _mm512_loadu_pd(bloque + i + 24));
+  }
+  // La cola se suma con una carga enmascarada
+  for (; i < longitud; i += 8) {
+    uint64_t restantes = longitud - i < 8 ? longitud - i : 8;
+    __mmask8 mascara = static_cast<__mmask8>((1u << restantes) - 1);
+    acumulador0 = _mm512_add_pd(acumulador0,
+                                _mm512_maskz_loadu_pd(mascara, bloque + i));
+  }
+  __m512d total = _mm512_add_pd(_mm512_add_pd(acumulador0, acumulador1),
+                                _mm512_add_pd(acumulador2, acumulador3));
+  return _mm512_reduce_add_pd(total);
+}
+
+/**
+ * @brief Función para reducir horizontalmente cuatro acumuladores AVX2
+ */
+__attribute__((target("avx2")))
+static double reduceAvx2(__m256d a, __m256d b, __m256d c, __m256d d) {
+  __m256d total = _mm256_add_pd(_mm256_add_pd(a, b), _mm256_add_pd(c, d));
+  __m128d mitad = _mm_add_pd(_mm256_castpd256_pd128(total),
+                             _mm256_extractf128_pd(total, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(mitad, _mm_unpackhi_pd(mitad, mitad)));
+}
+
+/**
+ * @brief Función para ampliar 8 bfloat16 consecutivos a 8 floats
+ */
+__attribute__((target("avx2")))
+static __m256 loadBfloat16x8(const Bfloat16* bloque) {
+  __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bloque));
+  return _mm256_castsi256_ps(
+      _mm256_slli_epi32(_mm256_cvtepu16_epi32(bits), 16));
+}
+
+/**
+ * @brief Método para sumar en double un bloque contiguo de floats con cuatro
+ *        acumuladores AVX2 (16 floats por iteración)
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma de los elementos del bloque
+ */
+__attribute__((target("avx2")))
+double SimdReducer::sumAvx2(const float* bloque, uint64_t longitud) {
+  __m256d acumulador0 = _mm256_setzero_pd();
+  __m256d acumulador1 = _mm256_setzero_pd();
+  __m256d acumulador2 = _mm256_setzero_pd();
+  __m256d acumulador3 = _mm256_setzero_pd();
+  uint64_t i = 0;
+  for (; i + 16 <= longitud; i += 16) {
+    acumulador0 = _mm256_add_pd(acumulador0,
+                                _mm256_cvtps_pd(_mm_loadu_ps(bloque + i)));
+    acumulador1 = _mm256_add_pd(acumulador1,
+                                _mm256_cvtps_pd(_mm_loadu_ps(bloque + i + 4)));
+    acumulador2 = _mm256_add_pd(acumulador2,
+                                _mm256_cvtps_pd(_mm_loadu_ps(bloque + i + 8)));
+    acumulador3 = _mm256_add_pd(acumulador3,
+                                _mm256_cvtps_pd(_mm_loadu_ps(bloque + i + 12)));
+  }
+  double suma = reduceAvx2(acumulador0, acumulador1, acumulador2, acumulador3);
+  for (; i < longitud; ++i) {
+    suma += bloque[i];
+  }
+  return suma;
+}
+
+/**
+ * @brief Método para sumar en double un bloque contiguo de bfloat16 con
+ *        cuatro acumuladores AVX2 (16 valores por iteración)
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma de los elementos del bloque
+ */
+__attribute__((target("avx2")))
+double SimdReducer::sumAvx2(const Bfloat16* bloque, uint64_t longitud) {
+  __m256d acumulador0 = _mm256_setzero_pd();
+  __m256d acumulador1 = _mm256_setzero_pd();
+  __m256d acumulador2 = _mm256_setzero_pd();
+  __m256d acumulador3 = _mm256_setzero_pd();
+  uint64_t i = 0;
+  for (; i + 16 <= longitud; i += 16) {
+    __m256 bajos = loadBfloat16x8(bloque + i);
+    __m256 altos = loadBfloat16x8(bloque + i + 8);
+    acumulador0 = _mm256_add_pd(
+        acumulador0, _mm256_cvtps_pd(_mm256_castps256_ps128(bajos)));
+    acumulador1 = _mm256_add_pd(
+        acumulador1, _mm256_cvtps_pd(_mm256_extractf128_ps(bajos, 1)));
+    acumulador2 = _mm256_add_pd(
+        acumulador2, _mm256_cvtps_pd(_mm256_castps256_ps128(altos)));
+    acumulador3 = _mm256_add_pd(
+        acumulador3, _mm256_cvtps_pd(_mm256_extractf128_ps(altos, 1)));
+  }
+  double suma = reduceAvx2(acumulador0, acumulador1, acumulador2, acumulador3);
+  for (; i < longitud; ++i) {
+    suma += bloque[i];
+  }
+  return suma;
+}
+
+/**
+ * @brief Método para sumar en double un bloque contiguo de floats con cuatro
+ *        acumuladores AVX-512 (32 floats por iteración)
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma de los elementos del bloque
+ */
+__attribute__((target("avx512f")))
+double SimdReducer::sumAvx512(const float* bloque, uint64_t longitud) {
+  __m512d acumulador0 = _mm512_setzero_pd();
+  __m512d acumulador1 = _mm512_setzero_pd();
+  __m512d acumulador2 = _mm512_setzero_pd();
+  __m512d acumulador3 = _mm512_setzero_pd();
+  uint64_t i = 0;
+  for (; i + 32 <= longitud; i += 32) {
+    acumulador0 = _mm512_add_pd(acumulador0,
+                                _mm512_cvtps_pd(_mm256_loadu_ps(bloque + i)));
+    acumulador1 = _mm512_add_pd(
+        acumulador1, _mm512_cvtps_pd(_mm256_loadu_ps(bloque + i + 8)));
+    acumulador2 = _mm512_add_pd(
+        acumulador2, _mm512_cvtps_pd(_mm256_loadu_ps(bloque + i + 16)));
+    acumulador3 = _mm512_add_pd(
+        acumulador3, _mm512_cvtps_pd(_mm256_loadu_ps(bloque + i + 24)));
+  }
+  // La cola se suma con una carga enmascarada
+  for (; i < longitud; i += 8) {
+    uint64_t restantes = longitud - i < 8 ? longitud - i : 8;
+    __mmask16 mascara = static_cast<__mmask16>((1u << restantes) - 1);
+    __m512 cola = _mm512_maskz_loadu_ps(mascara, bloque + i);
+    acumulador0 = _mm512_add_pd(acumulador0,
+                                _mm512_cvtps_pd(_mm512_castps512_ps256(cola)));
+  }
+  __m512d total = _mm512_add_pd(_mm512_add_pd(acumulador0, acumulador1),
+                                _mm512_add_pd(acumulador2, acumulador3));
+  return _mm512_reduce_add_pd(total);
+}
+
+/**
+ * @brief Método para sumar en double un bloque contiguo de bfloat16 con
+ *        cuatro acumuladores AVX-512 (32 valores por iteración)
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma de los elementos del bloque
+ */
+__attribute__((target("avx512f")))
+double SimdReducer::sumAvx512(const Bfloat16* bloque, uint64_t longitud) {
+  __m512d acumulador0 = _mm512_setzero_pd();
+  __m512d acumulador1 = _mm512_setzero_pd();
+  __m512d acumulador2 = _mm512_setzero_pd();
+  __m512d acumulador3 = _mm512_setzero_pd();
+  uint64_t i = 0;
+  for (; i + 32 <= longitud; i += 32) {
+    acumulador0 = _mm512_add_pd(acumulador0,
+                                _mm512_cvtps_pd(loadBfloat16x8(bloque + i)));
+    acumulador1 = _mm512_add_pd(
+        acumulador1, _mm512_cvtps_pd(loadBfloat16x8(bloque + i + 8)));
+    acumulador2 = _mm512_add_pd(
+        acumulador2, _mm512_cvtps_pd(loadBfloat16x8(bloque + i + 16)));
+    acumulador3 = _mm512_add_pd(
+        acumulador3, _mm512_cvtps_pd(loadBfloat16x8(bloque + i + 24)));
+  }
+  __m512d total = _mm512_add_pd(_mm512_add_pd(acumulador0, acumulador1),
+                                _mm512_add_pd(acumulador2, acumulador3));
+  double suma = _mm512_reduce_add_pd(total);
+  for (; i < longitud; ++i) {
+    suma += bloque[i];
+  }
+  return suma;
+}
+/**
+ * @brief Función para acumular cuatro vectores AVX2 en los acumuladores de
+ *        suma y en los de mínimo y máximo
+ */
+__attribute__((target("avx2")))
+static inline void accumulateAvx2(__m256d a, __m256d b, __m256d c, __m256d d,
+                                  __m256d (&sumas)[4], __m256d& minimo,
+                                  __m256d& maximo) {
+  sumas[0] = _mm256_add_pd(sumas[0], a);
+  sumas[1] = _mm256_add_pd(sumas[1], b);
+  sumas[2] = _mm256_add_pd(sumas[2], c);
+  sumas[3] = _mm256_add_pd(sumas[3], d);
+  minimo = _mm256_min_pd(
+      minimo, _mm256_min_pd(_mm256_min_pd(a, b), _mm256_min_pd(c, d)));
+  maximo = _mm256_max_pd(
+      maximo, _mm256_max_pd(_mm256_max_pd(a, b), _mm256_max_pd(c, d)));
+}
+
+/**
+ * @brief Función para reducir horizontalmente los acumuladores AVX2 de un
+ *        resumen y añadir la cola escalar del bloque
+ */
+template <class Valor>
+__attribute__((target("avx2")))
+static BlockSummary finishSummaryAvx2(__m256d (&sumas)[4], __m256d minimo,
+                                      __m256d maximo, const Valor* bloque,
+                                      uint64_t inicio, uint64_t longitud) {
+  alignas(32) double minimos[4];
+  alignas(32) double maximos[4];
+  _mm256_store_pd(minimos, minimo);
+  _mm256_store_pd(maximos, maximo);
+  BlockSummary resumen{reduceAvx2(sumas[0], sumas[1], sumas[2], sumas[3]),
+                       std::min(std::min(minimos[0], minimos[1]),
+                                std::min(minimos[2], minimos[3])),
+                       std::max(std::max(maximos[0], maximos[1]),
+                                std::max(maximos[2], maximos[3]))};
+  for (uint64_t i = inicio; i < longitud; ++i) {
+    double valor = static_cast<double>(bloque[i]);
+    resumen.suma += valor;
+    resumen.minimo = std::min(resumen.minimo, valor);
+    resumen.maximo = std::max(resumen.maximo, valor);
+  }
+  return resumen;
+}
+
+/**
+ * @brief Método para calcular la suma y el rango de un bloque contiguo con
+ *        acumuladores AVX2 (16 doubles por iteración)
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma, mínimo y máximo de los elementos del bloque
+ */
+__attribute__((target("avx2")))
+BlockSummary SimdReducer::summarizeAvx2(const double* bloque,
+                                        uint64_t longitud) {
+  __m256d sumas[4] = {_mm256_setzero_pd(), _mm256_setzero_pd(),
+                      _mm256_setzero_pd(), _mm256_setzero_pd()};
+  __m256d minimo = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+  __m256d maximo = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+  uint64_t i = 0;
+  for (; i + 16 <= longitud; i += 16) {
+    accumulateAvx2(_mm256_loadu_pd(bloque + i), _mm256_loadu_pd(bloque + i + 4),
+                   _mm256_loadu_pd(bloque + i + 8),
+                   _mm256_loadu_pd(bloque + i + 12), sumas, minimo, maximo);
+  }
+  return finishSummaryAvx2(sumas, minimo, maximo, bloque, i, longitud);
+}
+
+/**
+ * @brief Método para calcular en double la suma y el rango de un bloque
+ *        contiguo de floats con acumuladores AVX2 (16 floats por iteración)
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma, mínimo y máximo de los elementos del bloque
+ */
+__attribute__((target("avx2")))
+BlockSummary SimdReducer::summarizeAvx2(const float* bloque,
+                                        uint64_t longitud) {
+  __m256d sumas[4] = {_mm256_setzero_pd(), _mm256_setzero_pd(),
+                      _mm256_setzero_pd(), _mm256_setzero_pd()};
+  __m256d minimo = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+  __m256d maximo = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+  uint64_t i = 0;
+  for (; i + 16 <= longitud; i += 16) {
+    accumulateAvx2(_mm256_cvtps_pd(_mm_loadu_ps(bloque + i)),
+                   _mm256_cvtps_pd(_mm_loadu_ps(bloque + i + 4)),
+                   _mm256_cvtps_pd(_mm_loadu_ps(bloque + i + 8)),
+                   _mm256_cvtps_pd(_mm_loadu_ps(bloque + i + 12)), sumas,
+                   minimo, maximo);
+  }
+  return finishSummaryAvx2(sumas, minimo, maximo, bloque, i, longitud);
+}
+
+/**
+ * @brief Método para calcular en double la suma y el rango de un bloque
+ *        contiguo de bfloat16 con acumuladores AVX2 (16 valores por iteración)
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma, mínimo y máximo de los elementos del bloque
+ */
+__attribute__((target("avx2")))
+BlockSummary SimdReducer::summarizeAvx2(const Bfloat16* bloque,
+                                        uint64_t longitud) {
+  __m256d sumas[4] = {_mm256_setzero_pd(), _mm256_setzero_pd(),
+                      _mm256_setzero_pd(), _mm256_setzero_pd()};
+  __m256d minimo = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+  __m256d maximo = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+  uint64_t i = 0;
+  for (; i + 16 <= longitud; i += 16) {
+    __m256 bajos = loadBfloat16x8(bloque + i);
+    __m256 altos = loadBfloat16x8(bloque + i + 8);
+    accumulateAvx2(_mm256_cvtps_pd(_mm256_castps256_ps128(bajos)),
+                   _mm256_cvtps_pd(_mm256_extractf128_ps(bajos, 1)),
+                   _mm256_cvtps_pd(_mm256_castps256_ps128(altos)),
+                   _mm256_cvtps_pd(_mm256_extractf128_ps(altos, 1)), sumas,
+                   minimo, maximo);
+  }
+  return finishSummaryAvx2(sumas, minimo, maximo, bloque, i, longitud);
+}
+
+/**
+ * @brief Función para acumular cuatro vectores AVX-512 en los acumuladores
+ *        de suma y en los de mínimo y máximo
+ */
+__attribute__((target("avx512f")))
+static inline void accumulateAvx512(__m512d a, __m512d b, __m512d c,
+                                    __m512d d, __m512d (&sumas)[4],
+                                    __m512d& minimo, __m512d& maximo) {
+  sumas[0] = _mm512_add_pd(sumas[0], a);
+  sumas[1] = _mm512_add_pd(sumas[1], b);
+  sumas[2] = _mm512_add_pd(sumas[2], c);
+  sumas[3] = _mm512_add_pd(sumas[3], d);
+  minimo = _mm512_min_pd(
+      minimo, _mm512_min_pd(_mm512_min_pd(a, b), _mm512_min_pd(c, d)));
+  maximo = _mm512_max_pd(
+      maximo, _mm512_max_pd(_mm512_max_pd(a, b), _mm512_max_pd(c, d)));
+}
+
+/**
+ * @brief Función para reducir horizontalmente los acumuladores AVX-512 de un
+ *        resumen y añadir la cola escalar del bloque
+ */
+template <class Valor>
+__attribute__((target("avx512f")))
+static BlockSummary finishSummaryAvx512(__m512d (&sumas)[4], __m512d minimo,
+                                        __m512d maximo, const Valor* bloque,
+                                        uint64_t inicio, uint64_t longitud) {
+  __m512d total = _mm512_add_pd(_mm512_add_pd(sumas[0], sumas[1]),
+                                _mm512_add_pd(sumas[2], sumas[3]));
+  BlockSummary resumen{_mm512_reduce_add_pd(total),
+                       _mm512_reduce_min_pd(minimo),
+                       _mm512_reduce_max_pd(maximo)};
+  for (uint64_t i = inicio; i < longitud; ++i) {
+    double valor = static_cast<double>(bloque[i]);
+    resumen.suma += valor;
+    resumen.minimo = std::min(resumen.minimo, valor);
+    resumen.maximo = std::max(resumen.maximo, valor);
+  }
+  return resumen;
+}
+
+/**
+ * @brief Método para calcular la suma y el rango de un bloque contiguo con
+ *        acumuladores AVX-512 (32 doubles por iteración)
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma, mínimo y máximo de los elementos del bloque
+ */
+__attribute__((target("avx512f")))
+BlockSummary SimdReducer::summarizeAvx512(const double* bloque,
+                                          uint64_t longitud) {
+  __m512d sumas[4] = {_mm512_setzero_pd(), _mm512_setzero_pd(),
+                      _mm512_setzero_pd(), _mm512_setzero_pd()};
+  __m512d minimo = _mm512_set1_pd(std::numeric_limits<double>::infinity());
+  __m512d maximo = _mm512_set1_pd(-std::numeric_limits<double>::infinity());
+  uint64_t i = 0;
+  for (; i + 32 <= longitud; i += 32) {
+    accumulateAvx512(_mm512_loadu_pd(bloque + i),
+                     _mm512_loadu_pd(bloque + i + 8),
+                     _mm512_loadu_pd(bloque + i + 16),
+                     _mm512_loadu_pd(bloque + i + 24), sumas, minimo, maximo);
+  }
+  return finishSummaryAvx512(sumas, minimo, maximo, bloque, i, longitud);
+}
+
+/**
+ * @brief Método para calcular en double la suma y el rango de un bloque
+ *        contiguo de floats con acumuladores AVX-512 (32 floats por iteración)
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma, mínimo y máximo de los elementos del bloque
+ */
+__attribute__((target("avx512f")))
+BlockSummary SimdReducer::summarizeAvx512(const float* bloque,
+                                          uint64_t longitud) {
+  __m512d sumas[4] = {_mm512_setzero_pd(), _mm512_setzero_pd(),
+                      _mm512_setzero_pd(), _mm512_setzero_pd()};
+  __m512d minimo = _mm512_set1_pd(std::numeric_limits<double>::infinity());
+  __m512d maximo = _mm512_set1_pd(-std::numeric_limits<double>::infinity());
+  uint64_t i = 0;
+  for (; i + 32 <= longitud; i += 32) {
+    accumulateAvx512(_mm512_cvtps_pd(_mm256_loadu_ps(bloque + i)),
+                     _mm512_cvtps_pd(_mm256_loadu_ps(bloque + i + 8)),
+                     _mm512_cvtps_pd(_mm256_loadu_ps(bloque + i + 16)),
+                     _mm512_cvtps_pd(_mm256_loadu_ps(bloque + i + 24)), sumas,
+                     minimo, maximo);
+  }
+  return finishSummaryAvx512(sumas, minimo, maximo, bloque, i, longitud);
+}
+
+/**
+ * @brief Método para calcular en double la suma y el rango de un bloque
+ *        contiguo de bfloat16 con acumuladores AVX-512 (32 valores por
+ *        iteración)
+ * @param[in] bloque: Puntero al primer elemento del bloque
+ * @param[in] longitud: Número de elementos del bloque
+ * @return Suma, mínimo y máximo de los elementos del bloque
+ */
+__attribute__((target("avx512f")))
+BlockSummary SimdReducer::summarizeAvx512(const Bfloat16* bloque,
+                                          uint64_t longitud) {
+  __m512d sumas[4] = {_mm512_setzero_pd(), _mm512_setzero_pd(),
+                      _mm512_setzero_pd(), _mm512_setzero_pd()};
+  __m512d minimo = _mm512_set1_pd(std::numeric_limits<double>::infinity());
+  __m512d maximo = _mm512_set1_pd(-std::numeric_limits<double>::infinity());
+  uint64_t i = 0;
+  for (; i + 32 <= longitud; i += 32) {
+    accumulateAvx512(_mm512_cvtps_pd(loadBfloat16x8(bloque + i)),
+                     _mm512_cvtps_pd(loadBfloat16x8(bloque + i + 8)),
+                     _mm512_cvtps_pd(loadBfloat16x8(bloque + i + 16)),
+                     _mm512_cvtps_pd(loadBfloat16x8(bloque + i + 24)), sumas,
+                     minimo, maximo);
+  }
+  return finishSummaryAvx512(sumas, minimo, maximo, bloque, i, longitud);
+}
+/**
+ * @brief Método para plegar la mitad superior de un bloque sobre la inferior
+ *        con vectores AVX2 (8 doubles por iteración)
+ * @param[in,out] bloque: Puntero al primer elemento del bloque de 2·mitad
+ *                        elementos (la mitad superior no se modifica)
+ * @param[in] mitad: Número de elementos de cada mitad
+ * @return Suma de la mitad superior
+ */
+__attribute__((target("avx2")))
+double SimdReducer::foldAvx2(double* bloque, uint64_t mitad) {
+  const double* alto = bloque + mitad;
+  __m256d acumulador0 = _mm256_setzero_pd();
+  __m256d acumulador1 = _mm256_setzero_pd();
+  uint64_t i = 0;
+  for (; i + 8 <= mitad; i += 8) {
+    __m256d alto0 = _mm256_loadu_pd(alto + i);
+    __m256d alto1 = _mm256_loadu_pd(alto + i + 4);
+    acumulador0 = _mm256_add_pd(acumulador0, alto0);
+    acumulador1 = _mm256_add_pd(acumulador1, alto1);
+    _mm256_storeu_pd(bloque + i,
+                     _mm256_add_pd(_mm256_loadu_pd(bloque + i), alto0));
+    _mm256_storeu_pd(bloque + i + 4,
+                     _mm256_add_pd(_mm256_loadu_pd(bloque + i + 4), alto1));
+  }
+  for (; i + 4 <= mitad; i += 4) {
+    __m256d alto0 = _mm256_loadu_pd(alto + i);
+    acumulador0 = _mm256_add_pd(acumulador0, alto0);
+    _mm256_storeu_pd(bloque + i,
+                     _mm256_add_pd(_mm256_loadu_pd(bloque + i), alto0));
+  }
+  __m256d total = _mm256_add_pd(acumulador0, acumulador1);
+  __m128d medio = _mm_add_pd(_mm256_castpd256_pd128(total),
+                             _mm256_extractf128_pd(total, 1));
+  double suma = _mm_cvtsd_f64(_mm_add_sd(medio, _mm_unpackhi_pd(medio, medio)));
+  for (; i < mitad; ++i) {
+    suma += alto[i];
+    bloque[i] += alto[i];
+  }
+  return suma;
+}
+
+/**
+ * @brief Método para plegar la mitad superior de un bloque sobre la inferior
+ *        con vectores AVX-512 (16 doubles por iteración)
+ * @param[in,out] bloque: Puntero al primer elemento del bloque de 2·mitad
+ *                        elementos (la mitad superior no se modifica)
+ * @param[in] mitad: Número de elementos de cada mitad
+ * @return Suma de la mitad superior
+ */
+__attribute__((target("avx512f")))
+double SimdReducer::foldAvx512(double* bloque, uint64_t mitad) {
+  const double* alto = bloque + mitad;
+  __m512d acumulador0 = _mm512_setzero_pd();
+  __m512d acumulador1 = _mm512_setzero_pd();
+  uint64_t i = 0;
+  for (; i + 16 <= mitad; i += 16) {
+    __m512d alto0 = _mm512_loadu_pd(alto + i);
+    __m512d alto1 = _mm512_loadu_pd(alto + i + 8);
+    acumulador0 = _mm512_add_pd(acumulador0, alto0);
+    acumulador1 = _mm512_add_pd(acumulador1, alto1);
+    _mm512_storeu_pd(bloque + i,
+                     _mm512_add_pd(_mm512_loadu_pd(bloque + i), alto0));
+    _mm512_storeu_pd(bloque + i + 8,
+                     _mm512_add_pd(_mm512_loadu_pd(bloque + i + 8), alto1));
+  }
+  // La cola (y las mitades de menos de 16) se pliega con máscaras
+  for (; i < mitad; i += 8) {
+    uint64_t restantes = mitad - i < 8 ? mitad - i : 8;
+    __mmask8 mascara = static_cast<__mmask8>((1u << restantes) - 1);
+    __m512d alto0 = _mm512_maskz_loadu_pd(mascara, alto + i);
+    acumulador0 = _mm512_add_pd(acumulador0, alto0);
+    _mm512_mask_storeu_pd(
+        bloque + i, mascara,
+        _mm512_add_pd(_mm512_maskz_loadu_pd(mascara, bloque + i), alto0));
+  }
+  return _mm512_reduce_add_pd(_mm512_add_pd(acumulador0, acumulador1));
+}
+#else
+// Sin x86-64 no existen AVX2 ni AVX-512: se delega en la suma escalar
+double SimdReducer::sumAvx2(const float* bloque, uint64_t longitud) {
+  return sumScalar(bloque, longitud);
+}
+
+double SimdReducer::sumAvx512(const float* bloque, uint64_t longitud) {
+  return sumScalar(bloque, longitud);
+}
+
+double SimdReducer::sumAvx2(const Bfloat16* bloque, uint64_t longitud) {
+  return sumScalar(bloque, longitud);
+}
+
+double SimdReducer::sumAvx512(const Bfloat16* bloque, uint64_t longitud) {
+  return sumScalar(bloque, longitud);
+}
+
+double SimdReducer::sumAvx2(const double* bloque, uint64_t longitud) {
+  return sumScalar(bloque, longitud);
+}
+
+double SimdReducer::sumAvx512(const double* bloque, uint64_t longitud) {
+  return sumScalar(bloque, longitud);
+}
+
+BlockSummary SimdReducer::summarizeAvx2(const double* bloque,
+                                        uint64_t longitud) {
+  return summarizeScalar(bloque, longitud);
+}
+
+BlockSummary SimdReducer::summarizeAvx512(const double* bloque,
+                                          uint64_t longitud) {
+  return summarizeScalar(bloque, longitud);
+}
+
+BlockSummary SimdReducer::summarizeAvx2(const float* bloque,
+                                        uint64_t longitud) {
+  return summarizeScalar(bloque, longitud);
+}
+
+BlockSummary SimdReducer::summarizeAvx512(const float* bloque,
+                                          uint64_t longitud) {
+  return summarizeScalar(bloque, longitud);
+}
+
+BlockSummary SimdReducer::summarizeAvx2(const Bfloat16* bloque,
+                                        uint64_t longitud) {
+  return summarizeScalar(bloque, longitud);
+}
+
+BlockSummary SimdReducer::summarizeAvx512(const Bfloat16* bloque,
+                                          uint64_t longitud) {
+  return summarizeScalar(bloque, longitud);
+}
+
+double SimdReducer::foldAvx2(double* bloque, uint64_t mitad) {
+  return foldScalar(bloque, mitad);
+}
+
+double SimdReducer::foldAvx512(double* bloque, uint64_t mitad) {
+  return foldScalar(bloque, mitad);
+}
+#endif
@@ -0,0 +1,99 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   simd_reducer.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase SimdReducer, que suma bloques contiguos de
+ *         probabilidades con instrucciones vectoriales (AVX2 / AVX-512).
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "../storage_type/storage_type.h"
+
+/**
+ * @brief Variantes del núcleo de reducción vectorial. Se elige una sola vez
+ *        en tiempo de ejecución según las capacidades de la CPU.
+ */
+enum class SimdKernel {
+  kScalar,  ///< Suma escalar con varios acumuladores
+  kAvx2,    ///< Vectores de 4 doubles
+  kAvx512   ///< Vectores de 8 doubles
+};
+
+/**
+ * @brief Resumen de un bloque contiguo de probabilidades: su suma y el rango
+ *        de sus valores. Un NaN o un infinito se propaga a la suma.
+ */
+struct BlockSummary {
+  double suma;
+  double minimo;
+  double maximo;
+};
+
+/**
+ * @brief Clase con los núcleos de suma de bloques contiguos de doubles. Los
+ *        bloques de float y bfloat16 se amplían a double antes de sumar.
+ */
+class SimdReducer {
+ public:
+  /// Tipo de las funciones de suma: (bloque, longitud) -> suma
+  using SumFunction = double (*)(const double*, uint64_t);
+  using SumFunctionFloat = double (*)(const float*, uint64_t);
+  using SumFunctionBfloat16 = double (*)(const Bfloat16*, uint64_t);
+  /// Tipo de las funciones de resumen: (bloque, longitud) -> suma y rango
+  using SummaryFunction = BlockSummary (*)(const double*, uint64_t);
+  using SummaryFunctionFloat = BlockSummary (*)(const float*, uint64_t);
+  using SummaryFunctionBfloat16 = BlockSummary (*)(const Bfloat16*, uint64_t);
+  /// Tipo de las funciones de plegado: (bloque, mitad) -> suma de la mitad
+  /// superior, que se suma posición a posición sobre la inferior
+  using FoldFunction = double (*)(double*, uint64_t);
+
+  /// Método para detectar mediante CPUID el mejor núcleo disponible
+  static SimdKernel detectKernel();
+  /// Métodos para obtener la función de suma de un núcleo
+  static SumFunction sumFunction(SimdKernel);
+  static SumFunctionFloat sumFunctionFloat(SimdKernel);
+  static SumFunctionBfloat16 sumFunctionBfloat16(SimdKernel);
+  /// Métodos para obtener la función de resumen de un núcleo
+  static SummaryFunction summaryFunction(SimdKernel);
+  static SummaryFunctionFloat summaryFunctionFloat(SimdKernel);
+  static SummaryFunctionBfloat16 summaryFunctionBfloat16(SimdKernel);
+  /// Método para obtener la función de plegado de un núcleo
+  static FoldFunction foldFunction(SimdKernel);
+
+  /// Núcleos de suma de un bloque contiguo
+  static double sumScalar(const double*, uint64_t);
+  static double sumAvx2(const double*, uint64_t);
+  static double sumAvx512(const double*, uint64_t);
+  static double sumScalar(const float*, uint64_t);
+  static double sumAvx2(const float*, uint64_t);
+  static double sumAvx512(const float*, uint64_t);
+  static double sumScalar(const Bfloat16*, uint64_t);
+  static double sumAvx2(const Bfloat16*, uint64_t);
+  static double sumAvx512(const Bfloat16*, uint64_t);
+
+  /// Núcleos que calculan en una sola pasada la suma y el rango de un bloque
+  static BlockSummary summarizeScalar(const double*, uint64_t);
+  static BlockSummary summarizeAvx2(const double*, uint64_t);
+  static BlockSummary summarizeAvx512(const double*, uint64_t);
+  static BlockSummary summarizeScalar(const float*, uint64_t);
+  static BlockSummary summarizeAvx2(const float*, uint64_t);
+  static BlockSummary summarizeAvx512(const float*, uint64_t);
+  static BlockSummary summarizeScalar(const Bfloat16*, uint64_t);
+  static BlockSummary summarizeAvx2(const Bfloat16*, uint64_t);
+  static BlockSummary summarizeAvx512(const Bfloat16*, uint64_t);
+
+  /// Núcleos que pliegan la mitad superior de un bloque sobre la inferior
+  static double foldScalar(double*, uint64_t);
+  static double foldAvx2(double*, uint64_t);
+  static double foldAvx512(double*, uint64_t);
+};
@@ -0,0 +1,93 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   storage_type.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Tipos de almacenamiento de la tabla conjunta (double, float y
+ *         bfloat16) y sus cotas de precisión.
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+/**
+ * @brief Tipo con el que se almacena cada probabilidad de la tabla conjunta.
+ *        Las sumas se acumulan siempre en double, de modo que el almacenamiento
+ *        solo introduce el redondeo de cada valor al guardarlo.
+ *
+ *        Cotas de precisión (u = error relativo de redondeo del tipo):
+ *        - Cada probabilidad almacenada p' cumple |p' - p| <= u·p.
+ *        - Toda masa marginal M acumulada desde la tabla cumple
+ *          |M' - M| <= u·M (más el error de la suma en double, ~n·2^-53·M).
+ *        - Una probabilidad condicionada M_i / Σ M_j tiene error relativo
+ *          menor que 2u.
+ *        Con float u = 2^-24 (~6·10^-8); con bfloat16 u = 2^-8 (~3.9·10^-3).
+ *        Valores por debajo de ~1.2·10^-38 se almacenan como subnormales o
+ *        cero en ambos tipos.
+ */
+enum class StorageType {
+  kDouble,   ///< 8 bytes por estado, sin pérdida
+  kFloat,    ///< 4 bytes por estado
+  kBfloat16  ///< 2 bytes por estado (float truncado a 8 bits de mantisa)
+};
+
+/**
+ * @brief Valor bfloat16: los 16 bits altos de un float IEEE-754. Se convierte
+ *        implícitamente a double para que los núcleos genéricos lo lean igual
+ *        que un float o un double.
+ */
+struct Bfloat16 {
+  uint16_t bits = 0;
+
+  Bfloat16() = default;
+  /// Redondeo al más cercano (empates a par) desde double
+  explicit Bfloat16(double valor) {
+    uint32_t completo = std::bit_cast<uint32_t>(static_cast<float>(valor));
+    completo += 0x7FFFu + ((completo >> 16) & 1u);
+    bits = static_cast<uint16_t>(completo >> 16);
+  }
+  operator double() const {
+    return std::bit_cast<float>(static_cast<uint32_t>(bits) << 16);
+  }
+};
+
+/**
+ * @brief Función para obtener el error relativo de redondeo de un tipo de
+ *        almacenamiento
+ * @param[in] tipo: Tipo de almacenamiento
+ * @return Cota u del error relativo al guardar un valor
+ */
+inline double storageRelativeError(StorageType tipo) {
+  switch (tipo) {
+    case StorageType::kFloat:
+      return 0x1p-24;
+    case StorageType::kBfloat16:
+      return 0x1p-8;
+    default:
+      return 0x1p-53;
+  }
+}
+
+/**
+ * @brief Función para obtener los bytes que ocupa cada estado en la tabla
+ * @param[in] tipo: Tipo de almacenamiento
+ * @return Bytes por estado
+ */
+inline uint64_t storageBytes(StorageType tipo) {
+  switch (tipo) {
+    case StorageType::kFloat:
+      return sizeof(float);
+    case StorageType::kBfloat16:
+      return sizeof(Bfloat16);
+    default:
+      return sizeof(double);
+  }
+}
@@ -0,0 +1,273 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   streaming_inference_engine.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase StreamingInferenceEngine, que responde
+ *         consultas condicionales leyendo la distribución conjunta del disco
+ *         por bloques, sin cargarla en memoria.
+ */
+
+#include <bit>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <type_traits>
+
+#include "streaming_inference_engine.h"
+#include "../bit_extractor/bit_extractor.h"
+
+/**
+ * @brief Constructor que abre el archivo binario y valida su cabecera; la
+ *        tabla no se lee hasta la primera consulta
+ * @param[in] nombre_archivo: Ruta del archivo binario de distribución
+ * @param[in] bytes_bloque: Tamaño máximo de cada bloque leído (se redondea a
+ *                          una potencia de dos de estados)
+ * @throws std::runtime_error si el archivo no existe o su cabecera no es
+ *         válida
+ * @throws std::invalid_argument si el bloque no admite ni un estado
+ */
+StreamingInferenceEngine::StreamingInferenceEngine(
+    const std::string& nombre_archivo, uint64_t bytes_bloque)
+    : nombre_archivo_(nombre_archivo),
+      archivo_(nombre_archivo, std::ios::binary),
+      nucleo_simd_(SimdReducer::detectKernel()), bytes_leidos_(0),
+      estados_evaluados_(0) {
+  if (!archivo_.is_open()) {
+    throw std::runtime_error("Error: No se puede abrir el archivo " +
+                             nombre_archivo);
+  }
+  archivo_.seekg(0, std::ios::end);
+  uint64_t tamano_archivo = static_cast<uint64_t>(archivo_.tellg());
+  archivo_.seekg(0);
+  BinaryFileHeader cabecera;
+  if (tamano_archivo < sizeof(cabecera) ||
+      !archivo_.read(reinterpret_cast<char*>(&cabecera), sizeof(cabecera))) {
+    throw std::runtime_error("Error: Archivo binario demasiado corto: " +
+                             nombre_archivo);
+  }
+  validateBinaryFileHeader(cabecera, tamano_archivo, nombre_archivo);
+
+  numero_variables_ = static_cast<int>(cabecera.numero_variables);
+  tipo_almacenamiento_ =
+      static_cast<StorageType>(cabecera.tipo_almacenamiento);
+  desplazamiento_datos_ = cabecera.desplazamiento_datos;
+  std::vector<int> orden = headerVariableOrder(cabecera);
+  posicion_fisica_.assign(numero_variables_, 0);
+  for (int i = 0; i < numero_variables_; ++i) {
+    posicion_fisica_[orden[i]] = i;
+  }
+
+  uint64_t estados_maximos = bytes_bloque / storageBytes(tipo_almacenamiento_);
+  if (estados_maximos == 0) {
+    throw std::invalid_argument(
+        "Error: El bloque de lectura debe admitir al menos un estado");
+  }
+  bits_bloque_ =
+      std::min(numero_variables_, 63 - std::countl_zero(estados_maximos));
+  estados_bloque_ = 1ULL << bits_bloque_;
+  uint64_t bytes = estados_bloque_ * storageBytes(tipo_almacenamiento_);
+  for (auto& bufer : buferes_) {
+    bufer.resize((bytes + sizeof(double) - 1) / sizeof(double));
+  }
+}
+
+/**
+ * @brief Método principal para calcular la distribución condicional
+ *        P(X_I | X_C = c) leyendo el archivo
+ * @param[in] consulta: Consulta condicional que especifica las variables de
+ *                      interés y condicionadas
+ * @return Estructura con la distribución condicional resultante y métricas de
+ *         ejecución
+ * @throws std::runtime_error si falla la lectura del archivo
+ */
+InferenceResult StreamingInferenceEngine::computeConditional(
+    const ConditionalQuery& consulta) {
+  InferenceResult resultado;
+  auto inicio = std::chrono::high_resolution_clock::now();
+
+  int numero_bits_interes = consulta.getNumberInterestVariables();
+  uint64_t estados_interes = 1ULL << numero_bits_interes;
+  std::vector<double> salida(estados_interes, 0.0);
+  marginalize(consulta.getMaskC(), consulta.getValC(), consulta.getMaskI(),
+              salida.data());
+
+  double suma = 0.0;
+  for (double masa : salida) {
+    suma += masa;
+  }
+  if (suma > 1e-10) {
+    for (double& masa : salida) {
+      masa /= suma;
+    }
+  }
+  auto distribucion =
+      std::make_unique<BinaryDistribution>(numero_bits_interes);
+  distribucion->assignProbabilities(salida);
+
+  auto fin = std::chrono::high_resolution_clock::now();
+  resultado.tiempo_ejecucion =
+      std::chrono::duration<double, std::micro>(fin - inicio).count();
+  resultado.estados_evaluados = estados_evaluados_;
+  resultado.distribucion = std::move(distribucion);
+  return resultado;
+}
+
+/**
+ * @brief Método para acumular en salida la masa (sin normalizar) de cada
+ *        estado de interés. Los bits físicos altos, que numeran los bloques,
+ *        fijados por la evidencia descartan bloques enteros sin leerlos; los
+ *        bloques consistentes se leen en orden creciente de posición, cada
+ *        uno en otro hilo mientras se marginaliza el anterior.
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] maskI: Máscara de variables de interés
+ * @param[out] salida: Histograma de 2^|I| posiciones inicializado a cero
+ * @throws std::runtime_error si falla la lectura del archivo
+ */
+void StreamingInferenceEngine::marginalize(uint64_t maskC, uint64_t valC,
+                                           uint64_t maskI, double* salida) {
+  bytes_leidos_ = 0;
+  estados_evaluados_ = 0;
+  uint64_t mascara_todas = (1ULL << numero_variables_) - 1;
+  maskC &= mascara_todas;
+  if ((valC & ~maskC) != 0) {
+    return;
+  }
+  uint64_t fisica_c = toPhysicalState(maskC);
+  uint64_t fisico_val = toPhysicalState(valC);
+  uint64_t fisica_i = toPhysicalState(maskI & mascara_todas);
+
+  uint64_t mascara_bloque = estados_bloque_ - 1;
+  uint64_t libres = mascara_todas & ~fisica_c;
+  BitExtractor bloques(libres & ~mascara_bloque);
+  uint64_t base_alta = fisico_val & ~mascara_bloque;
+  uint64_t libres_bajos = libres & mascara_bloque;
+  uint64_t base_baja = fisico_val & mascara_bloque;
+
+  // Los bits bajos marginalizados forman tramos contiguos de cada bloque
+  int bits_tramo = std::countr_one(libres_bajos & ~fisica_i);
+  if (bits_tramo < kBitsMinimosTramo) {
+    bits_tramo = 0;
+  }
+  uint64_t longitud_tramo = 1ULL << bits_tramo;
+  uint64_t libres_exteriores = libres_bajos & ~(longitud_tramo - 1);
+  BitExtractor extractor(fisica_i);
+
+  uint64_t numero_bloques = 1ULL << bloques.getNumberBits();
+  estados_evaluados_ = numero_bloques << std::popcount(libres_bajos);
+  auto indiceBloque = [&](uint64_t j) {
+    return (base_alta | bloques.deposit(j)) >> bits_bloque_;
+  };
+  std::future<void> lectura = std::async(std::launch::async, [&] {
+    readBlock(indiceBloque(0), buferes_[0]);
+  });
+  for (uint64_t j = 0; j < numero_bloques; ++j) {
+    lectura.get();
+    if (j + 1 < numero_bloques) {
+      lectura = std::async(std::launch::async, [&, j] {
+        readBlock(indiceBloque(j + 1), buferes_[(j + 1) % 2]);
+      });
+    }
+    const double* bufer = buferes_[j % 2].data();
+    uint64_t primer_estado = indiceBloque(j) << bits_bloque_;
+    switch (tipo_almacenamiento_) {
+      case StorageType::kFloat:
+        accumulateBlock(reinterpret_cast<const float*>(bufer), primer_estado,
+                        base_baja, libres_exteriores, longitud_tramo,
+                        extractor, salida);
+        break;
+      case StorageType::kBfloat16:
+        accumulateBlock(reinterpret_cast<const Bfloat16*>(bufer),
+                        primer_estado, base_baja, libres_exteriores,
+                        longitud_tramo, extractor, salida);
+        break;
+      default:
+        accumulateBlock(bufer, primer_estado, base_baja, libres_exteriores,
+                        longitud_tramo, extractor, salida);
+    }
+  }
+  reorderCompactedIndex(maskI & mascara_todas, posicion_fisica_, salida,
+                        reordenacion_);
+}
+
+/**
+ * @brief Método para acumular en salida la masa de los estados de un bloque
+ *        consistentes con la evidencia
+ * @param[in] bloque: Probabilidades del bloque
+ * @param[in] primer_estado: Estado físico de la primera posición del bloque
+ * @param[in] base: Bits bajos fijados por la evidencia
+ * @param[in] libres: Bits bajos libres a enumerar (excluido el tramo)
+ * @param[in] longitud_tramo: Longitud del tramo contiguo marginalizado
+ * @param[in] extractor: Extractor de los bits físicos de interés
+ * @param[out] salida: Histograma sobre los estados de interés
+ */
+template <class Valor>
+void StreamingInferenceEngine::accumulateBlock(
+    const Valor* bloque, uint64_t primer_estado, uint64_t base,
+    uint64_t libres, uint64_t longitud_tramo, const BitExtractor& extractor,
+    double* salida) const {
+  uint64_t subconjunto = 0;
+  if (longitud_tramo == 1) {
+    do {
+      uint64_t local = base | subconjunto;
+      salida[extractor.extract(primer_estado | local)] += bloque[local];
+      subconjunto = (subconjunto - libres) & libres;
+    } while (subconjunto != 0);
+    return;
+  }
+
+  double (*sumar)(const Valor*, uint64_t);
+  if constexpr (std::is_same_v<Valor, float>) {
+    sumar = SimdReducer::sumFunctionFloat(nucleo_simd_);
+  } else if constexpr (std::is_same_v<Valor, Bfloat16>) {
+    sumar = SimdReducer::sumFunctionBfloat16(nucleo_simd_);
+  } else {
+    sumar = SimdReducer::sumFunction(nucleo_simd_);
+  }
+  do {
+    uint64_t local = base | subconjunto;
+    salida[extractor.extract(primer_estado | local)] +=
+        sumar(bloque + local, longitud_tramo);
+    subconjunto = (subconjunto - libres) & libres;
+  } while (subconjunto != 0);
+}
+
+/**
+ * @brief Método para leer un bloque de la tabla
+ * @param[in] indice: Índice del bloque (estado físico >> bits_bloque_)
+ * @param[out] bufer: Búfer de destino
+ * @throws std::runtime_error si la lectura falla
+ */
+void StreamingInferenceEngine::readBlock(uint64_t indice,
+                                         std::vector<double>& bufer) {
+  uint64_t bytes = estados_bloque_ * storageBytes(tipo_almacenamiento_);
+  archivo_.seekg(desplazamiento_datos_ + indice * bytes);
+  if (!archivo_.read(reinterpret_cast<char*>(bufer.data()), bytes)) {
+    archivo_.clear();
+    throw std::runtime_error("Error: No se pudo leer el archivo " +
+                             nombre_archivo_);
+  }
+  bytes_leidos_ += bytes;
+}
+
+/**
+ * @brief Método que traduce un estado (o máscara) lógico al orden físico del
+ *        archivo
+ * @param[in] estado: Estado lógico (bit i = variable X_{i+1})
+ * @return Estado equivalente en el orden físico
+ */
+uint64_t StreamingInferenceEngine::toPhysicalState(uint64_t estado) const {
+  uint64_t fisico = 0;
+  while (estado != 0) {
+    fisico |= 1ULL << posicion_fisica_[std::countr_zero(estado)];
+    estado &= estado - 1;
+  }
+  return fisico;
+}
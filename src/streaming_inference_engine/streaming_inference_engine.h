@@ -0,0 +1,100 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   streaming_inference_engine.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase StreamingInferenceEngine, que responde
+ *         consultas condicionales leyendo la distribución conjunta del disco
+ *         por bloques, sin cargarla en memoria.
+ */
+
+#pragma once
+
+#include <array>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../conditional_inference_engine/conditional_inference_engine.h"
+#include "../conditional_query/conditional_query.h"
+#include "../distribution/binary_distribution/binary_file_format.h"
+#include "../simd_reducer/simd_reducer.h"
+#include "../storage_type/storage_type.h"
+
+/**
+ * @brief Clase que responde consultas P(X_I | X_C = c) sobre un archivo
+ *        binario de distribución (ver BinaryDistribution::exportToBinary)
+ *        mayor que la memoria. La tabla se lee en bloques de 2^k estados
+ *        consecutivos; solo se leen los bloques cuyos bits altos son
+ *        consistentes con la evidencia, y el bloque siguiente se lee en otro
+ *        hilo mientras se marginaliza el actual.
+ */
+class StreamingInferenceEngine {
+ public:
+  //-------------------------CONSTRUCTOR-------------------------
+  explicit StreamingInferenceEngine(const std::string&,
+                                    uint64_t = kBytesBloquePorDefecto);
+
+  //-------------------------MÉTODOS-------------------------
+  /// Método principal para calcular la distribución condicional P(X_I | X_C = c)
+  InferenceResult computeConditional(const ConditionalQuery&);
+  /// Método para acumular la masa sin normalizar de cada estado de interés
+  void marginalize(uint64_t, uint64_t, uint64_t, double*);
+  int getNumberVariables() const { return numero_variables_; }
+  StorageType getStorageType() const { return tipo_almacenamiento_; }
+  /// Estados de cada bloque leído del disco (2^k)
+  uint64_t getBlockStates() const { return estados_bloque_; }
+  /// Bytes leídos del disco en la última consulta
+  uint64_t getBytesRead() const { return bytes_leidos_; }
+
+ private:
+  //-----------------CONSTANTES-----------------
+  /// kBytesBloquePorDefecto: Bloques de 16 MB (dos en memoria a la vez)
+  static constexpr uint64_t kBytesBloquePorDefecto = 1ULL << 24;
+  /// kBitsMinimosTramo: Los tramos contiguos de bits marginalizados se
+  ///                    reducen vectorialmente a partir de 2^3 estados
+  static constexpr int kBitsMinimosTramo = 3;
+
+  //-----------------ATRIBUTOS-----------------
+  /// nombre_archivo_: Ruta del archivo binario
+  std::string nombre_archivo_;
+  /// archivo_: Flujo de lectura del archivo (solo lo usa una lectura a la vez)
+  std::ifstream archivo_;
+  int numero_variables_;
+  StorageType tipo_almacenamiento_;
+  /// desplazamiento_datos_: Byte del archivo en que empieza la tabla
+  uint64_t desplazamiento_datos_;
+  /// posicion_fisica_: Bit físico de cada variable lógica
+  std::vector<int> posicion_fisica_;
+  /// bits_bloque_: Cada bloque contiene 2^bits_bloque_ estados
+  int bits_bloque_;
+  uint64_t estados_bloque_;
+  /// buferes_: Bloque en proceso y bloque en lectura anticipada (doubles
+  ///           para garantizar la alineación de cualquier tipo)
+  std::array<std::vector<double>, 2> buferes_;
+  /// nucleo_simd_: Núcleo de reducción vectorial detectado por CPUID
+  SimdKernel nucleo_simd_;
+  /// bytes_leidos_: Bytes leídos del disco en la última consulta
+  uint64_t bytes_leidos_;
+  /// estados_evaluados_: Estados consistentes recorridos en la última
+  ///                     consulta
+  uint64_t estados_evaluados_;
+  /// reordenacion_: Copia física del histograma al pasarlo a orden lógico
+  std::vector<double> reordenacion_;
+
+  //-----------------MÉTODOS PRIVADOS-----------------
+  /// Método para traducir una máscara lógica al orden físico del archivo
+  uint64_t toPhysicalState(uint64_t) const;
+  /// Método para leer el bloque i-ésimo de la tabla en un búfer
+  void readBlock(uint64_t, std::vector<double>&);
+  /// Método para acumular un bloque leído en el histograma
+  template <class Valor>
+  void accumulateBlock(const Valor*, uint64_t, uint64_t, uint64_t, uint64_t,
+                       const BitExtractor&, double*) const;
+};
@@ -0,0 +1,118 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   superset_sum_index.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase SupersetSumIndex, un índice de sumas
+ *         sobre superconjuntos (transformada zeta) de una distribución
+ *         binaria.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "superset_sum_index.h"
+#include "../bit_extractor/bit_extractor.h"
+#include "../parallel_executor/parallel_executor.h"
+
+/**
+ * @brief Constructor que aplica la transformada zeta rápida sobre
+ *        superconjuntos, en O(N·2^N)
+ * @param[in] distribucion: Distribución conjunta a indexar
+ * @param[in] numero_hilos: Número de hilos para construir el índice
+ */
+SupersetSumIndex::SupersetSumIndex(const BinaryDistribution& distribucion,
+                                   int numero_hilos)
+    : numero_variables_(distribucion.getNumberVariables()),
+      version_(distribucion.getVersion()),
+      identificador_(distribucion.getIdentifier()),
+      sumas_(distribucion.getStateSpaceSize()) {
+  distribucion.visitProbabilities([this](const auto* probabilidades) {
+    std::copy(probabilidades, probabilidades + sumas_.size(), sumas_.begin());
+  });
+  uint64_t total = sumas_.size();
+  double* sumas = sumas_.data();
+  // Para cada variable, cada conjunto sin ella acumula el conjunto con ella.
+  // Las tareas cubren tramos alineados de 2·paso posiciones, independientes
+  // entre sí.
+  for (int variable = 0; variable < numero_variables_; ++variable) {
+    uint64_t paso = 1ULL << variable;
+    uint64_t tramo =
+        std::max(2 * paso, std::min<uint64_t>(total, 1ULL << kBitsMinimosTramo));
+    ParallelExecutor::run(total / tramo, numero_hilos, [&](uint64_t tarea) {
+      uint64_t fin = (tarea + 1) * tramo;
+      for (uint64_t base = tarea * tramo; base < fin; base += 2 * paso) {
+        for (uint64_t i = base; i < base + paso; ++i) {
+          sumas[i] += sumas[i + paso];
+        }
+      }
+    });
+  }
+}
+
+/**
+ * @brief Método para calcular la masa conjunta P(X_I = i, X_C = c) para cada
+ *        configuración i de las variables de interés. Se leen las sumas G del
+ *        subcubo formado por los unos de c más cualquier subconjunto de
+ *        A = I ∪ ceros(c), y una transformada de Möbius sobre ese subcubo
+ *        deja en cada posición la probabilidad exacta de la configuración.
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas (contenidos en maskC)
+ * @param[in] maskI: Máscara de variables de interés
+ * @param[out] salida: Histograma de 2^|I| posiciones (se sobrescribe)
+ * @param[out] cubo: Memoria de trabajo de getWorkspaceSize posiciones, que
+ *                   aporta el llamador para que el índice (compartido entre
+ *                   motores) no reserve memoria en cada consulta
+ * @return Número de sumas del índice leídas (2^k)
+ */
+uint64_t SupersetSumIndex::marginalize(uint64_t maskC, uint64_t valC,
+                                       uint64_t maskI, double* salida,
+                                       double* cubo) const {
+  uint64_t variables = maskI | (maskC & ~valC);
+  uint64_t longitud = getWorkspaceSize(maskC, valC, maskI);
+  BitExtractor subcubo(variables);
+
+  for (uint64_t j = 0; j < longitud; ++j) {
+    cubo[j] = sumas_[valC | subcubo.deposit(j)];
+  }
+  for (uint64_t paso = 1; paso < longitud; paso *= 2) {
+    for (uint64_t j = 0; j < longitud; ++j) {
+      if (!(j & paso)) {
+        cubo[j] -= cubo[j | paso];
+      }
+    }
+  }
+
+  // Las configuraciones consistentes con c tienen a 0 los ceros de c. Los
+  // valores negativos solo pueden ser error de redondeo.
+  BitExtractor interes(maskI);
+  uint64_t estados_interes = 1ULL << interes.getNumberBits();
+  for (uint64_t i = 0; i < estados_interes; ++i) {
+    double masa = cubo[subcubo.extract(interes.deposit(i))];
+    salida[i] = std::max(masa, 0.0);
+  }
+  return longitud;
+}
+
+/**
+ * @brief Método para estimar el coste de responder una consulta con el
+ *        índice, en estados equivalentes de un recorrido secuencial de la
+ *        tabla (comparable con 2^(N-|C|))
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] maskI: Máscara de variables de interés
+ * @return Coste estimado
+ */
+double SupersetSumIndex::estimateCost(uint64_t maskC, uint64_t valC,
+                                      uint64_t maskI) {
+  int bits = std::popcount(maskI | (maskC & ~valC));
+  double longitud = std::ldexp(1.0, bits);
+  return longitud * (kCosteAccesoAleatorio + bits);
+}
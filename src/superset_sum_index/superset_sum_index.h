@@ -0,0 +1,80 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   superset_sum_index.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase SupersetSumIndex, un índice de sumas sobre
+ *         superconjuntos (transformada zeta) de una distribución binaria.
+ */
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "../distribution/binary_distribution/binary_distribution.h"
+
+/**
+ * @brief Clase que precalcula, para cada conjunto de variables S, la
+ *        probabilidad de que todas las variables de S valgan 1:
+ *        G(S) = Σ_{T ⊇ S} P(T). Con ella, P(X_I, X_C = c) se obtiene por
+ *        inclusión-exclusión en un tiempo que depende solo de |I| + |C|.
+ *
+ *        La inclusión-exclusión resta términos de magnitud hasta 1, por lo
+ *        que el error absoluto de cada probabilidad conjunta es del orden de
+ *        2^k · ε (k = |I| + número de ceros de c, ε ≈ 1.1e-16).
+ */
+class SupersetSumIndex {
+ public:
+  //-------------------------CONSTRUCTOR-------------------------
+  explicit SupersetSumIndex(const BinaryDistribution&, int = 1);
+
+  //-------------------------MÉTODOS-------------------------
+  int getNumberVariables() const { return numero_variables_; }
+  /// Versión de la distribución a partir de la que se construyó el índice
+  uint64_t getVersion() const { return version_; }
+  /// Identificador de la distribución a partir de la que se construyó
+  uint64_t getDistributionIdentifier() const { return identificador_; }
+  /// Método para obtener P(todas las variables del conjunto valen 1)
+  double getAllOnesProbability(uint64_t conjunto) const {
+    return sumas_[conjunto];
+  }
+
+  /// Método para calcular la masa conjunta P(X_I = i, X_C = c) para cada i
+  uint64_t marginalize(uint64_t, uint64_t, uint64_t, double*, double*) const;
+  /// Número de posiciones de la memoria de trabajo de marginalize (2^k)
+  static uint64_t getWorkspaceSize(uint64_t maskC, uint64_t valC,
+                                   uint64_t maskI) {
+    return 1ULL << std::popcount(maskI | (maskC & ~valC));
+  }
+  /// Método para estimar el coste de una consulta en estados equivalentes
+  /// de un recorrido secuencial
+  static double estimateCost(uint64_t, uint64_t, uint64_t);
+
+ private:
+  //-----------------CONSTANTES-----------------
+  /// kCosteAccesoAleatorio: Coste relativo de leer una suma dispersa del
+  ///                        índice frente a un estado de un recorrido
+  ///                        secuencial (fallo de caché frente a streaming)
+  static constexpr double kCosteAccesoAleatorio = 32.0;
+  /// kBitsMinimosTramo: Cada tarea paralela de la transformada cubre al
+  ///                    menos 2^16 posiciones
+  static constexpr int kBitsMinimosTramo = 16;
+
+  //-----------------ATRIBUTOS-----------------
+  /// numero_variables_: Número de variables de la distribución indexada
+  int numero_variables_;
+  /// version_: Versión de la distribución al construir el índice
+  uint64_t version_;
+  /// identificador_: Identificador de la distribución indexada
+  uint64_t identificador_;
+  /// sumas_: G(S) para cada conjunto S codificado como máscara
+  std::vector<double> sumas_;
+};
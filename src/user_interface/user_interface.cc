@@ -13,9 +13,13 @@
  *         de línea de comandos para interactuar con el motor de inferencia condicional.
  */
 
+#include <charconv>
+#include <iomanip>
 #include <limits>
+#include <random>
 #include <sstream>
 #include "user_interface.h"
+#include "../parallel_executor/parallel_executor.h"
 
 /**
  * @brief Ejecuta el bucle principal de la interfaz de usuario, mostrando el
@@ -72,38 +76,52 @@ void UserInterface::displayMainMenu() const {
   std::cout << "2. Mostrar Distribución Actual" << std::endl;
   std::cout << "3. Ejecutar Inferencia Condicional" << std::endl;
   std::cout << "4. Análisis de Rendimiento" << std::endl;
-  std::cout << "5. Exportar Distribución a CSV" << std::endl;
+  std::cout << "5. Exportar Distribución (CSV o binario)" << std::endl;
   std::cout << "6. Ayuda" << std::endl;
   std::cout << "0. Salir" << std::endl;
 }
 
 /**
  * @brief Permite al usuario cargar una distribución desde un archivo CSV o
- *        generar una distribución aleatoria.
+ *        binario, o generar una distribución aleatoria.
  */
 void UserInterface::loadOrGenerateDistribution() {
   std::cout << "1. Cargar desde archivo CSV" << std::endl;
   std::cout << "2. Generar distribución aleatoria\n";
-  int opcion = readInt("Seleccione opción", 1, 2);
+  std::cout << "3. Cargar desde archivo binario (mmap)\n";
+  int opcion = readInt("Seleccione opción", 1, 3);
   
-  if (opcion == 1) {
+  if (opcion == 1 || opcion == 3) {
     std::string nombre_archivo = readString(
-        "\nIngrese el nombre del archivo CSV");
+        opcion == 1 ? "\nIngrese el nombre del archivo CSV"
+                    : "\nIngrese el nombre del archivo binario");
     
     try {
-      distribucion_ = std::make_unique<BinaryDistribution>(nombre_archivo);
-      motor_ =
-          std::make_unique<ConditionalInferenceEngine>(*distribucion_);
+      if (opcion == 1) {
+        StorageType tipo = readStorageType();
+        distribucion_ = std::make_unique<BinaryDistribution>(
+            nombre_archivo, tipo, ParallelExecutor::hardwareThreads());
+      } else {
+        // El tipo de almacenamiento y el orden físico vienen en la cabecera
+        distribucion_ = std::make_unique<BinaryDistribution>(
+            nombre_archivo, FileFormat::kBinary);
+        if (!distribucion_->verifyChecksum()) {
+          throw std::runtime_error(
+              "La suma de verificación del archivo no coincide");
+        }
+      }
+      motor_ = std::make_unique<ConditionalInferenceEngine>(
+          *distribucion_, ParallelExecutor::hardwareThreads());
+      motor_->setCacheCapacity(kCapacidadCache);
       
       std::cout << "  Variables: " << distribucion_->getNumberVariables()
                 << "\n";
       std::cout << "  Estados: " << distribucion_->getStateSpaceSize()
                 << "\n";
       
-      // Si la distribución no es válida, la normalizamos
-      if (!distribucion_->isValid()) {
-        distribucion_->normalize();
-      }
+      // Si la distribución no es válida, la normalizamos (en la misma
+      // pasada que la valida)
+      distribucion_->normalizeIfInvalid(ParallelExecutor::hardwareThreads());
     } catch (const std::exception& excepcion) {
       std::cout << "\nError al cargar la distribución: " << excepcion.what()
                 << std::endl;
@@ -112,12 +130,45 @@ void UserInterface::loadOrGenerateDistribution() {
     }
   } else {
     int numero_variables = readInt("\nNúmero de variables (1-20)", 1, 20);
+    StorageType tipo = readStorageType();
+    std::cout << "Generador: 1. Uniforme  2. Dirichlet (α = 1)  "
+                 "3. Baja entropía (σ = 3)  4. Casi producto (ε = 0.1)\n";
+    int generador = readInt("Seleccione generador", 1, 4);
+    std::optional<uint64_t> semilla_leida = readSeed();
     
     try {
-      distribucion_ = std::make_unique<BinaryDistribution>(numero_variables);
-      distribucion_->generateRandom();
-      motor_ =
-          std::make_unique<ConditionalInferenceEngine>(*distribucion_);
+      distribucion_ =
+          std::make_unique<BinaryDistribution>(numero_variables, tipo);
+      // Sin semilla, cada ejecución genera una distribución distinta
+      uint64_t semilla =
+          semilla_leida ? *semilla_leida : std::random_device{}();
+      switch (generador) {
+        case 2:
+          distribucion_->generateRandom(semilla,
+                                        ParallelExecutor::hardwareThreads(),
+                                        RandomGenerator::kDirichlet, 1.0);
+          break;
+        case 3:
+          distribucion_->generateRandom(semilla,
+                                        ParallelExecutor::hardwareThreads(),
+                                        RandomGenerator::kLowEntropy, 3.0);
+          break;
+        case 4:
+          distribucion_->generateRandom(semilla,
+                                        ParallelExecutor::hardwareThreads(),
+                                        RandomGenerator::kNearProduct, 0.1);
+          break;
+        default:
+          if (semilla_leida) {
+            distribucion_->generateRandom(semilla,
+                                          ParallelExecutor::hardwareThreads());
+          } else {
+            distribucion_->generateRandom();
+          }
+      }
+      motor_ = std::make_unique<ConditionalInferenceEngine>(
+          *distribucion_, ParallelExecutor::hardwareThreads());
+      motor_->setCacheCapacity(kCapacidadCache);
       
       std::cout << "  Variables: " << numero_variables << std::endl;
       std::cout << "  Estados: " << distribucion_->getStateSpaceSize()
@@ -226,6 +277,9 @@ void UserInterface::executeInference() {
               << consulta->getNumberConditionedVariables() << std::endl;
     std::cout << "  Variables marginalizadas: "
               << consulta->getNumberMarginalizedVariables() << std::endl;
+    const CacheStatistics& cache = motor_->getCacheStatistics();
+    std::cout << "  Caché (aciertos/fallos/expulsiones): " << cache.aciertos
+              << "/" << cache.fallos << "/" << cache.expulsiones << std::endl;
     
     if (readConfirmation("\n¿Guardar resultado en CSV?")) {
       std::string nombre_archivo =
@@ -290,7 +344,7 @@ void UserInterface::displayCurrentDistribution() {
 }
 
 /**
- * @brief Exporta la distribución actual a un archivo CSV, verificando primero
+ * @brief Exporta la distribución actual a un archivo CSV o binario, verificando primero
  *        que una distribución esté cargada y manejando posibles errores durante
  *        la exportación.
  */
@@ -299,11 +353,19 @@ void UserInterface::exportDistribution() {
     return;
   }
   
+  std::cout << "1. CSV" << std::endl;
+  std::cout << "2. Binario (cargable con mmap)" << std::endl;
+  int formato = readInt("Formato de salida", 1, 2);
   std::string nombre_archivo =
       readString("Nombre del archivo de salida");
   
   try {
-    distribucion_->exportToCSV(nombre_archivo);
+    if (formato == 1) {
+      distribucion_->exportToCSV(nombre_archivo,
+                                 ParallelExecutor::hardwareThreads());
+    } else {
+      distribucion_->exportToBinary(nombre_archivo);
+    }
   } catch (const std::exception& excepcion) {
     std::cout << "Error al exportar: " << excepcion.what() << std::endl;
   }
@@ -368,6 +430,50 @@ int UserInterface::readInt(const std::string& mensaje, int valor_minimo,
   }
 }
 
+/**
+ * @brief Solicita al usuario una semilla opcional para generar una
+ *        distribución aleatoria.
+ * @return La semilla introducida, o std::nullopt si el usuario deja la
+ *         entrada vacía (distribución no reproducible).
+ */
+std::optional<uint64_t> UserInterface::readSeed() {
+  while (true) {
+    std::string entrada =
+        readString("Semilla [0-1000000] (vacío para una aleatoria)");
+    if (entrada.empty()) {
+      return std::nullopt;
+    }
+    uint64_t semilla;
+    auto [fin, error] = std::from_chars(
+        entrada.data(), entrada.data() + entrada.size(), semilla);
+    if (error != std::errc() || fin != entrada.data() + entrada.size()) {
+      std::cout << "Entrada inválida. Por favor, ingrese un número."
+                << std::endl;
+    } else if (semilla > 1000000) {
+      std::cout << "Valor fuera de rango." << std::endl;
+    } else {
+      return semilla;
+    }
+  }
+}
+
+/**
+ * @brief Solicita al usuario el tipo de almacenamiento de la tabla conjunta.
+ * @return El tipo de almacenamiento elegido.
+ */
+StorageType UserInterface::readStorageType() {
+  std::cout << "Almacenamiento: 1. double  2. float (error relativo 6e-8)  "
+               "3. bfloat16 (error relativo 4e-3)\n";
+  switch (readInt("Seleccione almacenamiento", 1, 3)) {
+    case 2:
+      return StorageType::kFloat;
+    case 3:
+      return StorageType::kBfloat16;
+    default:
+      return StorageType::kDouble;
+  }
+}
+
 /**
  * @brief Lee una cadena de texto del usuario, mostrando un mensaje de
  *        solicitud.
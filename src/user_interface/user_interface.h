@@ -17,6 +17,7 @@
 
 #include <memory>
 #include <iostream>
+#include <optional>
 
 #include "../distribution/binary_distribution/binary_distribution.h"
 #include "../conditional_query/conditional_query.h"
@@ -32,6 +33,11 @@ class UserInterface {
   void run();
     
  private:
+  //--------------------CONSTANTES--------------------
+  /// kCapacidadCache: Capacidad de la caché de resultados del motor
+  ///                  (2^20 probabilidades, 8 MB)
+  static constexpr uint64_t kCapacidadCache = 1ULL << 20;
+
   //--------------------ATRIBUTOS--------------------
   /// distribucion_: Distribución conjunta binaria cargada o generada
   std::unique_ptr<BinaryDistribution> distribucion_;
@@ -54,7 +60,7 @@ class UserInterface {
   void runPerformanceAnalysis();
   /// Método para mostrar la distribución actual por pantalla
   void displayCurrentDistribution();
-  /// Método para exportar la distribución actual a un archivo CSV
+  /// Método para exportar la distribución actual a un archivo CSV o binario
   void exportDistribution();
   /// Método para mostrar la ayuda y explicación del sistema
   void displayHelp() const;
@@ -63,6 +69,10 @@ class UserInterface {
   int readInt(const std::string&, int, int);
   /// Método auxiliar para leer una cadena de texto
   std::string readString(const std::string&);
+  /// Método auxiliar para leer una semilla opcional (vacía: aleatoria)
+  std::optional<uint64_t> readSeed();
+  /// Método auxiliar para leer el tipo de almacenamiento de la tabla
+  StorageType readStorageType();
   /// Método auxiliar para leer una confirmación (sí/no)
   bool readConfirmation(const std::string&);
   /// Método para verificar que una distribución esté cargada antes de realizar operaciones
@@ -0,0 +1,225 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   variable_elimination_engine.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase VariableEliminationEngine, que responde
+ *         consultas condicionales sobre modelos factorizados por
+ *         eliminación de variables.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <stdexcept>
+
+#include "variable_elimination_engine.h"
+
+/**
+ * @brief Constructor del motor de eliminación de variables
+ * @param[in] modelo: Modelo factorizado sobre el que realizar inferencias
+ * @param[in] heuristica: Heurística del orden de eliminación
+ */
+VariableEliminationEngine::VariableEliminationEngine(
+    const FactorGraph& modelo, EliminationHeuristic heuristica)
+    : modelo_(&modelo), heuristica_(heuristica), ultima_anchura_(0),
+      estados_evaluados_(0) {}
+
+/**
+ * @brief Método para calcular la distribución condicional P(X_I | X_C = c)
+ *        con la misma interfaz de máscaras que ConditionalInferenceEngine
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de las variables condicionadas
+ * @param[in] maskI: Máscara de variables de interés
+ * @return Array con la distribución condicional (debe liberarse con delete[])
+ * @throws std::invalid_argument si las máscaras se solapan o alguna variable
+ *         está fuera del modelo
+ */
+double* VariableEliminationEngine::prob_cond_bin(uint64_t maskC, uint64_t valC,
+                                                 uint64_t maskI) {
+  if ((maskC & maskI) != 0) {
+    throw std::invalid_argument(
+        "Error: Las variables condicionadas y de interés deben ser disjuntas");
+  }
+  std::vector<int> interes;
+  for (uint64_t resto = maskI; resto != 0; resto &= resto - 1) {
+    interes.push_back(std::countr_zero(resto));
+  }
+  std::vector<int> condicionadas;
+  std::vector<int> valores;
+  for (uint64_t resto = maskC; resto != 0; resto &= resto - 1) {
+    int variable = std::countr_zero(resto);
+    condicionadas.push_back(variable);
+    valores.push_back((valC >> variable) & 1);
+  }
+  double* resultado = new double[1ULL << interes.size()];
+  try {
+    computePosterior(interes, condicionadas, valores, resultado);
+  } catch (...) {
+    delete[] resultado;
+    throw;
+  }
+  return resultado;
+}
+
+/**
+ * @brief Método principal para calcular la distribución condicional
+ *        P(X_I | X_C = c)
+ * @param[in] consulta: Consulta condicional que especifica las variables de
+ *                      interés y condicionadas
+ * @return Estructura con la distribución condicional resultante y métricas de
+ *         ejecución (estados_evaluados: posiciones de los factores
+ *         intermedios)
+ * @throws std::invalid_argument si alguna variable está fuera del modelo
+ * @throws std::runtime_error si el orden de eliminación es demasiado ancho
+ */
+InferenceResult VariableEliminationEngine::computeConditional(
+    const ConditionalQuery& consulta) {
+  InferenceResult resultado;
+  auto inicio = std::chrono::high_resolution_clock::now();
+
+  int numero_bits_interes = consulta.getNumberInterestVariables();
+  std::vector<double> salida(1ULL << numero_bits_interes);
+  computeConditionalInto(consulta, salida);
+  auto distribucion =
+      std::make_unique<BinaryDistribution>(numero_bits_interes);
+  distribucion->assignProbabilities(salida);
+
+  auto fin = std::chrono::high_resolution_clock::now();
+  resultado.tiempo_ejecucion =
+      std::chrono::duration<double, std::micro>(fin - inicio).count();
+  resultado.estados_evaluados = estados_evaluados_;
+  resultado.distribucion = std::move(distribucion);
+  return resultado;
+}
+
+/**
+ * @brief Método para calcular P(X_I | X_C = c) en un búfer del llamador
+ * @param[in] consulta: Consulta condicional
+ * @param[out] salida: Búfer de al menos 2^|I| posiciones
+ * @return Vista de las 2^|I| probabilidades escritas en salida
+ * @throws std::invalid_argument si el búfer es demasiado pequeño o alguna
+ *         variable está fuera del modelo
+ */
+std::span<const double> VariableEliminationEngine::computeConditionalInto(
+    const ConditionalQuery& consulta, std::span<double> salida) {
+  uint64_t estados_interes = 1ULL << consulta.getNumberInterestVariables();
+  if (salida.size() < estados_interes) {
+    throw std::invalid_argument(
+        "Error: El búfer de salida debe tener 2^|I| posiciones");
+  }
+  computePosterior(consulta.getInterestVariables(),
+                   consulta.getConditionedVariables(),
+                   consulta.getConditionedValues(), salida.data());
+  return salida.first(estados_interes);
+}
+
+/**
+ * @brief Método para calcular la distribución condicional de las variables
+ *        de interés dada la evidencia
+ * @param[in] interes: Variables de interés
+ * @param[in] condicionadas: Variables observadas
+ * @param[in] valores: Valor (0 o 1) de cada variable observada
+ * @param[out] salida: Histograma de 2^|I| posiciones (todo ceros si la
+ *                     evidencia tiene probabilidad nula)
+ * @throws std::invalid_argument si alguna variable está fuera del modelo o
+ *         las listas de evidencia no tienen la misma longitud
+ * @throws std::runtime_error si el orden de eliminación es demasiado ancho
+ */
+void VariableEliminationEngine::computePosterior(
+    const std::vector<int>& interes, const std::vector<int>& condicionadas,
+    const std::vector<int>& valores, double* salida) {
+  if (condicionadas.size() != valores.size()) {
+    throw std::invalid_argument(
+        "Error: Cada variable condicionada necesita un valor");
+  }
+  for (int variable : interes) {
+    validateVariable(variable);
+  }
+  for (int variable : condicionadas) {
+    validateVariable(variable);
+  }
+
+  // Reducción de los factores con la evidencia
+  std::vector<Factor> factores;
+  factores.reserve(modelo_->getFactors().size());
+  for (const Factor& original : modelo_->getFactors()) {
+    Factor reducido = original;
+    for (size_t i = 0; i < condicionadas.size(); ++i) {
+      reducido = reducido.reduce(condicionadas[i], valores[i]);
+    }
+    factores.push_back(std::move(reducido));
+  }
+
+  // Los factores no conectados con las variables de interés solo aportan
+  // una constante: se descartan recorriendo el grafo desde el interés
+  std::vector<int> alcanzadas(interes);
+  std::vector<bool> usado(factores.size(), false);
+  for (size_t frontera = 0; frontera < alcanzadas.size(); ++frontera) {
+    for (size_t k = 0; k < factores.size(); ++k) {
+      if (usado[k] || !factores[k].contains(alcanzadas[frontera])) {
+        continue;
+      }
+      usado[k] = true;
+      for (int variable : factores[k].getVariables()) {
+        if (std::find(alcanzadas.begin(), alcanzadas.end(), variable) ==
+            alcanzadas.end()) {
+          alcanzadas.push_back(variable);
+        }
+      }
+    }
+  }
+  std::vector<Factor> conectados;
+  for (size_t k = 0; k < factores.size(); ++k) {
+    if (usado[k] || factores[k].getNumberVariables() == 0) {
+      conectados.push_back(std::move(factores[k]));
+    }
+  }
+
+  std::vector<int> a_eliminar(alcanzadas.begin() + interes.size(),
+                              alcanzadas.end());
+  ultimo_orden_ =
+      FactorGraph::eliminationOrder(conectados, a_eliminar, heuristica_);
+
+  // El factor de interés parte de la constante 1 sobre todas las variables
+  // de interés, de modo que las que no aparecen en ningún factor quedan
+  // uniformes
+  std::vector<int> ordenadas(interes);
+  std::sort(ordenadas.begin(), ordenadas.end());
+  conectados.emplace_back(ordenadas,
+                          std::vector<double>(1ULL << ordenadas.size(), 1.0));
+  EliminationResult eliminacion =
+      FactorGraph::eliminate(std::move(conectados), ultimo_orden_);
+  ultima_anchura_ = eliminacion.anchura;
+  estados_evaluados_ = eliminacion.estados_evaluados;
+
+  const std::vector<double>& valores_interes =
+      eliminacion.factor.getValues();
+  double suma = 0.0;
+  for (double valor : valores_interes) {
+    suma += valor;
+  }
+  for (size_t i = 0; i < valores_interes.size(); ++i) {
+    salida[i] = suma > 0.0 ? valores_interes[i] / suma : 0.0;
+  }
+}
+
+/**
+ * @brief Método para validar que una variable pertenezca al modelo
+ * @param[in] variable: Índice de la variable
+ * @throws std::invalid_argument si está fuera de [0, N-1]
+ */
+void VariableEliminationEngine::validateVariable(int variable) const {
+  if (variable < 0 || variable >= modelo_->getNumberVariables()) {
+    throw std::invalid_argument(
+        "Variable fuera de rango: " + std::to_string(variable) +
+        " (Debe ser 0-" + std::to_string(modelo_->getNumberVariables() - 1) +
+        ")");
+  }
+}
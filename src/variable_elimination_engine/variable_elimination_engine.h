@@ -0,0 +1,83 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   variable_elimination_engine.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase VariableEliminationEngine, que responde
+ *         consultas condicionales sobre modelos factorizados por
+ *         eliminación de variables.
+ */
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "../conditional_inference_engine/conditional_inference_engine.h"
+#include "../conditional_query/conditional_query.h"
+#include "../distribution/factor_graph/factor_graph.h"
+
+/**
+ * @brief Clase que responde consultas P(X_I | X_C = c) sobre un FactorGraph
+ *        sin construir la tabla conjunta: reduce los factores con la
+ *        evidencia, descarta los que no están conectados con las variables
+ *        de interés y elimina el resto de variables en el orden que da la
+ *        heurística. El coste es exponencial solo en la anchura inducida del
+ *        orden (ver getLastWidth).
+ *
+ *        El histograma resultado sigue el convenio del motor denso: el bit k
+ *        del índice es el valor de la k-ésima variable de interés en orden
+ *        creciente.
+ */
+class VariableEliminationEngine {
+ public:
+  //-------------------------CONSTRUCTOR-------------------------
+  explicit VariableEliminationEngine(
+      const FactorGraph&,
+      EliminationHeuristic = EliminationHeuristic::kMinFill);
+
+  //-------------------------MÉTODOS-------------------------
+  /// Método para calcular P(X_I | X_C = c) con máscaras (N <= 64)
+  double* prob_cond_bin(uint64_t, uint64_t, uint64_t);
+  /// Método principal para calcular la distribución condicional P(X_I | X_C = c)
+  InferenceResult computeConditional(const ConditionalQuery&);
+  /// Método para calcular P(X_I | X_C = c) en un búfer del llamador
+  std::span<const double> computeConditionalInto(const ConditionalQuery&,
+                                                 std::span<double>);
+  /// Método para calcular la distribución condicional con listas de
+  /// variables (admite variables con índice >= 64)
+  void computePosterior(const std::vector<int>&, const std::vector<int>&,
+                        const std::vector<int>&, double*);
+  EliminationHeuristic getHeuristic() const { return heuristica_; }
+  void setHeuristic(EliminationHeuristic heuristica) {
+    heuristica_ = heuristica;
+  }
+  /// Orden de eliminación y anchura inducida (variables del mayor factor
+  /// intermedio) de la última consulta
+  const std::vector<int>& getLastOrder() const { return ultimo_orden_; }
+  int getLastWidth() const { return ultima_anchura_; }
+  uint64_t getLastStates() const { return estados_evaluados_; }
+
+ private:
+  //-----------------ATRIBUTOS-----------------
+  /// modelo_: Modelo factorizado sobre el que se realizan las inferencias
+  const FactorGraph* modelo_;
+  /// heuristica_: Heurística del orden de eliminación
+  EliminationHeuristic heuristica_;
+  /// ultimo_orden_: Orden de eliminación de la última consulta
+  std::vector<int> ultimo_orden_;
+  /// ultima_anchura_: Anchura inducida de la última consulta
+  int ultima_anchura_;
+  /// estados_evaluados_: Posiciones de los factores intermedios de la última
+  ///                     consulta
+  uint64_t estados_evaluados_;
+
+  //-----------------MÉTODOS PRIVADOS-----------------
+  void validateVariable(int) const;
+};
@@ -0,0 +1,60 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   alias_sampler_test.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Prueba de AliasSampler: las frecuencias de las muestras de una
+ *         rebanada permutada se aproximan a la condicionada por fuerza bruta.
+ */
+
+#include <stdexcept>
+#include <vector>
+
+#include "alias_sampler/alias_sampler.h"
+#include "test_utils.h"
+
+int main() {
+  const int numero_variables = 6;
+  const uint64_t numero_muestras = 400000;
+  for (bool permutada : {false, true}) {
+    BinaryDistribution distribucion(numero_variables);
+    distribucion.generateRandom(11);
+    if (permutada) {
+      distribucion.permuteVariables({4, 1, 5, 0, 3, 2});
+    }
+    const uint64_t maskC = 0x12, valC = 0x10;
+    AliasSampler muestreador(distribucion, maskC, valC);
+    // Con todas las variables libres de interés, la condicionada es la
+    // probabilidad de cada estado lógico
+    auto esperado = bruteForceConditional(distribucion, maskC, valC,
+                                          distribucion.getStateSpaceSize() - 1);
+    std::vector<uint64_t> muestras(numero_muestras);
+    muestreador.sample(muestras, 7, 2);
+    std::vector<double> frecuencia(esperado.size(), 0.0);
+    for (uint64_t estado : muestras) {
+      CHECK((estado & maskC) == valC);
+      frecuencia[estado] += 1.0 / numero_muestras;
+    }
+    for (uint64_t estado = 0; estado < esperado.size(); ++estado) {
+      CHECK_NEAR(frecuencia[estado], esperado[estado], 0.005);
+    }
+  }
+
+  // La evidencia sobre una variable inexistente se rechaza
+  BinaryDistribution distribucion(numero_variables);
+  distribucion.generateRandom(11);
+  bool lanzada = false;
+  try {
+    AliasSampler muestreador(distribucion, 0x41, 0x40);
+  } catch (const std::invalid_argument&) {
+    lanzada = true;
+  }
+  CHECK(lanzada);
+  return finishTest("alias_sampler_test");
+}
@@ -0,0 +1,111 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   all_marginals_test.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Prueba de computeAllMarginals frente a computeConditional y a la
+ *         marginal por fuerza bruta, sobre tablas densas (con 1 y N hilos y
+ *         orden permutado) y dispersas.
+ */
+
+#include <vector>
+
+#include "conditional_inference_engine/conditional_inference_engine.h"
+#include "test_utils.h"
+
+/**
+ * @brief Función para comprobar las marginales y parejas de una evidencia
+ *        frente a las consultas sueltas del motor y a la fuerza bruta
+ * @param[in,out] motor: Motor de inferencia
+ * @param[in] distribucion: Distribución del motor (referencia)
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] tolerancia: Diferencia máxima admitida
+ * @return Marginales y parejas obtenidas
+ */
+static PosteriorMarginals checkEvidence(ConditionalInferenceEngine& motor,
+                                        const IDistribution& distribucion,
+                                        uint64_t maskC, uint64_t valC,
+                                        double tolerancia) {
+  int numero_variables = distribucion.getNumberVariables();
+  auto resultado = motor.computeAllMarginals(maskC, valC, true);
+  for (int i = 0; i < numero_variables; ++i) {
+    uint64_t bit_i = 1ULL << i;
+    if (maskC & bit_i) {
+      CHECK_NEAR(resultado.marginales[i], (valC & bit_i) ? 1.0 : 0.0,
+                 tolerancia);
+      continue;
+    }
+    auto esperado = bruteForceConditional(distribucion, maskC, valC, bit_i);
+    auto suelta = motor.computeConditional(
+        makeQuery(numero_variables, maskC, valC, bit_i));
+    CHECK_NEAR(resultado.marginales[i], esperado[1], tolerancia);
+    CHECK_NEAR(resultado.marginales[i], suelta.distribucion->getProbability(1),
+               tolerancia);
+    for (int j = i + 1; j < numero_variables; ++j) {
+      uint64_t bit_j = 1ULL << j;
+      if (maskC & bit_j) {
+        continue;
+      }
+      auto pareja =
+          bruteForceConditional(distribucion, maskC, valC, bit_i | bit_j);
+      CHECK_NEAR(resultado.parejas[i * numero_variables + j], pareja[3],
+                 tolerancia);
+      CHECK_NEAR(resultado.parejas[j * numero_variables + i], pareja[3],
+                 tolerancia);
+    }
+  }
+  return resultado;
+}
+
+int main() {
+  const int numero_variables = 11;
+  const uint64_t evidencias[][2] = {
+      {0x0, 0x0}, {0x1, 0x1}, {0x600, 0x400}, {0x0A4, 0x024}};
+
+  for (StorageType tipo : {StorageType::kDouble, StorageType::kFloat}) {
+    for (bool permutada : {false, true}) {
+      BinaryDistribution distribucion(numero_variables, tipo);
+      distribucion.generateRandom(13);
+      if (permutada) {
+        std::vector<int> orden(numero_variables);
+        for (int i = 0; i < numero_variables; ++i) {
+          orden[i] = (3 * i + 2) % numero_variables;
+        }
+        distribucion.permuteVariables(orden);
+      }
+      double tolerancia = tipo == StorageType::kDouble ? 1e-12 : 1e-6;
+      ConditionalInferenceEngine un_hilo(distribucion, 1);
+      ConditionalInferenceEngine varios_hilos(distribucion, 4);
+      for (const auto& [maskC, valC] : evidencias) {
+        auto referencia =
+            checkEvidence(un_hilo, distribucion, maskC, valC, tolerancia);
+        auto paralelo = varios_hilos.computeAllMarginals(maskC, valC, true);
+        // El resultado no depende del número de hilos
+        CHECK(paralelo.marginales == referencia.marginales);
+        CHECK(paralelo.parejas == referencia.parejas);
+      }
+    }
+  }
+
+  BinaryDistribution densa(numero_variables);
+  densa.generateRandom(17);
+  for (uint64_t estado = 0; estado < densa.getStateSpaceSize(); ++estado) {
+    if (estado % 5 != 0) {
+      densa.setProbability(estado, 0.0);
+    }
+  }
+  densa.normalize();
+  SparseDistribution dispersa(densa);
+  ConditionalInferenceEngine motor_disperso(dispersa);
+  for (const auto& [maskC, valC] : evidencias) {
+    checkEvidence(motor_disperso, dispersa, maskC, valC, 1e-12);
+  }
+  return finishTest("all_marginals_test");
+}
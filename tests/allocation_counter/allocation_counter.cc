@@ -0,0 +1,81 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   allocation_counter.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Implementación de la clase AllocationCounter y sustitución de los
+ *         operadores new y delete globales (solo en las pruebas).
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "allocation_counter.h"
+
+// numero_reservas: Reservas hechas con los operadores new globales
+static std::atomic<uint64_t> numero_reservas{0};
+
+/**
+ * @brief Método para obtener el número de reservas desde el inicio del
+ *        programa
+ * @return Número de llamadas a los operadores new globales
+ */
+uint64_t AllocationCounter::getAllocations() {
+  return numero_reservas.load(std::memory_order_relaxed);
+}
+
+// Las variantes de arrays y nothrow delegan por defecto en estas; las de
+// delete con tamaño se sustituyen también para no mezclar asignadores
+void* operator new(std::size_t bytes) {
+  numero_reservas.fetch_add(1, std::memory_order_relaxed);
+  // Como el operador estándar, se reintenta mientras haya un manejador que
+  // pueda liberar memoria
+  while (true) {
+    if (void* memoria = std::malloc(bytes == 0 ? 1 : bytes)) {
+      return memoria;
+    }
+    std::new_handler manejador = std::get_new_handler();
+    if (!manejador) {
+      throw std::bad_alloc();
+    }
+    manejador();
+  }
+}
+
+void* operator new(std::size_t bytes, std::align_val_t alineacion) {
+  numero_reservas.fetch_add(1, std::memory_order_relaxed);
+  std::size_t alineado = static_cast<std::size_t>(alineacion);
+  std::size_t redondeado = (bytes + alineado - 1) / alineado * alineado;
+  while (true) {
+    if (void* memoria = std::aligned_alloc(
+            alineado, redondeado == 0 ? alineado : redondeado)) {
+      return memoria;
+    }
+    std::new_handler manejador = std::get_new_handler();
+    if (!manejador) {
+      throw std::bad_alloc();
+    }
+    manejador();
+  }
+}
+
+void operator delete(void* memoria) noexcept { std::free(memoria); }
+
+void operator delete(void* memoria, std::align_val_t) noexcept {
+  std::free(memoria);
+}
+
+void operator delete(void* memoria, std::size_t) noexcept {
+  std::free(memoria);
+}
+
+void operator delete(void* memoria, std::size_t, std::align_val_t) noexcept {
+  std::free(memoria);
+}
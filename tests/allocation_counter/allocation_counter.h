@@ -0,0 +1,32 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   allocation_counter.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Declaración de la clase AllocationCounter, que cuenta las reservas
+ *         de memoria dinámica del programa.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Clase que expone el número de reservas de memoria dinámica hechas
+ *        por el programa. El contador lo incrementan los operadores new
+ *        globales, que se sustituyen en allocation_counter.cc. Solo se enlaza
+ *        en las pruebas, de modo que el programa conserva el asignador
+ *        estándar. Para medir un tramo de código basta con restar dos
+ *        lecturas (incluye las reservas de todos los hilos).
+ */
+class AllocationCounter {
+ public:
+  /// Método para obtener el número de reservas desde el inicio del programa
+  static uint64_t getAllocations();
+};
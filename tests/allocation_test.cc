@@ -0,0 +1,79 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   allocation_test.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Prueba de que las consultas sin caché no reservan memoria una vez
+ *         que el motor ha alcanzado su régimen estacionario.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "allocation_counter/allocation_counter.h"
+#include "conditional_inference_engine/conditional_inference_engine.h"
+#include "superset_sum_index/superset_sum_index.h"
+#include "test_utils.h"
+
+/**
+ * @brief Función para construir consultas variadas sobre n variables
+ * @param[in] numero_variables: Número de variables de la distribución
+ * @return Consultas con las máscaras calculadas
+ */
+static std::vector<ConditionalQuery> makeQueries(int numero_variables) {
+  std::vector<ConditionalQuery> consultas;
+  for (int k = 0; k < 50; ++k) {
+    ConditionalQuery consulta(numero_variables);
+    consulta.addInterestVariable(k % numero_variables);
+    consulta.addInterestVariable((k + 5) % numero_variables);
+    for (int c = 0; c < k % 4; ++c) {
+      consulta.addConditionedVariable((k + 7 + 3 * c) % numero_variables,
+                                      (k + c) % 2);
+    }
+    consulta.computeMasks();
+    consultas.push_back(std::move(consulta));
+  }
+  return consultas;
+}
+
+int main() {
+  const int numero_variables = 16;
+  BinaryDistribution distribucion(numero_variables);
+  distribucion.generateRandom(11);
+  auto consultas = makeQueries(numero_variables);
+  std::vector<double> salida(1 << numero_variables);
+
+  for (bool con_indice : {false, true}) {
+    for (int hilos : {1, 4}) {
+      ConditionalInferenceEngine motor(distribucion, hilos);
+      motor.setCacheCapacity(0);
+      if (con_indice) {
+        motor.setSupersetSumIndex(
+            std::make_shared<SupersetSumIndex>(distribucion, hilos));
+      }
+      // Primera ronda: las memorias del motor y los hilos alcanzan su tamaño
+      for (const auto& consulta : consultas) {
+        motor.computeConditionalView(consulta);
+        motor.computeConditionalInto(consulta, salida);
+      }
+      uint64_t antes = AllocationCounter::getAllocations();
+      for (const auto& consulta : consultas) {
+        motor.computeConditionalView(consulta);
+        motor.computeConditionalInto(consulta, salida);
+      }
+      CHECK(AllocationCounter::getAllocations() == antes);
+    }
+  }
+
+  // El contador registra de verdad las reservas
+  uint64_t antes = AllocationCounter::getAllocations();
+  auto reserva = std::make_unique<int>(1);
+  CHECK(AllocationCounter::getAllocations() == antes + 1);
+  return finishTest("allocation_test");
+}
@@ -0,0 +1,81 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   batch_test.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Prueba de computeConditionalBatch frente a las consultas sueltas y
+ *         a la marginal por fuerza bruta, con 1 y N hilos, tablas permutadas
+ *         y almacenamiento reducido.
+ */
+
+#include <vector>
+
+#include "conditional_inference_engine/conditional_inference_engine.h"
+#include "test_utils.h"
+
+int main() {
+  const int numero_variables = 13;
+  std::vector<ConditionalQuery> consultas;
+  for (uint64_t maskC : {0ULL, 0x3ULL, 0x1800ULL, 0x0F0ULL, 0x1001ULL}) {
+    uint64_t valC = maskC & 0x15A9ULL;
+    for (uint64_t maskI : {0x4ULL, 0x900ULL, 0x20CULL, 0x0402ULL}) {
+      if ((maskI & maskC) == 0) {
+        consultas.push_back(makeQuery(numero_variables, maskC, valC, maskI));
+      }
+    }
+  }
+
+  for (StorageType tipo :
+       {StorageType::kDouble, StorageType::kFloat, StorageType::kBfloat16}) {
+    for (bool permutada : {false, true}) {
+      BinaryDistribution distribucion(numero_variables, tipo);
+      distribucion.generateRandom(9);
+      if (permutada) {
+        std::vector<int> orden(numero_variables);
+        for (int i = 0; i < numero_variables; ++i) {
+          orden[i] = (4 * i + 7) % numero_variables;
+        }
+        distribucion.permuteVariables(orden);
+      }
+      // La tabla almacenada es la referencia, así que solo cambia el orden
+      // de las sumas
+      double tolerancia = tipo == StorageType::kDouble ? 1e-12 : 1e-6;
+
+      std::vector<std::vector<double>> referencia;
+      for (int hilos : {1, 4}) {
+        ConditionalInferenceEngine motor(distribucion, hilos);
+        motor.setCacheCapacity(0);
+        auto lote = motor.computeConditionalBatch(consultas);
+        CHECK(lote.size() == consultas.size());
+        for (size_t q = 0; q < consultas.size(); ++q) {
+          const auto& consulta = consultas[q];
+          auto esperado = bruteForceConditional(
+              distribucion, consulta.getMaskC(), consulta.getValC(),
+              consulta.getMaskI());
+          auto suelta = motor.computeConditional(consulta);
+          std::vector<double> obtenido;
+          for (uint64_t k = 0; k < esperado.size(); ++k) {
+            double valor = lote[q].distribucion->getProbability(k);
+            CHECK_NEAR(valor, esperado[k], tolerancia);
+            CHECK_NEAR(valor, suelta.distribucion->getProbability(k),
+                       tolerancia);
+            obtenido.push_back(valor);
+          }
+          // El resultado no depende del número de hilos
+          if (hilos == 1) {
+            referencia.push_back(obtenido);
+          } else {
+            CHECK(obtenido == referencia[q]);
+          }
+        }
+      }
+    }
+  }
+  return finishTest("batch_test");
+}
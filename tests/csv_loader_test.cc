@@ -0,0 +1,80 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   csv_loader_test.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Prueba de la carga paralela de CSV: mismo resultado con cualquier
+ *         número de hilos y, con filas repetidas, gana la última.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "distribution/binary_distribution/binary_distribution.h"
+#include "test_utils.h"
+
+/**
+ * @brief Función para escribir la máscara de un estado de n variables
+ */
+static std::string mask(uint64_t estado, int numero_variables) {
+  std::string binario(numero_variables, '0');
+  for (int bit = 0; bit < numero_variables; ++bit) {
+    if (estado & (1ULL << bit)) {
+      binario[numero_variables - 1 - bit] = '1';
+    }
+  }
+  return binario;
+}
+
+int main() {
+  // Varios MB, para que la carga se reparta en bloques entre hilos
+  const int numero_variables = 18;
+  const uint64_t estados = 1ULL << numero_variables;
+  const std::string ruta = "obj/tests/csv_loader_test.csv";
+  {
+    std::ofstream archivo(ruta);
+    archivo << mask(5, numero_variables) << ",0.25\n";
+    for (uint64_t estado = 0; estado < estados; ++estado) {
+      archivo << mask(estado, numero_variables) << ","
+              << (estado + 1) * 1e-6 << "\n";
+      if (estado == estados / 2) {
+        archivo << mask(7, numero_variables) << ",0.5\n";
+      }
+    }
+    // Última aparición de 5 en el último bloque
+    archivo << mask(5, numero_variables) << ",0.125\n";
+  }
+
+  for (int hilos : {1, 4}) {
+    BinaryDistribution distribucion(ruta, StorageType::kDouble, hilos);
+    CHECK(distribucion.getNumberVariables() == numero_variables);
+    CHECK_NEAR(distribucion.getProbability(5), 0.125, 0.0);
+    CHECK_NEAR(distribucion.getProbability(7), 0.5, 0.0);
+    CHECK_NEAR(distribucion.getProbability(12345), 12346e-6, 1e-18);
+    CHECK_NEAR(distribucion.getProbability(estados - 1), estados * 1e-6,
+               1e-18);
+  }
+
+  {
+    std::ofstream archivo(ruta);
+    archivo << mask(0, numero_variables) << ",0.5\n"
+            << mask(1, numero_variables) << ",abc\n";
+  }
+  bool lanzada = false;
+  try {
+    BinaryDistribution distribucion(ruta, StorageType::kDouble, 4);
+  } catch (const std::runtime_error&) {
+    lanzada = true;
+  }
+  CHECK(lanzada);
+  std::remove(ruta.c_str());
+  return finishTest("csv_loader_test");
+}
@@ -0,0 +1,100 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   drill_down_session_test.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Prueba de DrillDownSession: en cada paso, y al retroceder, las
+ *         consultas sobre la rebanada coinciden con la marginal por fuerza
+ *         bruta con la evidencia acumulada.
+ */
+
+#include <stdexcept>
+#include <vector>
+
+#include "drill_down_session/drill_down_session.h"
+#include "test_utils.h"
+
+/**
+ * @brief Función para comparar consultas de la sesión con la fuerza bruta
+ *        sobre la distribución original con la evidencia acumulada
+ * @param[in,out] sesion: Sesión de análisis
+ * @param[in] distribucion: Distribución original
+ */
+static void checkSession(DrillDownSession& sesion,
+                         const BinaryDistribution& distribucion) {
+  int numero_variables = distribucion.getNumberVariables();
+  uint64_t maskS = sesion.getEvidenceMask();
+  uint64_t valS = sesion.getEvidenceValues();
+  // Consultas con y sin evidencia adicional fuera de la sesión
+  const uint64_t consultas[][3] = {
+      {0x0, 0x0, 0x1}, {0x0, 0x0, 0x410}, {0x006, 0x002, 0x808}};
+  for (const auto& [maskC, valC, maskI] : consultas) {
+    uint64_t interes = maskI & ~maskS;
+    uint64_t extra = maskC & ~maskS & ~interes;
+    if (interes == 0) {
+      continue;
+    }
+    auto esperado = bruteForceConditional(distribucion, maskS | extra,
+                                          valS | (valC & extra), interes);
+    auto resultado = sesion.computeConditional(
+        makeQuery(numero_variables, extra, valC & extra, interes));
+    for (uint64_t k = 0; k < esperado.size(); ++k) {
+      CHECK_NEAR(resultado.distribucion->getProbability(k), esperado[k],
+                 1e-12);
+    }
+  }
+}
+
+int main() {
+  const int numero_variables = 12;
+  for (bool permutada : {false, true}) {
+    BinaryDistribution distribucion(numero_variables);
+    distribucion.generateRandom(41);
+    if (permutada) {
+      std::vector<int> orden(numero_variables);
+      for (int i = 0; i < numero_variables; ++i) {
+        orden[i] = (5 * i + 1) % numero_variables;
+      }
+      distribucion.permuteVariables(orden);
+    }
+    for (int hilos : {1, 4}) {
+      DrillDownSession sesion(distribucion, hilos);
+      checkSession(sesion, distribucion);
+      sesion.addEvidence(11, 1);
+      checkSession(sesion, distribucion);
+      sesion.addEvidence(2, 0);
+      checkSession(sesion, distribucion);
+      sesion.addEvidence(7, 1);
+      CHECK(sesion.getWorkingSetSize() == 1ULL << (numero_variables - 3));
+      checkSession(sesion, distribucion);
+      sesion.backtrack();
+      CHECK(sesion.getDepth() == 2);
+      checkSession(sesion, distribucion);
+      sesion.backtrackTo(1);
+      CHECK(sesion.getEvidenceMask() == 0x800);
+      checkSession(sesion, distribucion);
+
+      // Una consulta que contradice la evidencia de la sesión se rechaza
+      bool lanzada = false;
+      try {
+        sesion.computeConditional(makeQuery(numero_variables, 0x800, 0, 0x1));
+      } catch (const std::invalid_argument&) {
+        lanzada = true;
+      }
+      CHECK(lanzada);
+    }
+
+    // Las rebanadas se reconstruyen si la distribución original cambia
+    DrillDownSession sesion(distribucion);
+    sesion.addEvidence(3, 1);
+    distribucion.setProbability(0x808, 0.05);
+    checkSession(sesion, distribucion);
+  }
+  return finishTest("drill_down_session_test");
+}
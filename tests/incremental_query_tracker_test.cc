@@ -0,0 +1,91 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   incremental_query_tracker_test.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Prueba de IncrementalQueryTracker: tras cada modificación las
+ *         respuestas mantenidas coinciden con la marginal por fuerza bruta.
+ */
+
+#include <stdexcept>
+#include <vector>
+
+#include "incremental_query_tracker/incremental_query_tracker.h"
+#include "test_utils.h"
+
+/**
+ * @brief Función para comparar todas las suscripciones con la fuerza bruta
+ * @param[in,out] seguidor: Seguidor de consultas
+ * @param[in] distribucion: Distribución modificada
+ * @param[in] consultas: Máscaras (maskC, valC, maskI) de cada suscripción
+ * @param[in] identificadores: Identificador de cada suscripción
+ */
+static void checkSubscriptions(
+    IncrementalQueryTracker& seguidor, const BinaryDistribution& distribucion,
+    const std::vector<std::vector<uint64_t>>& consultas,
+    const std::vector<int>& identificadores) {
+  for (size_t q = 0; q < consultas.size(); ++q) {
+    auto esperado = bruteForceConditional(distribucion, consultas[q][0],
+                                          consultas[q][1], consultas[q][2]);
+    auto resultado = seguidor.getResult(identificadores[q]);
+    CHECK(resultado.size() == esperado.size());
+    for (uint64_t k = 0; k < esperado.size(); ++k) {
+      CHECK_NEAR(resultado[k], esperado[k], 1e-12);
+    }
+  }
+}
+
+int main() {
+  const int numero_variables = 10;
+  const std::vector<std::vector<uint64_t>> consultas = {
+      {0x0, 0x0, 0x1}, {0x6, 0x4, 0x300}, {0x201, 0x200, 0x0F0}};
+
+  for (bool permutada : {false, true}) {
+    BinaryDistribution distribucion(numero_variables);
+    distribucion.generateRandom(31);
+    if (permutada) {
+      distribucion.permuteVariables({3, 8, 0, 5, 1, 9, 2, 7, 4, 6});
+    }
+    IncrementalQueryTracker seguidor(distribucion);
+    std::vector<int> identificadores;
+    for (const auto& consulta : consultas) {
+      identificadores.push_back(seguidor.subscribe(makeQuery(
+          numero_variables, consulta[0], consulta[1], consulta[2])));
+    }
+    checkSubscriptions(seguidor, distribucion, consultas, identificadores);
+
+    // Cambios a través del seguidor
+    seguidor.setProbability(0x204, 0.0);
+    seguidor.setProbability(0x3F5, 0.01);
+    std::vector<ProbabilityDelta> cambios;
+    for (uint64_t estado = 0; estado < 64; ++estado) {
+      cambios.push_back({estado * 13 % 1024, 1e-4 * estado});
+    }
+    seguidor.applyDeltas(cambios);
+    checkSubscriptions(seguidor, distribucion, consultas, identificadores);
+
+    // Cambio directo sobre la distribución: se recalcula al acceder
+    distribucion.setProbability(0x005, 0.02);
+    checkSubscriptions(seguidor, distribucion, consultas, identificadores);
+    CHECK(seguidor.getVersion() == distribucion.getVersion());
+  }
+
+  // Una consulta sobre otro número de variables se rechaza
+  BinaryDistribution distribucion(numero_variables);
+  distribucion.generateRandom(31);
+  IncrementalQueryTracker seguidor(distribucion);
+  bool lanzada = false;
+  try {
+    seguidor.subscribe(makeQuery(numero_variables + 1, 0x400, 0x400, 0x1));
+  } catch (const std::invalid_argument&) {
+    lanzada = true;
+  }
+  CHECK(lanzada);
+  return finishTest("incremental_query_tracker_test");
+}
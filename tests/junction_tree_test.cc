@@ -0,0 +1,66 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   junction_tree_test.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Prueba del árbol de unión a través del motor sobre un modelo
+ *         factorizado: consultas y marginales a posteriori frente a la
+ *         marginal por fuerza bruta, reutilizando la calibración.
+ */
+
+#include "conditional_inference_engine/conditional_inference_engine.h"
+#include "test_utils.h"
+
+int main() {
+  const int numero_variables = 10;
+  // Rejilla 2 x 5 de parejas: el árbol de unión tiene cliques de 3
+  FactorGraph modelo(numero_variables);
+  for (int i = 0; i < numero_variables; ++i) {
+    for (int j : {i + 1, i + 5}) {
+      if (j < numero_variables && (j != i + 1 || i != 4)) {
+        modelo.addFactor(Factor({i, j}, {1.0 + 0.1 * i, 0.4 + 0.05 * j,
+                                         0.8, 1.5 - 0.1 * i}));
+      }
+    }
+  }
+
+  ConditionalInferenceEngine motor(modelo, 2);
+  const uint64_t evidencias[][2] = {{0x0, 0x0}, {0x21, 0x01}, {0x300, 0x200}};
+  for (const auto& [maskC, valC] : evidencias) {
+    // Varias consultas con la misma evidencia comparten la calibración
+    for (uint64_t maskI : {0x2ULL, 0x4ULL, 0x0CULL, 0x42ULL, 0x90ULL}) {
+      if (maskI & maskC) {
+        continue;
+      }
+      auto esperado = bruteForceConditional(modelo, maskC, valC, maskI);
+      auto resultado = motor.computeConditional(
+          makeQuery(numero_variables, maskC, valC, maskI));
+      for (uint64_t k = 0; k < esperado.size(); ++k) {
+        CHECK_NEAR(resultado.distribucion->getProbability(k), esperado[k],
+                   1e-12);
+      }
+    }
+    auto marginales = motor.computeAllMarginals(maskC, valC);
+    for (int i = 0; i < numero_variables; ++i) {
+      uint64_t bit = 1ULL << i;
+      double esperado =
+          (maskC & bit) ? ((valC & bit) ? 1.0 : 0.0)
+                        : bruteForceConditional(modelo, maskC, valC, bit)[1];
+      CHECK_NEAR(marginales.marginales[i], esperado, 1e-12);
+    }
+  }
+
+  // El árbol se reconstruye si el modelo cambia
+  modelo.addFactor(Factor({3, 8}, {2.0, 0.1, 0.1, 2.0}));
+  auto esperado = bruteForceConditional(modelo, 0x1, 0x1, 0x100);
+  auto resultado =
+      motor.computeConditional(makeQuery(numero_variables, 0x1, 0x1, 0x100));
+  CHECK_NEAR(resultado.distribucion->getProbability(1), esperado[1], 1e-12);
+  return finishTest("junction_tree_test");
+}
@@ -0,0 +1,89 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   sparse_test.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Prueba de SparseDistribution: consultas del motor frente a la
+ *         marginal por fuerza bruta y carga de un CSV desordenado.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "conditional_inference_engine/conditional_inference_engine.h"
+#include "test_utils.h"
+
+int main() {
+  const int numero_variables = 12;
+  BinaryDistribution densa(numero_variables);
+  densa.generateRandom(5);
+  // Soporte de una cuarta parte de los estados
+  for (uint64_t estado = 0; estado < densa.getStateSpaceSize(); ++estado) {
+    if (estado % 7 > 1) {
+      densa.setProbability(estado, 0.0);
+    }
+  }
+  densa.normalize();
+  SparseDistribution dispersa(densa);
+  CHECK(dispersa.getNumberNonZero() * 3 < densa.getStateSpaceSize());
+
+  ConditionalInferenceEngine motor(dispersa);
+  // Evidencias que fijan los bits altos (tramo acotado) y que no los fijan
+  for (uint64_t maskC : {0ULL, 0xC00ULL, 0x800ULL, 0x00AULL, 0x421ULL}) {
+    uint64_t valC = maskC & 0x8A5ULL;
+    for (uint64_t maskI : {0x10ULL, 0x244ULL, 0x1C0ULL}) {
+      if (maskI & maskC) {
+        continue;
+      }
+      auto esperado = bruteForceConditional(densa, maskC, valC, maskI);
+      auto resultado = motor.computeConditional(
+          makeQuery(numero_variables, maskC, valC, maskI));
+      for (uint64_t k = 0; k < esperado.size(); ++k) {
+        CHECK_NEAR(resultado.distribucion->getProbability(k), esperado[k],
+                   1e-12);
+      }
+    }
+  }
+
+  // CSV desordenado: un estado repetido toma su última fila, aunque sea 0
+  const std::string ruta = "obj/tests/sparse_test.csv";
+  {
+    std::ofstream archivo(ruta);
+    archivo << "0110,0.25\n"
+            << "0001,0.5\r\n"
+            << "\n"
+            << "1111,0.125\n"
+            << "0001,0.375\n"
+            << "1000,0.125\n"
+            << "1000,0\n"
+            << "0000,0\n";
+  }
+  SparseDistribution cargada(ruta);
+  CHECK(cargada.getNumberVariables() == 4);
+  CHECK(cargada.getNumberNonZero() == 3);
+  CHECK_NEAR(cargada.getProbability(0x1), 0.375, 0.0);
+  CHECK_NEAR(cargada.getProbability(0x6), 0.25, 0.0);
+  CHECK_NEAR(cargada.getProbability(0xF), 0.125, 0.0);
+  CHECK_NEAR(cargada.getProbability(0x8), 0.0, 0.0);
+
+  {
+    std::ofstream archivo(ruta);
+    archivo << "0110,0.25\n" << "011,0.5\n";
+  }
+  bool lanzada = false;
+  try {
+    SparseDistribution invalida(ruta);
+  } catch (const std::runtime_error&) {
+    lanzada = true;
+  }
+  CHECK(lanzada);
+  std::remove(ruta.c_str());
+  return finishTest("sparse_test");
+}
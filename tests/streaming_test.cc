@@ -0,0 +1,70 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   streaming_test.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Prueba de StreamingInferenceEngine frente a la marginal por fuerza
+ *         bruta, con tablas permutadas y en float.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "streaming_inference_engine/streaming_inference_engine.h"
+#include "test_utils.h"
+
+int main() {
+  const int numero_variables = 14;
+  const std::string ruta = "obj/tests/streaming_test.bin";
+  for (StorageType tipo : {StorageType::kDouble, StorageType::kFloat}) {
+    for (bool permutada : {false, true}) {
+      BinaryDistribution distribucion(numero_variables, tipo);
+      distribucion.generateRandom(3);
+      if (permutada) {
+        std::vector<int> orden(numero_variables);
+        for (int i = 0; i < numero_variables; ++i) {
+          orden[i] = (5 * i + 3) % numero_variables;
+        }
+        distribucion.permuteVariables(orden);
+      }
+      distribucion.exportToBinary(ruta);
+      // Bloques pequeños, para que la evidencia descarte bloques enteros
+      StreamingInferenceEngine motor(ruta, 1024);
+      double tolerancia = tipo == StorageType::kDouble ? 1e-12 : 1e-6;
+
+      for (uint64_t maskC : {0ULL, 0x3ULL, 0x2400ULL, 0x1F0ULL}) {
+        uint64_t valC = maskC & 0x2A5AULL;
+        for (uint64_t maskI : {0x1ULL, 0x801ULL, 0x0C1ULL, 0x2012ULL}) {
+          if (maskI & maskC) {
+            continue;
+          }
+          ConditionalQuery consulta(numero_variables);
+          for (int i = 0; i < numero_variables; ++i) {
+            if (maskI & (1ULL << i)) {
+              consulta.addInterestVariable(i);
+            } else if (maskC & (1ULL << i)) {
+              consulta.addConditionedVariable(i, (valC >> i) & 1);
+            }
+          }
+          consulta.computeMasks();
+          auto esperado =
+              bruteForceConditional(distribucion, maskC, valC, maskI);
+          auto resultado = motor.computeConditional(consulta);
+          for (uint64_t k = 0; k < esperado.size(); ++k) {
+            CHECK_NEAR(resultado.distribucion->getProbability(k), esperado[k],
+                       tolerancia);
+          }
+        }
+      }
+    }
+  }
+  std::remove(ruta.c_str());
+  return finishTest("streaming_test");
+}
@@ -0,0 +1,76 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   superset_sum_index_test.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Prueba de SupersetSumIndex a través del motor frente a la marginal
+ *         por fuerza bruta, con tablas permutadas y con un índice obsoleto.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "conditional_inference_engine/conditional_inference_engine.h"
+#include "superset_sum_index/superset_sum_index.h"
+#include "test_utils.h"
+
+int main() {
+  const int numero_variables = 14;
+  // Consultas pequeñas, que el motor resuelve con el índice
+  const uint64_t consultas[][3] = {{0x0, 0x0, 0x1},
+                                   {0x0, 0x0, 0x2001},
+                                   {0x3, 0x1, 0x100},
+                                   {0x2400, 0x2400, 0x18},
+                                   {0x0F0, 0x050, 0x1000}};
+
+  for (bool permutada : {false, true}) {
+    BinaryDistribution distribucion(numero_variables);
+    distribucion.generateRandom(21);
+    if (permutada) {
+      std::vector<int> orden(numero_variables);
+      for (int i = 0; i < numero_variables; ++i) {
+        orden[i] = (9 * i + 4) % numero_variables;
+      }
+      distribucion.permuteVariables(orden);
+    }
+    for (int hilos : {1, 4}) {
+      ConditionalInferenceEngine motor(distribucion, hilos);
+      motor.setCacheCapacity(0);
+      motor.setSupersetSumIndex(
+          std::make_shared<SupersetSumIndex>(distribucion, hilos));
+      for (const auto& [maskC, valC, maskI] : consultas) {
+        auto esperado = bruteForceConditional(distribucion, maskC, valC, maskI);
+        auto resultado = motor.computeConditional(
+            makeQuery(numero_variables, maskC, valC, maskI));
+        // Se leen 2^k sumas del índice, no el subcubo de la evidencia
+        CHECK(resultado.estados_evaluados <
+              (1ULL << (numero_variables - std::popcount(maskC))));
+        for (uint64_t k = 0; k < esperado.size(); ++k) {
+          CHECK_NEAR(resultado.distribucion->getProbability(k), esperado[k],
+                     1e-12);
+        }
+      }
+    }
+  }
+
+  // Un índice de una versión anterior de la distribución no se usa
+  BinaryDistribution distribucion(numero_variables);
+  distribucion.generateRandom(23);
+  ConditionalInferenceEngine motor(distribucion);
+  motor.setCacheCapacity(0);
+  motor.setSupersetSumIndex(std::make_shared<SupersetSumIndex>(distribucion));
+  distribucion.setProbability(1, distribucion.getProbability(1) + 0.25);
+  distribucion.normalize();
+  auto esperado = bruteForceConditional(distribucion, 0, 0, 0x1);
+  auto resultado =
+      motor.computeConditional(makeQuery(numero_variables, 0, 0, 0x1));
+  CHECK(resultado.estados_evaluados == distribucion.getStateSpaceSize());
+  CHECK_NEAR(resultado.distribucion->getProbability(1), esperado[1], 1e-12);
+  return finishTest("superset_sum_index_test");
+}
@@ -0,0 +1,127 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   test_utils.h
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Comprobaciones y marginal por fuerza bruta compartidas por las
+ *         pruebas.
+ */
+
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "conditional_query/conditional_query.h"
+#include "distribution/i_distribution.h"
+
+/// numero_fallos: Comprobaciones fallidas en el programa de prueba
+inline int numero_fallos = 0;
+
+/// Comprueba una condición e informa de la línea si no se cumple
+#define CHECK(condicion)                                               \
+  do {                                                                 \
+    if (!(condicion)) {                                                \
+      std::fprintf(stderr, "%s:%d: fallo: %s\n", __FILE__, __LINE__,   \
+                   #condicion);                                        \
+      ++numero_fallos;                                                 \
+    }                                                                  \
+  } while (0)
+
+/// Comprueba que dos valores difieren como mucho en tolerancia
+#define CHECK_NEAR(obtenido, esperado, tolerancia)                          \
+  do {                                                                      \
+    double obtenido_ = (obtenido);                                          \
+    double esperado_ = (esperado);                                          \
+    if (!(std::abs(obtenido_ - esperado_) <= (tolerancia))) {               \
+      std::fprintf(stderr, "%s:%d: fallo: %s = %.17g, se esperaba %.17g\n", \
+                   __FILE__, __LINE__, #obtenido, obtenido_, esperado_);    \
+      ++numero_fallos;                                                      \
+    }                                                                       \
+  } while (0)
+
+/**
+ * @brief Función para calcular P(X_I | X_C = c) recorriendo todos los estados
+ *        lógicos de la distribución, sin ninguna de las optimizaciones del
+ *        motor. Sirve de referencia para las pruebas.
+ * @param[in] distribucion: Distribución conjunta
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] maskI: Máscara de variables de interés
+ * @return 2^|I| probabilidades indexadas por los bits de interés compactados
+ *         en orden creciente de variable (sin normalizar si la evidencia no
+ *         tiene masa)
+ */
+inline std::vector<double> bruteForceConditional(
+    const IDistribution& distribucion, uint64_t maskC, uint64_t valC,
+    uint64_t maskI) {
+  std::vector<double> resultado(1ULL << std::popcount(maskI), 0.0);
+  double total = 0.0;
+  for (uint64_t estado = 0; estado < distribucion.getStateSpaceSize();
+       ++estado) {
+    if ((estado & maskC) != valC) {
+      continue;
+    }
+    uint64_t indice = 0;
+    int bit = 0;
+    for (uint64_t resto = maskI; resto != 0; resto &= resto - 1, ++bit) {
+      if (estado & resto & -resto) {
+        indice |= 1ULL << bit;
+      }
+    }
+    double probabilidad = distribucion.getProbability(estado);
+    resultado[indice] += probabilidad;
+    total += probabilidad;
+  }
+  if (total > 1e-10) {
+    for (double& valor : resultado) {
+      valor /= total;
+    }
+  }
+  return resultado;
+}
+
+/**
+ * @brief Función para construir una consulta a partir de sus máscaras
+ * @param[in] numero_variables: Número de variables de la distribución
+ * @param[in] maskC: Máscara de variables condicionadas
+ * @param[in] valC: Valores de variables condicionadas
+ * @param[in] maskI: Máscara de variables de interés
+ * @return Consulta con las máscaras calculadas
+ */
+inline ConditionalQuery makeQuery(int numero_variables, uint64_t maskC,
+                                  uint64_t valC, uint64_t maskI) {
+  ConditionalQuery consulta(numero_variables);
+  for (int i = 0; i < numero_variables; ++i) {
+    if (maskI & (1ULL << i)) {
+      consulta.addInterestVariable(i);
+    } else if (maskC & (1ULL << i)) {
+      consulta.addConditionedVariable(i, (valC >> i) & 1);
+    }
+  }
+  consulta.computeMasks();
+  return consulta;
+}
+
+/**
+ * @brief Función para terminar un programa de prueba informando del resultado
+ * @param[in] nombre: Nombre de la prueba
+ * @return Código de salida (0 si no ha fallado ninguna comprobación)
+ */
+inline int finishTest(const char* nombre) {
+  if (numero_fallos == 0) {
+    std::printf("%s: OK\n", nombre);
+    return 0;
+  }
+  std::printf("%s: %d comprobaciones fallidas\n", nombre, numero_fallos);
+  return 1;
+}
@@ -0,0 +1,53 @@
+/**
+ * Universidad de La Laguna
+ * Escuela Superior de Ingeniería y Tecnología
+ * Grado en Ingeniería Informática
+ * Inteligencia Artificial Avanzada
+ * Practica 1: Probabilidad Condicionada
+
+ * @file   variable_elimination_test.cc
+ * @author Raúl Gonzalez Acosta (alu0101543529@ull.edu.es)
+ * @author Enrique Gómez Díaz (alu0101550329@ull.edu.es)
+ * @date   05/02/2026
+ * @brief  Prueba de VariableEliminationEngine frente a la marginal por
+ *         fuerza bruta sobre el producto de los factores, con las dos
+ *         heurísticas de eliminación.
+ */
+
+#include <algorithm>
+
+#include "variable_elimination_engine/variable_elimination_engine.h"
+#include "test_utils.h"
+
+int main() {
+  const int numero_variables = 10;
+  // Cadena de parejas cerrada en ciclo, más un factor de tres variables
+  FactorGraph modelo(numero_variables);
+  for (int i = 0; i < numero_variables; ++i) {
+    int j = (i + 1) % numero_variables;
+    modelo.addFactor(Factor({std::min(i, j), std::max(i, j)},
+                            {1.0 + i, 0.5, 0.25 + 0.1 * i, 2.0}));
+  }
+  modelo.addFactor(Factor({1, 4, 8},
+                          {0.3, 1.2, 0.7, 0.1, 2.5, 0.9, 1.1, 0.6}));
+
+  const uint64_t consultas[][3] = {{0x0, 0x0, 0x1},
+                                   {0x0, 0x0, 0x210},
+                                   {0x6, 0x4, 0x100},
+                                   {0x221, 0x020, 0x0C},
+                                   {0x3F0, 0x150, 0x1}};
+  for (EliminationHeuristic heuristica :
+       {EliminationHeuristic::kMinDegree, EliminationHeuristic::kMinFill}) {
+    VariableEliminationEngine motor(modelo, heuristica);
+    for (const auto& [maskC, valC, maskI] : consultas) {
+      auto esperado = bruteForceConditional(modelo, maskC, valC, maskI);
+      auto resultado = motor.computeConditional(
+          makeQuery(numero_variables, maskC, valC, maskI));
+      for (uint64_t k = 0; k < esperado.size(); ++k) {
+        CHECK_NEAR(resultado.distribucion->getProbability(k), esperado[k],
+                   1e-12);
+      }
+    }
+  }
+  return finishTest("variable_elimination_test");
+}